@@ -10,6 +10,11 @@ if(MSVC)
   add_definitions(-DNOMINMAX=1 -DWIN32_LEAN_AND_MEAN=1)
 endif()
 
+option(AVENDISH_RT_CHECK "Check that the process functions do not allocate nor lock" OFF)
+option(AVENDISH_DSP_LOAD "Measure the time spent in the process functions" OFF)
+option(AVENDISH_REALTIME_LOGGER "Log from the processors through a lock-free queue" OFF)
+option(AVENDISH_TRACE "Record a trace of the calls to the processors, for chrome://tracing" OFF)
+
 find_package(Boost QUIET REQUIRED)
 find_package(Threads QUIET)
 find_package(fmt QUIET)
@@ -28,6 +33,7 @@ include(avendish.clap)
 include(avendish.ossia)
 include(avendish.standalone)
 include(avendish.example)
+include(avendish.offline)
 
 # Used for getting completion in IDEs...
 function(avnd_register)
@@ -51,11 +57,18 @@ endfunction()
 function(avnd_make_audioplug)
   avnd_register(${ARGV})
 
+  # Listed for the realtime-safety tests, see avendish.tests.cmake
+  cmake_parse_arguments(AVND "" "TARGET;MAIN_FILE;MAIN_CLASS;C_NAME" "" ${ARGN})
+  set_property(GLOBAL APPEND PROPERTY AVND_AUDIO_PLUGINS
+    "${AVND_TARGET}|${AVND_MAIN_FILE}|${AVND_MAIN_CLASS}"
+  )
+
   avnd_make_ossia(${ARGV})
   avnd_make_vintage(${ARGV})
   avnd_make_clap(${ARGV})
   avnd_make_vst3(${ARGV})
   avnd_make_example_host(${ARGV})
+  avnd_make_offline(${ARGV})
 endfunction()
 
 function(avnd_make_all)
@@ -21,6 +21,11 @@ function(avnd_make_example_host)
   add_executable(${AVND_FX_TARGET})
   add_test(NAME ${AVND_FX_TARGET} COMMAND ${AVND_FX_TARGET})
 
+  # Listed for the benchmark of all the examples, see avendish.tests.cmake
+  set_property(GLOBAL APPEND PROPERTY AVND_EXAMPLE_HOSTS
+    "${AVND_TARGET}|${AVND_MAIN_FILE}|${AVND_MAIN_CLASS}"
+  )
+
   set_target_properties(${AVND_FX_TARGET}
     PROPERTIES
       RUNTIME_OUTPUT_DIRECTORY example
@@ -176,6 +176,20 @@ avnd_make_all(
   C_NAME avnd_helpers_lowpass
   )
 
+avnd_make_all(
+  TARGET HelpersFixedBlockRms
+  MAIN_FILE examples/Helpers/FixedBlockRms.hpp
+  MAIN_CLASS examples::helpers::FixedBlockRms
+  C_NAME avnd_fixed_block_rms
+)
+
+avnd_make_all(
+  TARGET HelpersLanePackedLowpass
+  MAIN_FILE examples/Helpers/LanePackedLowpass.hpp
+  MAIN_CLASS examples::helpers::LanePackedLowpass
+  C_NAME avnd_lane_packed_lowpass
+  )
+
 avnd_make_all(
   TARGET HelpersMidi
   MAIN_FILE examples/Helpers/Midi.hpp
@@ -183,6 +197,20 @@ avnd_make_all(
   C_NAME avnd_helpers_midi
 )
 
+avnd_make_all(
+  TARGET HelpersChain
+  MAIN_FILE examples/Helpers/Chain.hpp
+  MAIN_CLASS examples::helpers::Chain
+  C_NAME avnd_helpers_chain
+)
+
+avnd_make_all(
+  TARGET HelpersOversampledDistortion
+  MAIN_FILE examples/Helpers/OversampledDistortion.hpp
+  MAIN_CLASS examples::helpers::OversampledDistortion
+  C_NAME avnd_oversampled_distortion
+)
+
 avnd_make_all(
   TARGET SampleAccurateControls
   MAIN_FILE examples/Raw/SampleAccurateControls.hpp
@@ -190,6 +218,20 @@ avnd_make_all(
   C_NAME avnd_sample_accurate_controls
 )
 
+avnd_make_all(
+  TARGET HelpersSubBlockGain
+  MAIN_FILE examples/Helpers/SubBlockGain.hpp
+  MAIN_CLASS examples::helpers::SubBlockGain
+  C_NAME avnd_sub_block_gain
+)
+
+avnd_make_all(
+  TARGET HelpersSmoothGain
+  MAIN_FILE examples/Helpers/SmoothGain.hpp
+  MAIN_CLASS examples::helpers::SmoothGain
+  C_NAME avnd_smooth_gain
+)
+
 avnd_make_all(
   TARGET WhiteNoise
   MAIN_FILE examples/Helpers/Noise.hpp
@@ -0,0 +1,54 @@
+include(CTest)
+
+function(avnd_make_offline)
+  cmake_parse_arguments(AVND "" "TARGET;MAIN_FILE;MAIN_CLASS" "" ${ARGN})
+
+  set(AVND_FX_TARGET "${AVND_TARGET}_offline")
+  if(TARGET "${AVND_FX_TARGET}")
+    return()
+  endif()
+
+  string(MAKE_C_IDENTIFIER "${AVND_MAIN_CLASS}" MAIN_OUT_FILE)
+
+  configure_file(
+    "${AVND_SOURCE_DIR}/include/avnd/binding/offline/prototype.cpp.in"
+    "${CMAKE_BINARY_DIR}/${MAIN_OUT_FILE}_offline.cpp"
+    @ONLY
+    NEWLINE_STYLE LF
+  )
+
+  add_executable(${AVND_FX_TARGET})
+
+  # Renders a short silence through the processor
+  add_test(
+    NAME ${AVND_FX_TARGET}
+    COMMAND ${AVND_FX_TARGET} --length 0.1 --output "${CMAKE_BINARY_DIR}/offline/renders"
+  )
+
+  set_target_properties(${AVND_FX_TARGET}
+    PROPERTIES
+      RUNTIME_OUTPUT_DIRECTORY offline
+  )
+  target_sources(
+    ${AVND_FX_TARGET}
+    PRIVATE
+      "${CMAKE_BINARY_DIR}/${MAIN_OUT_FILE}_offline.cpp"
+  )
+
+  target_link_libraries(
+    ${AVND_FX_TARGET}
+    PUBLIC
+      Avendish::Avendish
+  )
+  if(TARGET Threads::Threads)
+    target_link_libraries(${AVND_FX_TARGET} PUBLIC Threads::Threads)
+  endif()
+
+  avnd_common_setup("${AVND_TARGET}" "${AVND_FX_TARGET}")
+
+  target_sources(Avendish PRIVATE
+    "${AVND_SOURCE_DIR}/include/avnd/binding/offline/audio_file.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/binding/offline/automation.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/binding/offline/renderer.hpp"
+  )
+endfunction()
@@ -36,32 +36,63 @@ target_sources(Avendish
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/audio_channel_manager.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/avnd.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/bus_host_process_adapter.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/chain.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/configure.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/control_display.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/controls.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/controls_double.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/controls_fp.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/controls_storage.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/dsp_load.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/effect_container.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/fixed_block_process_adapter.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/latency.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/mapping.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/metadatas.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/oversampling_process_adapter.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/parallel_channels.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/prepare.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/process_adapter.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/process_execution.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/silence_process_adapter.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/smoothing.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/sub_block_process_adapter.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/symbol_table.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/timed_values.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/wrappers/widgets.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/wrappers/zero_buffers.hpp"
 
     "${AVND_SOURCE_DIR}/include/avnd/common/aggregates.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/aligned_allocator.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/atomic_bitset.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/concepts_polyfill.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/constexpr_math.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/convert_samples.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/coroutines.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/cycle_counter.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/denormals.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/dsp_load.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/dummy.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/errors.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/export.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/flat_aggregate.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/for_nth.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/function_reflection.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/halfband.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/index_sequence.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/limited_string.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/limited_string_view.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/log_queue.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/member_range.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/perfect_hash.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/realtime_check.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/silence.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/simd_lanes.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/smoother.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/span_polyfill.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/struct_reflection.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/thread_pool.hpp"
+    "${AVND_SOURCE_DIR}/include/avnd/common/trace.hpp"
     "${AVND_SOURCE_DIR}/include/avnd/common/widechar.hpp"
 
     "${AVND_SOURCE_DIR}/include/halp/audio.hpp"
@@ -69,11 +100,14 @@ target_sources(Avendish
     "${AVND_SOURCE_DIR}/include/halp/controls.hpp"
     "${AVND_SOURCE_DIR}/include/halp/layout.hpp"
     "${AVND_SOURCE_DIR}/include/halp/log.hpp"
+    "${AVND_SOURCE_DIR}/include/halp/mappings.hpp"
     "${AVND_SOURCE_DIR}/include/halp/messages.hpp"
     "${AVND_SOURCE_DIR}/include/halp/meta.hpp"
     "${AVND_SOURCE_DIR}/include/halp/midi.hpp"
     "${AVND_SOURCE_DIR}/include/halp/reactive_value.hpp"
+    "${AVND_SOURCE_DIR}/include/halp/realtime_log.hpp"
     "${AVND_SOURCE_DIR}/include/halp/sample_accurate_controls.hpp"
+    "${AVND_SOURCE_DIR}/include/halp/smooth.hpp"
     "${AVND_SOURCE_DIR}/include/halp/static_string.hpp"
     "${AVND_SOURCE_DIR}/include/halp/texture.hpp"
 
@@ -193,6 +227,33 @@ function(avnd_target_setup AVND_FX_TARGET)
   )
 
   target_link_libraries(${AVND_FX_TARGET} PUBLIC Boost::boost)
+
+  # Realtime-safety checks: the interceptors go once in each binary
+  if(AVENDISH_RT_CHECK)
+    target_compile_definitions(${AVND_FX_TARGET} PUBLIC AVND_RT_CHECK=1)
+
+    get_target_property(_type ${AVND_FX_TARGET} TYPE)
+    if(_type MATCHES "EXECUTABLE|MODULE_LIBRARY|SHARED_LIBRARY")
+      target_sources(${AVND_FX_TARGET} PRIVATE "${AVND_SOURCE_DIR}/src/realtime_check.cpp")
+    endif()
+  endif()
+
+  # Timing of the process calls of every instance
+  if(AVENDISH_DSP_LOAD)
+    target_compile_definitions(${AVND_FX_TARGET} PUBLIC AVND_DSP_LOAD=1)
+  endif()
+
+  # Logging from the audio thread, written by a background thread
+  if(AVENDISH_REALTIME_LOGGER)
+    target_compile_definitions(${AVND_FX_TARGET} PUBLIC AVND_REALTIME_LOGGER=1)
+    target_link_libraries(${AVND_FX_TARGET} PUBLIC Threads::Threads)
+  endif()
+
+  # Tracing of the calls to the processors, written by a background thread
+  if(AVENDISH_TRACE)
+    target_compile_definitions(${AVND_FX_TARGET} PUBLIC AVND_TRACE=1)
+    target_link_libraries(${AVND_FX_TARGET} PUBLIC Threads::Threads)
+  endif()
 endfunction()
 
 function(avnd_common_setup AVND_TARGET AVND_FX_TARGET)
@@ -1,13 +1,125 @@
 include(CTest)
 
+option(AVENDISH_BENCHMARK_EXAMPLES "Build a benchmark of all the examples (long to compile)" OFF)
+
 function(avnd_add_static_test theTarget theFile)
   add_library("${theTarget}" STATIC "${theFile}")
   avnd_common_setup("" "${theTarget}")
 endfunction()
 
+# Benchmarks are built with the tests but not run by ctest: run them by hand
+function(avnd_add_benchmark theTarget theFile)
+  add_executable("${theTarget}" "${theFile}")
+  avnd_common_setup("" "${theTarget}")
+endfunction()
+
+# Runtime checks of the wrappers
+function(avnd_add_runtime_test theTarget theFile)
+  add_executable("${theTarget}" "${theFile}")
+  avnd_common_setup("" "${theTarget}")
+  add_test(NAME "${theTarget}" COMMAND "${theTarget}")
+endfunction()
+
+# Realtime-safety checks, always enabled for those tests
+function(avnd_add_realtime_test theTarget)
+  add_executable("${theTarget}" ${ARGN} "${AVND_SOURCE_DIR}/src/realtime_check.cpp")
+  target_compile_definitions("${theTarget}" PRIVATE AVND_RT_CHECK=1)
+  if(CLAP_HEADER)
+    target_include_directories("${theTarget}" PRIVATE "${CLAP_HEADER}")
+  endif()
+  avnd_common_setup("" "${theTarget}")
+  add_test(NAME "${theTarget}" COMMAND "${theTarget}")
+endfunction()
+
+# Tracing, always enabled for those tests
+function(avnd_add_trace_test theTarget theFile)
+  add_executable("${theTarget}" "${theFile}")
+  target_compile_definitions("${theTarget}" PRIVATE AVND_TRACE=1)
+  target_link_libraries("${theTarget}" PRIVATE Threads::Threads)
+  avnd_common_setup("" "${theTarget}")
+  add_test(NAME "${theTarget}" COMMAND "${theTarget}")
+endfunction()
+
+# Drives each audio plug-in through the example host, vintage and clap
+function(avnd_add_realtime_plugin_tests)
+  get_property(plugins GLOBAL PROPERTY AVND_AUDIO_PLUGINS)
+  foreach(plugin ${plugins})
+    string(REPLACE "|" ";" plugin "${plugin}")
+    list(GET plugin 0 AVND_TARGET)
+    list(GET plugin 1 AVND_MAIN_FILE)
+    list(GET plugin 2 AVND_MAIN_CLASS)
+
+    configure_file(
+      "${AVND_SOURCE_DIR}/tests/realtime/rt_check.cpp.in"
+      "${CMAKE_BINARY_DIR}/realtime/${AVND_TARGET}_rt_check.cpp"
+      @ONLY
+      NEWLINE_STYLE LF
+    )
+    avnd_add_realtime_test("${AVND_TARGET}_rt_check"
+      "${CMAKE_BINARY_DIR}/realtime/${AVND_TARGET}_rt_check.cpp"
+    )
+  endforeach()
+endfunction()
+
+# A single executable which runs all the examples built with the example host
+function(avnd_add_examples_benchmark theTarget)
+  get_property(examples GLOBAL PROPERTY AVND_EXAMPLE_HOSTS)
+
+  set(sources)
+  set(AVND_BENCH_DECLARATIONS "")
+  set(AVND_BENCH_CALLS "")
+  foreach(example ${examples})
+    string(REPLACE "|" ";" example "${example}")
+    list(GET example 0 AVND_TARGET)
+    list(GET example 1 AVND_MAIN_FILE)
+    list(GET example 2 AVND_MAIN_CLASS)
+    string(MAKE_C_IDENTIFIER "avnd_bench_${AVND_TARGET}" AVND_BENCH_FUNCTION)
+
+    configure_file(
+      "${AVND_SOURCE_DIR}/tests/benchmarks/bench_example.cpp.in"
+      "${CMAKE_BINARY_DIR}/benchmarks/${AVND_BENCH_FUNCTION}.cpp"
+      @ONLY
+      NEWLINE_STYLE LF
+    )
+    list(APPEND sources "${CMAKE_BINARY_DIR}/benchmarks/${AVND_BENCH_FUNCTION}.cpp")
+    string(APPEND AVND_BENCH_DECLARATIONS
+      "void ${AVND_BENCH_FUNCTION}(const avnd_bench::context&);\n")
+    string(APPEND AVND_BENCH_CALLS "  ${AVND_BENCH_FUNCTION}(ctx);\n")
+  endforeach()
+
+  configure_file(
+    "${AVND_SOURCE_DIR}/tests/benchmarks/bench_examples.cpp.in"
+    "${CMAKE_BINARY_DIR}/benchmarks/${theTarget}.cpp"
+    @ONLY
+    NEWLINE_STYLE LF
+  )
+
+  add_executable("${theTarget}" "${CMAKE_BINARY_DIR}/benchmarks/${theTarget}.cpp" ${sources})
+  avnd_common_setup("" "${theTarget}")
+endfunction()
+
 if(BUILD_TESTING)
   avnd_add_static_test(test_vintage tests/tests_vintage.cpp)
   avnd_add_static_test(test_channels tests/tests_channels.cpp)
   avnd_add_static_test(test_function_reflection tests/tests_function_reflection.cpp)
   avnd_add_static_test(test_audioprocessor tests/test_audioprocessor.cpp)
+
+  avnd_add_runtime_test(test_control_storage tests/wrappers/test_control_storage.cpp)
+  avnd_add_runtime_test(test_smoothing tests/wrappers/test_smoothing.cpp)
+  avnd_add_runtime_test(test_zero_buffers tests/wrappers/test_zero_buffers.cpp)
+
+  avnd_add_benchmark(bench_convert_samples tests/benchmarks/bench_convert_samples.cpp)
+  avnd_add_benchmark(bench_denormals tests/benchmarks/bench_denormals.cpp)
+  avnd_add_benchmark(bench_conventions tests/benchmarks/bench_conventions.cpp)
+  avnd_add_benchmark(bench_dispatch tests/benchmarks/bench_dispatch.cpp)
+
+  avnd_add_realtime_test(test_realtime_check tests/realtime/test_realtime_check.cpp)
+  avnd_add_trace_test(test_trace tests/trace/test_trace.cpp)
+  if(AVENDISH_RT_CHECK)
+    avnd_add_realtime_plugin_tests()
+  endif()
+
+  if(AVENDISH_BENCHMARK_EXAMPLES)
+    avnd_add_examples_benchmark(bench_examples)
+  endif()
 endif()
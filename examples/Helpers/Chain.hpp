@@ -0,0 +1,78 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/wrappers/chain.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+
+#include <cmath>
+
+namespace examples::helpers
+{
+struct ChainGain
+{
+  halp_flag(silence_in_silence_out);
+
+  struct inputs
+  {
+    halp::knob_f32<"Gain", halp::range{.min = 0., .max = 4., .init = 1.}> gain;
+  };
+
+  struct outputs
+  {
+  };
+
+  float operator()(float input, const inputs& ins) { return ins.gain * input; }
+};
+
+struct ChainSaturation
+{
+  halp_flag(silence_in_silence_out);
+
+  struct inputs
+  {
+    halp::knob_f32<"Drive", halp::range{.min = 1., .max = 20., .init = 2.}> drive;
+  };
+
+  struct outputs
+  {
+  };
+
+  float operator()(float input, const inputs& ins)
+  {
+    return std::tanh(ins.drive * input) / std::tanh(float(ins.drive));
+  }
+};
+
+// Works on whole blocks
+struct ChainDcBlocker
+{
+  template <typename FP>
+  void operator()(FP* in, FP* out, int frames)
+  {
+    for (int i = 0; i < frames; i++)
+    {
+      const float x = in[i];
+      previous_out = x - previous_in + 0.995f * previous_out;
+      previous_in = x;
+      out[i] = previous_out;
+    }
+  }
+
+  float previous_in{};
+  float previous_out{};
+};
+
+/**
+ * The gain and the saturation run in the same loop over the samples,
+ * then the DC blocker goes over the whole block.
+ * The host sees a single processor with the "Gain" and "Drive" controls.
+ */
+struct Chain : avnd::chain<ChainGain, ChainSaturation, ChainDcBlocker>
+{
+  halp_meta(name, "Chain (helpers)")
+  halp_meta(c_name, "avnd_helpers_chain")
+  halp_meta(uuid, "3c5e6a21-84f2-4d0b-9a7e-2f1b8d6c4e93")
+};
+}
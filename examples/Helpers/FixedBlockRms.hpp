@@ -0,0 +1,58 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+
+#include <cmath>
+
+namespace examples::helpers
+{
+/**
+ * Computes the RMS level over windows of exactly 512 frames,
+ * whatever the buffer size of the host is.
+ *
+ * The audio goes through unchanged: it gets delayed by 512 frames,
+ * which the bindings report to the host as latency.
+ */
+struct FixedBlockRms
+{
+  halp_meta(name, "RMS (fixed block)")
+  halp_meta(c_name, "avnd_fixed_block_rms")
+  halp_meta(uuid, "2b8e6f51-93d4-4c0a-a7e2-5d1c8b4f0e96")
+
+  // The wrapper buffers the audio so that we are always called with 512 frames
+  static constexpr int fixed_block_size = 512;
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Input", double> audio;
+  } inputs;
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Output", double> audio;
+    halp::val_port<"RMS", double> rms;
+  } outputs;
+
+  void operator()(int frames)
+  {
+    double sum = 0.;
+    for (int c = 0; c < inputs.audio.channels; c++)
+    {
+      auto* in = inputs.audio[c];
+      auto* out = outputs.audio[c];
+      for (int i = 0; i < frames; i++)
+      {
+        sum += in[i] * in[i];
+        out[i] = in[i];
+      }
+    }
+
+    const int samples = frames * inputs.audio.channels;
+    outputs.rms = samples > 0 ? std::sqrt(sum / samples) : 0.;
+  }
+};
+}
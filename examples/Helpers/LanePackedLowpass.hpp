@@ -0,0 +1,52 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+
+namespace examples::helpers
+{
+// The inputs are shared by all the instances, so they must not depend
+// on the sample type.
+struct LanePackedLowpassInputs
+{
+  halp::hslider_f32<"Weight", halp::range{.min = 0., .max = 1., .init = 0.5}> weight;
+};
+
+/**
+ * A one-pole lowpass written as a template on its sample type.
+ *
+ * When it gets duplicated for each channel of the host, multiple channels
+ * are packed in a single instance with Sample = avnd::simd_lanes<float, N>,
+ * e.g. 8 channels are filtered in a single AVX2 pass.
+ */
+template <typename Sample>
+struct BasicLanePackedLowpass
+{
+  halp_meta(name, "Lowpass (lane-packed)")
+  halp_meta(c_name, "avnd_lane_packed_lowpass")
+  halp_meta(uuid, "0ed8a9c7-6b4a-4f2e-9d35-5c2f41e0c6a3")
+
+  // This is what enables the packing
+  template <typename S>
+  using rebind_sample = BasicLanePackedLowpass<S>;
+
+  using inputs = LanePackedLowpassInputs;
+  struct outputs
+  {
+  };
+
+  Sample operator()(Sample in, const inputs& ins)
+  {
+    const float weight = ins.weight;
+    previous = weight * in + (1.f - weight) * previous;
+    return previous;
+  }
+
+  Sample previous{};
+};
+
+using LanePackedLowpass = BasicLanePackedLowpass<float>;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/mappings.hpp>
+#include <halp/meta.hpp>
+
+#include <cmath>
+
+namespace examples::helpers
+{
+/**
+ * A tanh saturation. Driven hard, it creates harmonics far above
+ * the Nyquist frequency of the host, which would fold back as aliasing:
+ * it asks to be run at four times the host rate instead.
+ */
+struct OversampledDistortion
+{
+  halp_meta(name, "Distortion (oversampled)")
+  halp_meta(c_name, "avnd_oversampled_distortion")
+  halp_meta(uuid, "8f0d2c64-5b1e-4f7a-b3c9-1e6a7d94c205")
+
+  // The audio is upsampled before operator() and downsampled after
+  static constexpr int oversampling = 4;
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Input", double> audio;
+    // Each decade of drive gets the same share of the slider
+    struct : halp::log_hslider_f32<"Drive", halp::range{.min = 1., .max = 100., .init = 10.}>
+    {
+      // Called by the bindings when the drive changes, before processing
+      void update(OversampledDistortion& self) { self.makeup = 1. / std::tanh(value); }
+    } drive;
+  } inputs;
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Output", double> audio;
+  } outputs;
+
+  void prepare(halp::setup) { inputs.drive.update(*this); }
+
+  void operator()(int frames)
+  {
+    const double drive = inputs.drive;
+    for (int c = 0; c < inputs.audio.channels; c++)
+    {
+      auto* in = inputs.audio[c];
+      auto* out = outputs.audio[c];
+      for (int i = 0; i < frames; i++)
+        out[i] = makeup * std::tanh(drive * in[i]);
+    }
+  }
+
+  double makeup{};
+};
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/mappings.hpp>
+#include <halp/meta.hpp>
+#include <halp/smooth.hpp>
+
+namespace examples::helpers
+{
+/**
+ * A gain without zipper noise: the bindings ramp the control over 20 ms
+ * whenever it changes, and the processor reads the value of each frame
+ * in the "ramp" of the control.
+ */
+struct SmoothGain
+{
+  halp_meta(name, "Gain (smooth)")
+  halp_meta(c_name, "avnd_smooth_gain")
+  halp_meta(uuid, "5a0e7c3d-91b2-4f6e-a8d4-3c6b1f9e2d70")
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Input", double> audio;
+    // A fader: linear in decibels for the host, linear in amplitude for the processor
+    halp::smooth<
+        halp::mapped<
+            halp::hslider_f32<"Gain", halp::range{.min = 0., .max = 2., .init = 1.}>,
+            halp::db_mapping<>>,
+        20.>
+        gain;
+  } inputs;
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Output", double> audio;
+  } outputs;
+
+  void operator()(int frames)
+  {
+    const auto& gain = inputs.gain.ramp;
+    for (int c = 0; c < inputs.audio.channels; c++)
+    {
+      auto* in = inputs.audio[c];
+      auto* out = outputs.audio[c];
+      for (int i = 0; i < frames; i++)
+        out[i] = gain[i] * in[i];
+    }
+  }
+};
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+#include <halp/sample_accurate_controls.hpp>
+
+namespace examples::helpers
+{
+/**
+ * A plain block-based gain, which only ever reads the "value" of its control.
+ *
+ * As it asks for the blocks to be split at each timestamped change,
+ * it still applies gain changes at the exact sample they were sent for.
+ */
+struct SubBlockGain
+{
+  halp_meta(name, "Gain (sub-block)")
+  halp_meta(c_name, "avnd_sub_block_gain")
+  halp_meta(uuid, "c7d5b3f0-4a5e-4d8b-9c41-7e2b9f3a6d15")
+
+  // Split the process call at each timestamped control change...
+  halp_flag(split_at_control_changes);
+
+  // ... but never produce sub-blocks smaller than this
+  static constexpr int minimum_sub_block_frames = 32;
+
+  // A gain of silence is silence: no need to run at all then
+  halp_flag(silence_in_silence_out);
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Input", double> audio;
+    halp::accurate<halp::hslider_f32<"Gain", halp::range{.min = 0., .max = 2., .init = 1.}>>
+        gain;
+  } inputs;
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Output", double> audio;
+  } outputs;
+
+  void operator()(int frames)
+  {
+    const double gain = inputs.gain.value;
+    for (int c = 0; c < inputs.audio.channels; c++)
+    {
+      auto* in = inputs.audio[c];
+      auto* out = outputs.audio[c];
+      for (int i = 0; i < frames; i++)
+        out[i] = gain * in[i];
+    }
+  }
+};
+}
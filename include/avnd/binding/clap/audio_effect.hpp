@@ -4,14 +4,21 @@
 
 #include <avnd/binding/clap/bus_info.hpp>
 #include <avnd/binding/clap/helpers.hpp>
+#include <avnd/common/denormals.hpp>
+#include <avnd/common/realtime_check.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/common/export.hpp>
 #include <avnd/introspection/channels.hpp>
 #include <avnd/introspection/midi.hpp>
 #include <avnd/wrappers/control_display.hpp>
 #include <avnd/wrappers/controls.hpp>
 #include <avnd/wrappers/controls_double.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
+#include <avnd/wrappers/latency.hpp>
 #include <avnd/wrappers/metadatas.hpp>
+#include <avnd/wrappers/parallel_channels.hpp>
 #include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
 #include <avnd/wrappers/widgets.hpp>
 #include <clap/all.h>
 
@@ -108,19 +115,63 @@ struct SimpleAudioEffect : clap_plugin
   const clap_host& host;
 
   [[no_unique_address]] avnd_clap::audio_bus_info<T> audio_busses;
-  [[no_unique_address]] avnd::process_adapter<T> processor;
+  [[no_unique_address]] avnd::process_adapter_for<T> processor;
   [[no_unique_address]] midi_processor<T> midi;
+  [[no_unique_address]] avnd::control_smoothing<T> smoothing;
+
+  avnd::latency_tracker latency;
+  [[no_unique_address]] avnd::dsp_load_tracker<T> dsp_load;
+
+  // Runs the per-channel instances on the thread pool of the host
+  struct host_thread_pool final : avnd::parallel_executor
+  {
+    const clap_host& host;
+    const clap_host_thread_pool* ext{};
+    void* context{};
+    task_type task{};
+
+    explicit host_thread_pool(const clap_host& h)
+        : host{h}
+    {
+    }
+
+    void run(int count, void* ctx, task_type t) noexcept override
+    {
+      context = ctx;
+      task = t;
+      if (!ext->request_exec(&host, count))
+      {
+        for (int i = 0; i < count; i++)
+          t(ctx, i);
+      }
+    }
+  } host_pool{host};
+
+  // When the host does not have one
+  avnd::parallel_channels_pool<T> internal_pool;
 
   float sample_rate{44100.};
   int buffer_size{512};
 
+  // Values last reported to the host
+  const clap_host_latency* host_latency{};
+  const clap_host_tail* host_tail{};
+  int reported_latency{};
+  uint32_t reported_tail{};
+
   explicit SimpleAudioEffect(const clap_host* h)
       : host{*h}
   {
     // Set-up clap data structures
     clap_plugin::desc = &descriptor;
     clap_plugin::plugin_data = this;
-    clap_plugin::init = [](const struct clap_plugin* plugin) -> bool { return true; };
+    clap_plugin::init = [](const struct clap_plugin* plugin) -> bool {
+      auto& p = *self(plugin);
+      p.host_latency
+          = (const clap_host_latency*)p.host.get_extension(&p.host, "clap.latency");
+      p.host_tail = (const clap_host_tail*)p.host.get_extension(&p.host, "clap.tail");
+      return true;
+    };
     clap_plugin::destroy
         = [](const struct clap_plugin* plugin) -> void { delete self(plugin); };
 
@@ -134,10 +185,14 @@ struct SimpleAudioEffect : clap_plugin
       p.buffer_size = max_frames_count;
 
       p.start();
+      p.report_latency();
       return true;
     };
 
-    clap_plugin::deactivate = [](const struct clap_plugin* plugin) -> void {};
+    clap_plugin::deactivate = [](const struct clap_plugin* plugin) -> void {
+      auto& p = *self(plugin);
+      p.internal_pool.stop(p.processor);
+    };
 
     clap_plugin::start_processing
         = [](const struct clap_plugin* plugin) -> bool { return true; };
@@ -151,6 +206,10 @@ struct SimpleAudioEffect : clap_plugin
     {
       auto& p = *self(plugin);
       p.process(*process);
+
+      // The host can stop calling us until the input is not silent anymore
+      if (avnd::output_silent(p.processor))
+        return CLAP_PROCESS_SLEEP;
       return CLAP_PROCESS_CONTINUE;
     };
 
@@ -166,6 +225,13 @@ struct SimpleAudioEffect : clap_plugin
         return &p.audio_ports;
       if (id_sv == "clap.note-ports")
         return &p.note_ports;
+      if (id_sv == "clap.latency")
+        return &p.latency_ext;
+      if (id_sv == "clap.tail")
+        return &p.tail_ext;
+      if constexpr (avnd::parallel_channels_processor<T>)
+        if (id_sv == "clap.thread-pool")
+          return &p.thread_pool_ext;
 
       return nullptr;
     };
@@ -197,8 +263,68 @@ struct SimpleAudioEffect : clap_plugin
       midi.reserve_space(this->effect, buffer_size);
     }
 
+    // Setup the ramps of the smooth controls
+    smoothing.reserve_space(this->effect, buffer_size, sample_rate);
+
     // Effect-specific preparation
     avnd::prepare(effect, setup_info);
+
+    latency.reset(effect, processor);
+    dsp_load.start(sample_rate);
+
+    start_parallel_channels(setup_info.output_channels);
+  }
+
+  void start_parallel_channels(int channels)
+  {
+    if constexpr (
+        avnd::parallel_channels_processor<T> && requires { processor.executor; })
+    {
+      const auto ext
+          = (const clap_host_thread_pool*)host.get_extension(&host, "clap.thread-pool");
+      if (ext && ext->request_exec)
+      {
+        internal_pool.stop(processor);
+        host_pool.ext = ext;
+        processor.executor = &host_pool;
+      }
+      else
+      {
+        internal_pool.start(processor, channels);
+      }
+    }
+  }
+
+  // Main thread, from activate: the only place where the latency is allowed to change
+  void report_latency()
+  {
+    const int l = latency.latency.load(std::memory_order_relaxed);
+    if (l != reported_latency)
+    {
+      reported_latency = l;
+      if (host_latency)
+        host_latency->changed(&host);
+    }
+    reported_tail = latency.tail.load(std::memory_order_relaxed);
+  }
+
+  // Audio thread
+  void notify_latency_change()
+  {
+    if (!latency.consume_change())
+      return;
+
+    // The host is told about the new latency when it re-activates us
+    if (latency.latency.load(std::memory_order_relaxed) != reported_latency)
+      host.request_restart(&host);
+
+    const uint32_t t = latency.tail.load(std::memory_order_relaxed);
+    if (t != reported_tail)
+    {
+      reported_tail = t;
+      if (host_tail)
+        host_tail->changed(&host);
+    }
   }
 
   template <auto access_samples>
@@ -247,10 +373,20 @@ struct SimpleAudioEffect : clap_plugin
         avnd::span<samples_t*>{inputs, std::size_t(in_N)},
         avnd::span<samples_t*>{outputs, std::size_t(out_N)},
         process.frames_count);
+
+    // Silent outputs are constant
+    const bool silent = avnd::output_silent(processor);
+    for (int bus = 0; bus < process.audio_outputs_count; bus++)
+      process.audio_outputs[bus].constant_mask = silent ? ~uint64_t(0) : 0;
   }
 
   void process(const clap_process& process)
   {
+    [[maybe_unused]] avnd::realtime_scope realtime{"clap"};
+    [[maybe_unused]] avnd::denormal_guard<T> denormals;
+    [[maybe_unused]] auto load = dsp_load.measure(this->effect, process.frames_count);
+    [[maybe_unused]] avnd::trace_span span{"process", avnd::get_name<T>()};
+
     // Clear the control out ports
     // FIXME
 
@@ -259,6 +395,7 @@ struct SimpleAudioEffect : clap_plugin
 
     // Process the input events
     process_in_events(process);
+    smoothing.process(this->effect, process.frames_count);
 
     // Process the audio
     {
@@ -289,6 +426,9 @@ struct SimpleAudioEffect : clap_plugin
 
     // Clear the midi in ports
     midi.clear_inputs(this->effect);
+
+    latency.update(this->effect, processor);
+    notify_latency_change();
   }
 
   void process_param(const clap_event_param_value& p)
@@ -296,8 +436,10 @@ struct SimpleAudioEffect : clap_plugin
     param_in_info::for_nth_mapped(
         this->effect.inputs(),
         p.param_id,
-        [&]<typename C>(C& field)
-        { field.value = avnd::map_control_from_01<C>(p.value); });
+        [&]<typename C>(C& field) {
+          avnd::set_control_value(
+              this->effect, field, avnd::map_control_from_01<C>(p.value));
+        });
   }
 
   void process_transport(const clap_event_transport& transport)
@@ -307,6 +449,7 @@ struct SimpleAudioEffect : clap_plugin
 
   void process_in_events(const clap_process& p)
   {
+    [[maybe_unused]] avnd::trace_span span{"control", avnd::get_name<T>()};
     if constexpr (midi_in_info::size > 0)
     {
       auto N = p.in_events->size(p.in_events);
@@ -394,6 +537,13 @@ struct SimpleAudioEffect : clap_plugin
               info->max_value = avnd::get_enum_choices_count<C>() - 1;
               info->flags |= CLAP_PARAM_IS_STEPPED;
             }
+            else if constexpr (avnd::mapped_parameter<C>)
+            {
+              // The host automates in [0; 1], which the mapping converts
+              info->default_value = avnd::map_control_to_01<C>(range.init);
+              info->min_value = 0.;
+              info->max_value = 1.;
+            }
             else
             {
               info->min_value = avnd::map_control_to_double<C>(range.min);
@@ -414,8 +564,12 @@ struct SimpleAudioEffect : clap_plugin
     param_in_info::for_nth_raw(
         this->effect.inputs(),
         param_id,
-        [&]<typename C>(const C& field)
-        { *value = avnd::map_control_to_double(field); });
+        [&]<typename C>(const C& field) {
+          if constexpr (avnd::mapped_parameter<C>)
+            *value = avnd::map_control_to_01(field);
+          else
+            *value = avnd::map_control_to_double(field);
+        });
 
     return true;
   }
@@ -427,8 +581,12 @@ struct SimpleAudioEffect : clap_plugin
         param_id, [&]<auto Idx, typename C>(avnd::field_reflection<Idx, C> tag) {
           if (!ok)
           {
-            ok = avnd::display_control<C>(
-                avnd::map_control_from_double<C>(value), display, size);
+            if constexpr (avnd::mapped_parameter<C>)
+              ok = avnd::display_control<C>(
+                  avnd::map_control_from_01<C>(value), display, size);
+            else
+              ok = avnd::display_control<C>(
+                  avnd::map_control_from_double<C>(value), display, size);
           }
         });
 
@@ -509,6 +667,24 @@ struct SimpleAudioEffect : clap_plugin
           return avnd_clap::audio_bus_info<T>::output_info(index, *info);
       }};
 
+  static constexpr clap_plugin_latency latency_ext{
+      .get = [](const clap_plugin* plugin) -> uint32_t {
+        auto& p = *self(plugin);
+        return avnd::get_latency(p.effect, p.processor);
+      }};
+
+  static constexpr clap_plugin_tail tail_ext{
+      .get = [](const clap_plugin* plugin) -> uint32_t {
+        // UINT32_MAX means infinite, like avnd::infinite_tail
+        return avnd::get_tail(self(plugin)->effect);
+      }};
+
+  static constexpr clap_plugin_thread_pool thread_pool_ext{
+      .exec = [](const clap_plugin* plugin, uint32_t task_index) {
+        auto& pool = self(plugin)->host_pool;
+        pool.task(pool.context, task_index);
+      }};
+
   static constexpr clap_plugin_note_ports note_ports{
       .count = [](const clap_plugin* plugin, bool input) -> uint32_t
       {
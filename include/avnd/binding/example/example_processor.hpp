@@ -1,5 +1,8 @@
 #pragma once
+#include <avnd/common/denormals.hpp>
 #include <avnd/common/export.hpp>
+#include <avnd/common/realtime_check.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/introspection/channels.hpp>
 #include <avnd/introspection/messages.hpp>
 #include <avnd/introspection/midi.hpp>
@@ -10,21 +13,25 @@
 #include <avnd/wrappers/controls.hpp>
 #include <avnd/wrappers/controls_double.hpp>
 #include <avnd/wrappers/controls_storage.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
+#include <avnd/wrappers/latency.hpp>
 #include <avnd/wrappers/metadatas.hpp>
 #include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
 #include <avnd/wrappers/widgets.hpp>
 
 #include <utility>
 
 #include <string_view>
 
-#include <halp/log.hpp>
 #include <halp/fft.hpp>
+#include <halp/log.hpp>
+#include <halp/realtime_log.hpp>
 namespace exhs
 {
 struct config
 {
-  using logger_type = halp::basic_logger;
+  using logger_type = halp::realtime_logger_for<halp::basic_logger>;
 
   template<typename T>
   using fft_type = halp::fft<T>;
@@ -83,7 +90,7 @@ class example_processor
   // This is done efficiently: as far as possible, there will be a single copy
   // of the input controls for instance, only the internal state will be duplicated
   // in memory.
-  [[no_unique_address]] avnd::process_adapter<T> processor;
+  [[no_unique_address]] avnd::process_adapter_for<T> processor;
 
   [[no_unique_address]] avnd::audio_channel_manager<T> channels;
 
@@ -91,17 +98,23 @@ class example_processor
 
   [[no_unique_address]] avnd::control_storage<T> control_buffers;
 
+  [[no_unique_address]] avnd::control_smoothing<T> smoothing;
+
   [[no_unique_address]] avnd::callback_storage<T> callbacks;
 
   int buffer_size{};
   double sample_rate{};
 
 public:
-  example_processor()
+  // Time spent in process(), readable with dsp_load.stats() from any thread
+  [[no_unique_address]] avnd::dsp_load_tracker<T> dsp_load;
+
+  explicit example_processor(bool print_introspection = true)
       : channels{effect}
   {
     /// Print some metadata
-    exhs::introspect<T>();
+    if (print_introspection)
+      exhs::introspect<T>();
 
     /// Initialize the host with how many audio channels are requested by the plug-in,
     /// for hosts which work like this:
@@ -206,8 +219,13 @@ public:
       control_buffers.reserve_space(effect, buffer_size);
     }
 
+    // Setup the ramps of the smooth controls
+    smoothing.reserve_space(effect, buffer_size, sample_rate);
+
     // Effect-specific preparation
     avnd::prepare(effect, setup_info);
+
+    dsp_load.start(sample_rate);
   }
 
   void start(int buffer_size, double sample_rate)
@@ -218,8 +236,25 @@ public:
     audio_configuration_changed();
   }
 
+  // Asks for a given number of channels, before start().
+  // Processors with a fixed channel count may not accept it:
+  // the actual count is given by input_channels() / output_channels().
+  void set_channels(int inputs, int outputs)
+  {
+    channels.set_input_channels(effect, 0, inputs);
+    channels.set_output_channels(effect, 0, outputs);
+  }
+
+  int input_channels() const noexcept { return channels.actual_runtime_inputs; }
+  int output_channels() const noexcept { return channels.actual_runtime_outputs; }
+
+  // Latency to report to the host, in frames
+  int latency() noexcept { return avnd::get_latency(effect, processor); }
+
   void apply_control(int control_id, auto value)
   {
+    [[maybe_unused]] avnd::trace_span span{"control", avnd::get_name<T>()};
+
     // Here, control_id will refer to the index of a parameter of a given type.
     // That is, if the input ports of a processor are:
     //
@@ -238,7 +273,11 @@ public:
     param_in_info::for_nth_mapped(
         this->effect.inputs(),
         control_id,
-        [&]<typename C>(C& field) { field.value = value; });
+        [&]<typename C>(C& field) {
+          if constexpr (requires { field.value = static_cast<decltype(field.value)>(value); })
+            avnd::set_control_value(
+                this->effect, field, static_cast<decltype(field.value)>(value));
+        });
   }
 
   void apply_midi_in(int midi_id, std::array<unsigned char, 3> bytes)
@@ -303,6 +342,8 @@ public:
   template <std::floating_point Fp>
   void process(Fp** inputs, int in_N, Fp** outputs, int out_N, int frames)
   {
+    [[maybe_unused]] avnd::realtime_scope realtime{"example"};
+
     // Sanity checks
     if (in_N != this->channels.actual_runtime_inputs)
     {
@@ -315,8 +356,13 @@ public:
       return;
     }
 
+    [[maybe_unused]] auto load = dsp_load.measure(effect, frames);
+    [[maybe_unused]] avnd::trace_span span{"process", avnd::get_name<T>()};
+
     before_process();
 
+    smoothing.process(effect, frames);
+
     // Check if processing is to be bypassed
     if constexpr (avnd::can_bypass<T>)
     {
@@ -340,6 +386,7 @@ public:
   template <std::floating_point Fp>
   void run_process(Fp** inputs, int in_N, Fp** outputs, int out_N, int frames)
   {
+    [[maybe_unused]] avnd::denormal_guard<T> denormals;
     processor.process(
         effect,
         avnd::span<Fp*>{inputs, std::size_t(in_N)},
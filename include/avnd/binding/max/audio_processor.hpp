@@ -5,10 +5,16 @@
 #include <avnd/binding/max/helpers.hpp>
 #include <avnd/binding/max/init.hpp>
 #include <avnd/binding/max/messages.hpp>
+#include <avnd/common/denormals.hpp>
+#include <avnd/common/realtime_check.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/common/export.hpp>
 #include <avnd/wrappers/avnd.hpp>
 #include <avnd/wrappers/controls.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
 #include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
+#include <avnd/wrappers/symbol_table.hpp>
 #include <cmath>
 #include <ext.h>
 #include <z_dsp.h>
@@ -49,11 +55,22 @@ struct audio_processor
 
   // Our actual code
   avnd::effect_container<T> implementation;
-  avnd::process_adapter<T> processor;
+  avnd::process_adapter_for<T> processor;
+  [[no_unique_address]] avnd::dsp_load_tracker<T> dsp_load;
+  [[no_unique_address]] avnd::control_smoothing<T> smoothing;
 
   [[no_unique_address]] init_arguments<T> init_setup;
   [[no_unique_address]] messages<T> messages_setup;
 
+  using control_symbols = avnd::symbol_table<avnd::input_introspection<T>>;
+
+  // Called when the class is set up
+  static void init_symbols()
+  {
+    messages<T>::init_symbols();
+    control_symbols::init([](const char* name) { return gensym(name); });
+  }
+
   int m_runtime_input_count{};
   int m_runtime_output_count{};
 
@@ -111,6 +128,8 @@ struct audio_processor
 
     // Allocate buffers if supported
     avnd::prepare(implementation, setup_info);
+    smoothing.reserve_space(implementation, N, rate);
+    dsp_load.start(rate);
 
     // Notify puredata of the dsp execution
     constexpr t_perfroutine64 perf = +[](t_object* x,
@@ -139,6 +158,11 @@ struct audio_processor
       long flags,
       void* userparam)
   {
+    [[maybe_unused]] avnd::realtime_scope realtime{"max"};
+    [[maybe_unused]] avnd::denormal_guard<T> denormals;
+    [[maybe_unused]] auto load = dsp_load.measure(implementation, sampleframes);
+    [[maybe_unused]] avnd::trace_span span{"process", avnd::get_name<T>()};
+    smoothing.process(implementation, sampleframes);
     processor.process(
         implementation,
         avnd::span<double*>{ins, std::size_t(numins)},
@@ -148,23 +172,23 @@ struct audio_processor
 
   void process_inlet_control(t_symbol* s, long argc, t_atom* argv)
   {
+    [[maybe_unused]] avnd::trace_span span{"control", avnd::get_name<T>()};
+    const int index = control_symbols::find(s);
+    if (index < 0)
+      return;
+
     switch (argv[0].a_type)
     {
       case A_FLOAT:
       {
-        // Note: teeeechnically, one could store a map of string -> {void*,typeid} and then cast...
-        // but most pd externals seem to just do a chain of if() so this is equivalent
         float res = argv[0].a_w.w_float;
-        avnd::pfr::for_each_field(
-            implementation.inputs(),
-            [s, res]<typename C>(C& ctl)
+        avnd::input_introspection<T>::for_nth(
+            implementation.inputs(), index,
+            [this, res]<typename C>(C& ctl)
             {
               if constexpr (requires { ctl.value = float{}; })
               {
-                if (std::string_view{C::name()} == s->s_name)
-                {
-                  avnd::apply_control(ctl, res);
-                }
+                avnd::apply_control(implementation, ctl, res);
               }
             });
         break;
@@ -174,17 +198,14 @@ struct audio_processor
       {
         // TODO ?
         std::string res = argv[0].a_w.w_sym->s_name;
-        avnd::pfr::for_each_field(
-            implementation.inputs(),
-            [s, &res](auto& ctl)
+        avnd::input_introspection<T>::for_nth(
+            implementation.inputs(), index,
+            [&res](auto& ctl)
             {
               if constexpr (requires { ctl.value = std::string{}; })
               {
-                if (std::string_view{ctl.name()} == s->s_name)
-                {
-                  avnd::apply_control(ctl, std::move(res));
-                  ctl.value = std::move(res);
-                }
+                avnd::apply_control(ctl, std::move(res));
+                ctl.value = std::move(res);
               }
             });
         break;
@@ -300,6 +321,9 @@ audio_processor_metaclass<T>::audio_processor_metaclass()
       = +[](instance* obj, t_symbol* s, int argc, t_atom* argv) -> void
   { obj->process(s, argc, argv); };
 
+  /// Symbols of the messages and controls ///
+  instance::init_symbols();
+
   /// Class creation ///
   g_class = class_new(
       avnd::get_c_name<T>().data(),
@@ -4,6 +4,7 @@
 #undef error
 
 #include <halp/log.hpp>
+#include <halp/realtime_log.hpp>
 #include <avnd/wrappers/configure.hpp>
 
 #include <utility>
@@ -74,7 +75,7 @@ static_assert(avnd::logger<max::logger>);
 
 struct config
 {
-  using logger_type = max::logger;
+  using logger_type = halp::realtime_logger_for<max::logger>;
 };
 
 }
@@ -263,6 +263,9 @@ message_processor_metaclass<T>::message_processor_metaclass()
   constexpr auto obj_process_sym
       = +[](instance* obj, t_symbol* value) -> void { obj->process(value); };
 
+  /// Symbols of the messages ///
+  messages<T>::init_symbols();
+
   /// Class creation ///
   g_class = class_new(
       avnd::get_c_name<T>().data(),
@@ -4,7 +4,9 @@
 
 #include <avnd/binding/max/atom_iterator.hpp>
 #include <avnd/binding/max/helpers.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/introspection/messages.hpp>
+#include <avnd/wrappers/symbol_table.hpp>
 
 namespace max
 {
@@ -167,22 +169,33 @@ struct messages
     return false;
   }
 
+  using message_symbols = avnd::symbol_table<avnd::messages_introspection<T>>;
+
+  // Called when the class is set up
+  static void init_symbols()
+  {
+    if constexpr (avnd::has_messages<T>)
+    {
+      message_symbols::init([](const char* name) { return gensym(name); });
+    }
+  }
+
   static bool process_messages(auto& implementation, t_symbol* s, int argc, t_atom* argv)
   {
     if constexpr (avnd::has_messages<T>)
     {
+      [[maybe_unused]] avnd::trace_span span{"messages", avnd::get_name<T>()};
+      const int index = message_symbols::find(s);
+      if (index < 0)
+        return false;
+
       bool ok = false;
-      std::string_view symname = s->s_name;
-      avnd::messages_introspection<T>::for_all(
-          avnd::get_messages(implementation),
+      avnd::messages_introspection<T>::for_nth(
+          avnd::get_messages(implementation), index,
           [&]<typename M>(M& field)
           {
-            if (ok)
-              return;
-            if (symname == M::name())
-            {
-              ok = process_message(implementation.effect, field, symname, argc, argv);
-            }
+            ok = process_message(
+                implementation.effect, field, message_symbols::names[index], argc, argv);
           });
       return ok;
     }
@@ -0,0 +1,425 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace avnd_offline
+{
+/**
+ * Streaming readers and writers for the files the offline renderer works on:
+ * - WAV files: 8, 16, 24 and 32-bit integer PCM, 32 and 64-bit float,
+ *   with the plain or the extensible header.
+ * - Raw files: interleaved little-endian 32-bit float, without any header.
+ *
+ * Samples are given and taken as planar float channels.
+ */
+enum class sample_format
+{
+  int8,
+  int16,
+  int24,
+  int32,
+  float32,
+  float64
+};
+
+inline int bytes_per_sample(sample_format f) noexcept
+{
+  switch (f)
+  {
+    case sample_format::int8:
+      return 1;
+    case sample_format::int16:
+      return 2;
+    case sample_format::int24:
+      return 3;
+    case sample_format::int32:
+    case sample_format::float32:
+      return 4;
+    case sample_format::float64:
+      return 8;
+  }
+  return 0;
+}
+
+namespace detail
+{
+struct file_closer
+{
+  void operator()(std::FILE* f) const noexcept { std::fclose(f); }
+};
+using file_ptr = std::unique_ptr<std::FILE, file_closer>;
+
+inline uint32_t read_u32(const unsigned char* p) noexcept
+{
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16)
+         | (uint32_t(p[3]) << 24);
+}
+inline uint16_t read_u16(const unsigned char* p) noexcept
+{
+  return uint16_t(p[0] | (p[1] << 8));
+}
+inline void write_u32(unsigned char* p, uint32_t v) noexcept
+{
+  p[0] = v & 0xff;
+  p[1] = (v >> 8) & 0xff;
+  p[2] = (v >> 16) & 0xff;
+  p[3] = (v >> 24) & 0xff;
+}
+inline void write_u16(unsigned char* p, uint16_t v) noexcept
+{
+  p[0] = v & 0xff;
+  p[1] = (v >> 8) & 0xff;
+}
+
+inline float decode_sample(const unsigned char* p, sample_format f) noexcept
+{
+  switch (f)
+  {
+    case sample_format::int8: // Unsigned in WAV files
+      return (int(p[0]) - 128) / 128.f;
+    case sample_format::int16:
+      return int16_t(read_u16(p)) / 32768.f;
+    case sample_format::int24:
+    {
+      int32_t v = int32_t(uint32_t(p[0]) << 8 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 24);
+      return float((v >> 8) / 8388608.);
+    }
+    case sample_format::int32:
+      return float(int32_t(read_u32(p)) / 2147483648.);
+    case sample_format::float32:
+    {
+      const uint32_t bits = read_u32(p);
+      float v;
+      std::memcpy(&v, &bits, 4);
+      return v;
+    }
+    case sample_format::float64:
+    {
+      const uint64_t bits = uint64_t(read_u32(p)) | (uint64_t(read_u32(p + 4)) << 32);
+      double v;
+      std::memcpy(&v, &bits, 8);
+      return float(v);
+    }
+  }
+  return 0.f;
+}
+
+inline void encode_sample(unsigned char* p, float v, sample_format f) noexcept
+{
+  auto to_int = [v](double scale, double max) {
+    return int32_t(std::clamp(std::round(double(v) * scale), -scale, max));
+  };
+  switch (f)
+  {
+    case sample_format::int8:
+      p[0] = uint8_t(to_int(128., 127.) + 128);
+      break;
+    case sample_format::int16:
+      write_u16(p, uint16_t(to_int(32768., 32767.)));
+      break;
+    case sample_format::int24:
+    {
+      const uint32_t x = uint32_t(to_int(8388608., 8388607.));
+      p[0] = x & 0xff;
+      p[1] = (x >> 8) & 0xff;
+      p[2] = (x >> 16) & 0xff;
+      break;
+    }
+    case sample_format::int32:
+      write_u32(p, uint32_t(to_int(2147483648., 2147483647.)));
+      break;
+    case sample_format::float32:
+    {
+      uint32_t bits;
+      std::memcpy(&bits, &v, 4);
+      write_u32(p, bits);
+      break;
+    }
+    case sample_format::float64:
+    {
+      const double d = v;
+      uint64_t bits;
+      std::memcpy(&bits, &d, 8);
+      write_u32(p, uint32_t(bits));
+      write_u32(p + 4, uint32_t(bits >> 32));
+      break;
+    }
+  }
+}
+}
+
+class audio_reader
+{
+public:
+  int channels{};
+  double rate{};
+  int64_t frames{};
+  sample_format format{sample_format::float32};
+
+  bool open_wav(const std::string& path, std::string& error)
+  {
+    m_file.reset(std::fopen(path.c_str(), "rb"));
+    if (!m_file)
+      return fail(error, "cannot open " + path);
+
+    unsigned char header[12];
+    if (std::fread(header, 1, 12, m_file.get()) != 12
+        || std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0)
+      return fail(error, path + " is not a WAV file");
+
+    bool has_format = false;
+    for (;;)
+    {
+      unsigned char chunk[8];
+      if (std::fread(chunk, 1, 8, m_file.get()) != 8)
+        return fail(error, path + ": no data chunk");
+      const uint32_t size = detail::read_u32(chunk + 4);
+
+      if (std::memcmp(chunk, "fmt ", 4) == 0)
+      {
+        std::vector<unsigned char> fmt(std::max<uint32_t>(size, 16));
+        if (std::fread(fmt.data(), 1, size, m_file.get()) != size)
+          return fail(error, path + ": truncated format chunk");
+        if (size % 2)
+          std::fseek(m_file.get(), 1, SEEK_CUR);
+
+        uint16_t tag = detail::read_u16(fmt.data());
+        channels = detail::read_u16(fmt.data() + 2);
+        rate = detail::read_u32(fmt.data() + 4);
+        const int bits = detail::read_u16(fmt.data() + 14);
+
+        // WAVE_FORMAT_EXTENSIBLE: the actual format is in the sub-format GUID
+        if (tag == 0xFFFE && size >= 26)
+          tag = detail::read_u16(fmt.data() + 24);
+
+        if (tag == 1 && bits == 8)
+          format = sample_format::int8;
+        else if (tag == 1 && bits == 16)
+          format = sample_format::int16;
+        else if (tag == 1 && bits == 24)
+          format = sample_format::int24;
+        else if (tag == 1 && bits == 32)
+          format = sample_format::int32;
+        else if (tag == 3 && bits == 32)
+          format = sample_format::float32;
+        else if (tag == 3 && bits == 64)
+          format = sample_format::float64;
+        else
+          return fail(error, path + ": unsupported sample format");
+
+        if (channels <= 0)
+          return fail(error, path + ": no channels");
+        has_format = true;
+      }
+      else if (std::memcmp(chunk, "data", 4) == 0)
+      {
+        if (!has_format)
+          return fail(error, path + ": data chunk before the format chunk");
+        frames = size / (channels * bytes_per_sample(format));
+        return true;
+      }
+      else
+      {
+        std::fseek(m_file.get(), size + (size % 2), SEEK_CUR);
+      }
+    }
+  }
+
+  bool open_raw(const std::string& path, int channels, double rate, std::string& error)
+  {
+    m_file.reset(std::fopen(path.c_str(), "rb"));
+    if (!m_file)
+      return fail(error, "cannot open " + path);
+
+    std::fseek(m_file.get(), 0, SEEK_END);
+    const long size = std::ftell(m_file.get());
+    std::fseek(m_file.get(), 0, SEEK_SET);
+
+    this->channels = channels;
+    this->rate = rate;
+    this->format = sample_format::float32;
+    this->frames = size / (channels * 4);
+    return true;
+  }
+
+  // Reads up to n frames into channels planar buffers; returns the number of frames read
+  int64_t read(float** out, int64_t n)
+  {
+    n = std::min(n, frames - m_position);
+    if (n <= 0)
+      return 0;
+
+    const int sample_bytes = bytes_per_sample(format);
+    m_bytes.resize(n * channels * sample_bytes);
+    const std::size_t frame_bytes = channels * sample_bytes;
+    n = std::fread(m_bytes.data(), frame_bytes, n, m_file.get());
+
+    const unsigned char* p = m_bytes.data();
+    for (int64_t i = 0; i < n; i++)
+      for (int c = 0; c < channels; c++, p += sample_bytes)
+        out[c][i] = detail::decode_sample(p, format);
+
+    m_position += n;
+    return n;
+  }
+
+private:
+  static bool fail(std::string& error, std::string message)
+  {
+    error = std::move(message);
+    return false;
+  }
+
+  detail::file_ptr m_file;
+  std::vector<unsigned char> m_bytes;
+  int64_t m_position{};
+};
+
+class audio_writer
+{
+public:
+  // The sizes in the header of a WAV file are 32-bit:
+  // past 4 GB of audio, write() fails instead of writing a corrupt file.
+  static int64_t max_wav_frames(int channels, sample_format format) noexcept
+  {
+    const int64_t max_riff_bytes = UINT32_MAX;
+    const int64_t frame_bytes = int64_t(std::max(channels, 1)) * bytes_per_sample(format);
+    return (max_riff_bytes - (header_bytes(format) - 8) - 1) / frame_bytes;
+  }
+
+  bool open_wav(
+      const std::string& path, int channels, double rate, sample_format format,
+      std::string& error)
+  {
+    if (!open(path, channels, format, error))
+      return false;
+
+    m_wav = true;
+    m_rate = rate;
+    // Written again with the sizes in close()
+    return write_header();
+  }
+
+  bool open_raw(const std::string& path, int channels, std::string& error)
+  {
+    return open(path, channels, sample_format::float32, error);
+  }
+
+  // Writes n frames from channels planar buffers
+  bool write(float* const* in, int64_t n)
+  {
+    if (m_wav && m_frames + n > max_wav_frames(m_channels, m_format))
+      return false;
+
+    const int sample_bytes = bytes_per_sample(m_format);
+    m_bytes.resize(n * m_channels * sample_bytes);
+
+    unsigned char* p = m_bytes.data();
+    for (int64_t i = 0; i < n; i++)
+      for (int c = 0; c < m_channels; c++, p += sample_bytes)
+        detail::encode_sample(p, in[c][i], m_format);
+
+    m_frames += n;
+    return std::fwrite(m_bytes.data(), 1, m_bytes.size(), m_file.get()) == m_bytes.size();
+  }
+
+  bool close()
+  {
+    if (!m_file)
+      return false;
+
+    bool ok = true;
+    if (m_wav)
+    {
+      const int64_t data_bytes = m_frames * m_channels * bytes_per_sample(m_format);
+      if (data_bytes % 2)
+      {
+        const unsigned char pad = 0;
+        ok &= std::fwrite(&pad, 1, 1, m_file.get()) == 1;
+      }
+      std::fseek(m_file.get(), 0, SEEK_SET);
+      ok &= write_header();
+    }
+    ok &= std::fclose(m_file.release()) == 0;
+    return ok;
+  }
+
+  ~audio_writer()
+  {
+    if (m_file)
+      close();
+  }
+
+private:
+  bool open(const std::string& path, int channels, sample_format format, std::string& error)
+  {
+    m_file.reset(std::fopen(path.c_str(), "wb"));
+    if (!m_file)
+    {
+      error = "cannot create " + path;
+      return false;
+    }
+    m_channels = channels;
+    m_format = format;
+    m_frames = 0;
+    return true;
+  }
+
+  static bool is_float(sample_format format) noexcept
+  {
+    return format == sample_format::float32 || format == sample_format::float64;
+  }
+
+  // Formats other than integer PCM have the 18-byte format chunk, ending with cbSize
+  static int format_chunk_bytes(sample_format format) noexcept
+  {
+    return is_float(format) ? 18 : 16;
+  }
+
+  static int header_bytes(sample_format format) noexcept
+  {
+    return 12 + 8 + format_chunk_bytes(format) + 8;
+  }
+
+  bool write_header()
+  {
+    const int sample_bytes = bytes_per_sample(m_format);
+    const int fmt_bytes = format_chunk_bytes(m_format);
+    const int header = header_bytes(m_format);
+    const uint32_t data_bytes = uint32_t(m_frames * m_channels * sample_bytes);
+
+    unsigned char h[48]{};
+    std::memcpy(h, "RIFF", 4);
+    detail::write_u32(h + 4, header - 8 + data_bytes + (data_bytes % 2));
+    std::memcpy(h + 8, "WAVEfmt ", 8);
+    detail::write_u32(h + 16, fmt_bytes);
+    detail::write_u16(h + 20, is_float(m_format) ? 3 : 1);
+    detail::write_u16(h + 22, uint16_t(m_channels));
+    detail::write_u32(h + 24, uint32_t(m_rate));
+    detail::write_u32(h + 28, uint32_t(m_rate) * m_channels * sample_bytes);
+    detail::write_u16(h + 32, uint16_t(m_channels * sample_bytes));
+    detail::write_u16(h + 34, uint16_t(8 * sample_bytes));
+    // cbSize, if any, is left at 0
+    std::memcpy(h + 20 + fmt_bytes, "data", 4);
+    detail::write_u32(h + 24 + fmt_bytes, data_bytes);
+    return std::fwrite(h, 1, header, m_file.get()) == std::size_t(header);
+  }
+
+  detail::file_ptr m_file;
+  std::vector<unsigned char> m_bytes;
+  int m_channels{};
+  double m_rate{};
+  sample_format m_format{sample_format::float32};
+  int64_t m_frames{};
+  bool m_wav{};
+};
+}
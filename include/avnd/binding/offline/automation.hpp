@@ -0,0 +1,235 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace avnd_offline
+{
+/**
+ * A change of value of a control at a given time of the input file.
+ *
+ * The control is given either by its name or by its index
+ * among the parameters of the processor.
+ */
+struct automation_point
+{
+  double time{};
+  std::string control;
+  double value{};
+};
+
+/**
+ * Automation timelines can be written as CSV:
+ *
+ *   # time (seconds), control, value
+ *   0.0, Gain, 0.5
+ *   1.5, Gain, 1.0
+ *   2.0, 1, 200
+ *
+ * or as JSON:
+ *
+ *   [
+ *     { "time": 0.0, "control": "Gain", "value": 0.5 },
+ *     { "time": 2.0, "control": 1, "value": 200 }
+ *   ]
+ *
+ * The points are sorted by time; points at the same time are applied in order.
+ */
+using automation_timeline = std::vector<automation_point>;
+
+namespace detail
+{
+inline std::string_view trim(std::string_view s) noexcept
+{
+  while (!s.empty() && std::isspace((unsigned char)s.front()))
+    s.remove_prefix(1);
+  while (!s.empty() && std::isspace((unsigned char)s.back()))
+    s.remove_suffix(1);
+  if (s.size() >= 2 && s.front() == '"' && s.back() == '"')
+    s = s.substr(1, s.size() - 2);
+  return s;
+}
+
+inline bool parse_number(std::string_view s, double& res)
+{
+  // std::from_chars for double is not available everywhere yet
+  const std::string str{s};
+  char* end{};
+  res = std::strtod(str.c_str(), &end);
+  return !str.empty() && end == str.c_str() + str.size();
+}
+
+inline bool parse_csv(std::string_view text, automation_timeline& res, std::string& error)
+{
+  int line_number = 0;
+  while (!text.empty())
+  {
+    const auto eol = text.find('\n');
+    std::string_view line = text.substr(0, eol);
+    text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+    line_number++;
+
+    line = trim(line);
+    if (line.empty() || line.front() == '#')
+      continue;
+
+    std::string_view fields[3];
+    int count = 0;
+    for (; count < 3 && !line.empty(); count++)
+    {
+      const auto sep = line.find(',');
+      fields[count] = trim(line.substr(0, sep));
+      line = sep == std::string_view::npos ? std::string_view{} : line.substr(sep + 1);
+    }
+
+    automation_point pt;
+    if (count != 3 || !parse_number(fields[0], pt.time))
+    {
+      // Allow a header line
+      if (res.empty() && line_number == 1)
+        continue;
+      error = "automation: invalid line " + std::to_string(line_number);
+      return false;
+    }
+    if (!parse_number(fields[2], pt.value))
+    {
+      error = "automation: invalid value on line " + std::to_string(line_number);
+      return false;
+    }
+    pt.control = fields[1];
+    res.push_back(std::move(pt));
+  }
+  return true;
+}
+
+// Just enough JSON for an array of flat objects with string and number values
+struct json_parser
+{
+  std::string_view text;
+  std::size_t pos{};
+
+  void skip_spaces() noexcept
+  {
+    while (pos < text.size() && std::isspace((unsigned char)text[pos]))
+      pos++;
+  }
+
+  bool consume(char c) noexcept
+  {
+    skip_spaces();
+    if (pos < text.size() && text[pos] == c)
+    {
+      pos++;
+      return true;
+    }
+    return false;
+  }
+
+  bool parse_string(std::string& res)
+  {
+    if (!consume('"'))
+      return false;
+    res.clear();
+    while (pos < text.size() && text[pos] != '"')
+    {
+      if (text[pos] == '\\' && pos + 1 < text.size())
+        pos++;
+      res += text[pos++];
+    }
+    return consume('"');
+  }
+
+  // Numbers are also returned as strings
+  bool parse_value(std::string& res)
+  {
+    skip_spaces();
+    if (pos < text.size() && text[pos] == '"')
+      return parse_string(res);
+
+    const auto begin = pos;
+    while (pos < text.size() && text[pos] != ',' && text[pos] != '}'
+           && !std::isspace((unsigned char)text[pos]))
+      pos++;
+    res = text.substr(begin, pos - begin);
+    return !res.empty();
+  }
+
+  bool parse(automation_timeline& timeline, std::string& error)
+  {
+    if (!consume('['))
+      return fail(error);
+    if (consume(']'))
+      return true;
+
+    do
+    {
+      if (!consume('{'))
+        return fail(error);
+
+      automation_point pt;
+      bool has_time = false, has_control = false, has_value = false;
+      do
+      {
+        std::string key, value;
+        if (!parse_string(key) || !consume(':') || !parse_value(value))
+          return fail(error);
+
+        if (key == "time")
+          has_time = parse_number(value, pt.time);
+        else if (key == "control")
+          has_control = !(pt.control = value).empty();
+        else if (key == "value")
+          has_value = parse_number(value, pt.value);
+      } while (consume(','));
+
+      if (!consume('}') || !has_time || !has_control || !has_value)
+        return fail(error);
+      timeline.push_back(std::move(pt));
+    } while (consume(','));
+
+    return consume(']') || fail(error);
+  }
+
+  bool fail(std::string& error)
+  {
+    error = "automation: invalid JSON near offset " + std::to_string(pos);
+    return false;
+  }
+};
+}
+
+inline bool
+load_automation(const std::string& path, automation_timeline& res, std::string& error)
+{
+  std::ifstream file{path, std::ios::binary};
+  if (!file)
+  {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  const std::string text = ss.str();
+
+  res.clear();
+  const auto first = text.find_first_not_of(" \t\r\n");
+  const bool ok = (first != std::string::npos && text[first] == '[')
+                      ? detail::json_parser{text}.parse(res, error)
+                      : detail::parse_csv(text, res, error);
+  if (!ok)
+    return false;
+
+  std::stable_sort(res.begin(), res.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.time < rhs.time;
+  });
+  return true;
+}
+}
@@ -0,0 +1,504 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/binding/example/example_processor.hpp>
+#include <avnd/binding/offline/audio_file.hpp>
+#include <avnd/binding/offline/automation.hpp>
+#include <avnd/wrappers/metadatas.hpp>
+#include <avnd/wrappers/symbol_table.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Offline renderer: streams audio files through a processor as fast as possible,
+ * with the same process adapters as the plug-in bindings (see example_processor).
+ */
+namespace avnd_offline
+{
+struct options
+{
+  std::vector<std::string> inputs;
+  std::string output_directory{"."};
+  std::string automation;
+
+  int block_size{512};
+
+  // 0: the rate of the input file
+  double rate{};
+
+  // For raw input files, and when rendering without input
+  int channels{2};
+
+  // 0: as many as there are cores
+  int jobs{};
+
+  // Extra time rendered after the end of the input, in seconds
+  double tail{};
+
+  // Renders this many seconds of silence when there is no input file,
+  // e.g. for generators
+  double length{};
+
+  sample_format output_format{sample_format::float32};
+  bool double_precision{};
+};
+
+inline void print_usage(const char* program)
+{
+  std::fprintf(
+      stderr,
+      "usage: %s [options] [input files...]\n"
+      "\n"
+      "Renders WAV files (.wav) or raw interleaved 32-bit float files (.raw)\n"
+      "through the processor, into files with the same name in the output directory.\n"
+      "\n"
+      "options:\n"
+      "  -o, --output <dir>       output directory (default: .)\n"
+      "  -b, --block <frames>     block size (default: 512)\n"
+      "  -r, --rate <hz>          sample rate (default: the one of the input file,\n"
+      "                           48000 for raw files)\n"
+      "  -c, --channels <n>       channels of raw input files (default: 2)\n"
+      "  -a, --automation <file>  automation timeline, in CSV or JSON\n"
+      "  -j, --jobs <n>           files rendered in parallel (default: number of cores)\n"
+      "  -t, --tail <seconds>     time rendered after the end of the input (default: 0)\n"
+      "  -l, --length <seconds>   without input files: renders this much silence\n"
+      "      --bits <16|24|32>    output WAV format: 16 or 24-bit integer, or 32-bit float\n"
+      "      --double             process in double precision\n",
+      program);
+}
+
+inline bool parse_options(int argc, char** argv, options& opts, std::string& error)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string_view arg = argv[i];
+    auto value = [&]() -> const char* {
+      if (i + 1 >= argc)
+      {
+        error = std::string(arg) + " needs a value";
+        return nullptr;
+      }
+      return argv[++i];
+    };
+    auto number = [&](double& res) {
+      const char* v = value();
+      if (!v)
+        return false;
+      if (!detail::parse_number(v, res))
+      {
+        error = std::string(arg) + ": invalid number " + v;
+        return false;
+      }
+      return true;
+    };
+    auto integer = [&](int& res, int min) {
+      double v{};
+      if (!number(v))
+        return false;
+      if (v < min || v != std::floor(v))
+      {
+        error = std::string(arg) + ": invalid value";
+        return false;
+      }
+      res = int(v);
+      return true;
+    };
+
+    if (arg == "-h" || arg == "--help")
+    {
+      error.clear();
+      return false;
+    }
+    else if (arg == "-o" || arg == "--output")
+    {
+      const char* v = value();
+      if (!v)
+        return false;
+      opts.output_directory = v;
+    }
+    else if (arg == "-a" || arg == "--automation")
+    {
+      const char* v = value();
+      if (!v)
+        return false;
+      opts.automation = v;
+    }
+    else if (arg == "-b" || arg == "--block")
+    {
+      if (!integer(opts.block_size, 1))
+        return false;
+    }
+    else if (arg == "-r" || arg == "--rate")
+    {
+      if (!number(opts.rate))
+        return false;
+      if (opts.rate <= 0.)
+      {
+        error = "the rate must be positive";
+        return false;
+      }
+    }
+    else if (arg == "-c" || arg == "--channels")
+    {
+      if (!integer(opts.channels, 1))
+        return false;
+    }
+    else if (arg == "-j" || arg == "--jobs")
+    {
+      if (!integer(opts.jobs, 1))
+        return false;
+    }
+    else if (arg == "-t" || arg == "--tail")
+    {
+      if (!number(opts.tail))
+        return false;
+    }
+    else if (arg == "-l" || arg == "--length")
+    {
+      if (!number(opts.length))
+        return false;
+    }
+    else if (arg == "--bits")
+    {
+      int bits{};
+      if (!integer(bits, 16))
+        return false;
+      if (bits == 16)
+        opts.output_format = sample_format::int16;
+      else if (bits == 24)
+        opts.output_format = sample_format::int24;
+      else if (bits == 32)
+        opts.output_format = sample_format::float32;
+      else
+      {
+        error = "--bits must be 16, 24 or 32";
+        return false;
+      }
+    }
+    else if (arg == "--double")
+    {
+      opts.double_precision = true;
+    }
+    else if (!arg.empty() && arg[0] == '-')
+    {
+      error = "unknown option " + std::string(arg);
+      return false;
+    }
+    else
+    {
+      opts.inputs.emplace_back(arg);
+    }
+  }
+
+  if (opts.inputs.empty() && opts.length <= 0.)
+  {
+    error = "no input file";
+    return false;
+  }
+  return true;
+}
+
+inline bool is_raw_file(const std::filesystem::path& path)
+{
+  return path.extension() == ".raw";
+}
+
+template <typename T>
+class renderer
+{
+public:
+  using processor_type = exhs::example_processor<T>;
+  using param_in_info = avnd::parameter_input_introspection<T>;
+
+  // An automation point resolved for a given rate
+  struct event
+  {
+    int64_t frame{};
+    int control{};
+    double value{};
+  };
+
+  static bool resolve(
+      const automation_timeline& timeline, double rate, std::vector<event>& res,
+      std::string& error)
+  {
+    res.clear();
+    for (const auto& pt : timeline)
+    {
+      const int control = find_control(pt.control);
+      if (control < 0)
+      {
+        error = "automation: unknown control " + pt.control;
+        return false;
+      }
+      res.push_back({int64_t(std::llround(std::max(0., pt.time) * rate)), control, pt.value});
+    }
+    return true;
+  }
+
+  // Index of a parameter from its name, or from its index as a string
+  static int find_control(const std::string& control)
+  {
+    double index{};
+    if (detail::parse_number(control, index))
+    {
+      if (index >= 0 && index < param_in_info::size && index == std::floor(index))
+        return int(index);
+      return -1;
+    }
+
+    return control_names.find(control);
+  }
+
+  static constexpr auto control_names
+      = avnd::make_name_index(avnd::field_names<param_in_info>());
+  static_assert(control_names.valid);
+
+  // An empty input renders opts.length seconds of silence
+  template <std::floating_point FP>
+  static bool render(
+      const std::string& input, const std::string& output, const options& opts,
+      const automation_timeline& automation, std::string& error)
+  {
+    audio_reader reader;
+    int file_channels = opts.channels;
+    double rate = opts.rate > 0. ? opts.rate : 48000.;
+    int64_t input_frames{};
+    if (input.empty())
+    {
+      input_frames = std::llround(opts.length * rate);
+    }
+    else
+    {
+      if (is_raw_file(input))
+      {
+        if (!reader.open_raw(input, opts.channels, rate, error))
+          return false;
+      }
+      else
+      {
+        if (!reader.open_wav(input, error))
+          return false;
+        if (opts.rate <= 0.)
+          rate = reader.rate;
+      }
+      file_channels = reader.channels;
+      input_frames = reader.frames;
+    }
+
+    std::vector<event> events;
+    if (!resolve(automation, rate, events, error))
+      return false;
+
+    // The processor can be large, and we do not want to print its ports for each file
+    auto processor = std::make_unique<processor_type>(false);
+    processor->set_channels(file_channels, file_channels);
+    processor->start(opts.block_size, rate);
+    const int inputs = processor->input_channels();
+    const int outputs = processor->output_channels();
+
+    // The output is shifted back by the latency of the processor
+    const int latency = std::max(0, processor->latency());
+    const int64_t tail = std::llround(std::max(0., opts.tail) * rate);
+    const int64_t total_frames = input_frames + tail + latency;
+
+    audio_writer writer;
+    if (outputs > 0)
+    {
+      if (!is_raw_file(output)
+          && input_frames + tail > audio_writer::max_wav_frames(outputs, opts.output_format))
+      {
+        error = output + ": the render is larger than the 4 GB a WAV file can hold";
+        return false;
+      }
+
+      const bool ok = is_raw_file(output)
+                          ? writer.open_raw(output, outputs, error)
+                          : writer.open_wav(output, outputs, rate, opts.output_format, error);
+      if (!ok)
+        return false;
+    }
+
+    const int block = opts.block_size;
+    std::vector<float> file_in(std::max(file_channels, 1) * block);
+    std::vector<float> file_out(std::max(outputs, 1) * block);
+    std::vector<FP> dsp_in(std::max(inputs, 1) * block);
+    std::vector<FP> dsp_out(std::max(outputs, 1) * block);
+    std::vector<float*> file_in_ptrs(file_channels), file_out_ptrs(outputs);
+    std::vector<FP*> dsp_in_ptrs(inputs), dsp_out_ptrs(outputs);
+    for (int c = 0; c < file_channels; c++)
+      file_in_ptrs[c] = file_in.data() + c * block;
+    for (int c = 0; c < outputs; c++)
+      file_out_ptrs[c] = file_out.data() + c * block;
+    for (int c = 0; c < inputs; c++)
+      dsp_in_ptrs[c] = dsp_in.data() + c * block;
+    for (int c = 0; c < outputs; c++)
+      dsp_out_ptrs[c] = dsp_out.data() + c * block;
+
+    std::size_t next_event = 0;
+    for (int64_t pos = 0; pos < total_frames;)
+    {
+      // Controls change at the exact frame of the automation points
+      for (; next_event < events.size() && events[next_event].frame <= pos; next_event++)
+        processor->apply_control(events[next_event].control, events[next_event].value);
+
+      int64_t n = std::min<int64_t>(block, total_frames - pos);
+      if (next_event < events.size())
+        n = std::min(n, events[next_event].frame - pos);
+
+      // Inputs: past the end of the file the processor gets silence
+      const int64_t read = reader.read(file_in_ptrs.data(), n);
+      for (int c = 0; c < file_channels; c++)
+        std::fill(file_in_ptrs[c] + read, file_in_ptrs[c] + n, 0.f);
+
+      // Mono files go to all the inputs
+      for (int c = 0; c < inputs; c++)
+      {
+        if (c < file_channels || file_channels == 1)
+        {
+          const float* src = file_in_ptrs[file_channels == 1 ? 0 : c];
+          std::copy_n(src, n, dsp_in_ptrs[c]);
+        }
+        else
+        {
+          std::fill_n(dsp_in_ptrs[c], n, FP{});
+        }
+      }
+
+      processor->process(dsp_in_ptrs.data(), inputs, dsp_out_ptrs.data(), outputs, int(n));
+
+      if (outputs > 0)
+      {
+        const int64_t skip = std::clamp<int64_t>(latency - pos, 0, n);
+        for (int c = 0; c < outputs; c++)
+        {
+          std::copy_n(dsp_out_ptrs[c] + skip, n - skip, file_out_ptrs[c]);
+        }
+        if (n > skip && !writer.write(file_out_ptrs.data(), n - skip))
+        {
+          error = "cannot write to " + output;
+          return false;
+        }
+      }
+
+      pos += n;
+    }
+
+    processor->stop();
+    if (outputs > 0 && !writer.close())
+    {
+      error = "cannot write to " + output;
+      return false;
+    }
+    return true;
+  }
+
+  static int run(int argc, char** argv)
+  {
+    options opts;
+    std::string error;
+    if (!parse_options(argc, argv, opts, error))
+    {
+      if (!error.empty())
+        std::fprintf(stderr, "%s\n\n", error.c_str());
+      print_usage(argv[0]);
+      return error.empty() ? 0 : 1;
+    }
+
+    automation_timeline automation;
+    if (!opts.automation.empty() && !load_automation(opts.automation, automation, error))
+    {
+      std::fprintf(stderr, "%s\n", error.c_str());
+      return 1;
+    }
+
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(opts.output_directory, ec);
+
+    struct job
+    {
+      std::string input;
+      std::string output;
+    };
+    std::vector<job> jobs;
+    for (const auto& input : opts.inputs)
+    {
+      const fs::path out = fs::path(opts.output_directory) / fs::path(input).filename();
+      if (fs::equivalent(input, out, ec))
+      {
+        std::fprintf(
+            stderr, "%s: the output would overwrite the input\n", input.c_str());
+        return 1;
+      }
+      jobs.push_back({input, out.string()});
+    }
+    if (jobs.empty())
+    {
+      const std::string name{avnd::get_c_name<T>()};
+      jobs.push_back({{}, (fs::path(opts.output_directory) / (name + ".wav")).string()});
+    }
+
+    int threads = opts.jobs > 0 ? opts.jobs : int(std::thread::hardware_concurrency());
+    threads = std::clamp(threads, 1, int(jobs.size()));
+
+    // Each thread takes the next file until there are none left
+    std::atomic_int next_job{0};
+    std::atomic_int failures{0};
+    std::mutex print_mutex;
+    auto worker = [&] {
+      for (int j = next_job++; j < int(jobs.size()); j = next_job++)
+      {
+        const auto& [input, output] = jobs[j];
+        std::string error;
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool ok
+            = opts.double_precision
+                  ? render<double>(input, output, opts, automation, error)
+                  : render<float>(input, output, opts, automation, error);
+        const double elapsed
+            = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        std::lock_guard _{print_mutex};
+        if (ok)
+        {
+          std::printf(
+              "%s -> %s (%.3f s)\n", input.empty() ? "(silence)" : input.c_str(),
+              output.c_str(), elapsed);
+        }
+        else
+        {
+          std::fprintf(stderr, "%s: %s\n", input.c_str(), error.c_str());
+          failures++;
+        }
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; i++)
+      pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+      t.join();
+
+    return failures > 0 ? 1 : 0;
+  }
+};
+
+template <typename T>
+int run(int argc, char** argv)
+{
+  return renderer<T>::run(argc, argv);
+}
+}
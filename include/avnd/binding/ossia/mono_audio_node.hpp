@@ -65,7 +65,11 @@ public:
 
   void run(const ossia::token_request& tk, ossia::exec_state_facade st) noexcept override
   {
+    [[maybe_unused]] avnd::realtime_scope realtime{"ossia"};
+    [[maybe_unused]] avnd::denormal_guard<T> denormals;
     auto [start, frames] = st.timings(tk);
+    [[maybe_unused]] auto load = this->dsp_load.measure(this->impl, frames);
+    [[maybe_unused]] avnd::trace_span span{"process", avnd::get_name<T>()};
 
     if (!this->prepare_run(start, frames))
     {
@@ -5,6 +5,9 @@
 #include <avnd/binding/ossia/port_setup.hpp>
 #include <avnd/binding/ossia/ffts.hpp>
 #include <avnd/binding/ossia/soundfiles.hpp>
+#include <avnd/common/denormals.hpp>
+#include <avnd/common/realtime_check.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/concepts/audio_port.hpp>
 #include <avnd/concepts/gfx.hpp>
 #include <avnd/concepts/midi_port.hpp>
@@ -18,8 +21,11 @@
 #include <avnd/wrappers/controls.hpp>
 #include <avnd/wrappers/controls_double.hpp>
 #include <avnd/wrappers/controls_storage.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
+#include <avnd/wrappers/latency.hpp>
 #include <avnd/wrappers/metadatas.hpp>
 #include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
 #include <avnd/wrappers/widgets.hpp>
 #include <boost/smart_ptr/atomic_shared_ptr.hpp>
 #include <ossia/dataflow/audio_port.hpp>
@@ -207,7 +213,7 @@ public:
 
   [[no_unique_address]] oscr::outlet_storage<T> ossia_outlets;
 
-  [[no_unique_address]] avnd::process_adapter<T> processor;
+  [[no_unique_address]] avnd::process_adapter_for<T> processor;
 
   [[no_unique_address]] avnd::audio_channel_manager<T> channels;
 
@@ -215,6 +221,8 @@ public:
 
   [[no_unique_address]] avnd::control_storage<T> control_buffers;
 
+  [[no_unique_address]] avnd::control_smoothing<T> smoothing;
+
   [[no_unique_address]] avnd::callback_storage<T> callbacks;
 
   [[no_unique_address]] oscr::soundfile_storage<T> soundfiles;
@@ -223,6 +231,14 @@ public:
 
   [[no_unique_address]] controls_queue<T> control;
 
+  // Latency & tail of the processor. ossia nodes have no way to report
+  // a latency to the graph: it is not compensated, but the host can poll
+  // latency.consume_change() from its own thread to know when it changes.
+  avnd::latency_tracker latency;
+
+  // Time spent in run(), readable with dsp_load.stats() from any thread
+  [[no_unique_address]] avnd::dsp_load_tracker<T> dsp_load;
+
   using control_input_values_type
       = avnd::filter_and_apply<controls_type, avnd::control_input_introspection, T>;
   using control_output_values_type
@@ -284,8 +300,8 @@ public:
     }
     (typename info::indices_n{});
   }
-  template <typename Functor, typename M>
-  void process_inputs(Functor& f, avnd::member_iterator<M>&& in)
+  template <typename Functor>
+  void process_inputs(Functor& f, avnd::multi_instance_range auto&& in)
   {
     for (auto& i : in)
       process_inputs(f, i);
@@ -303,8 +319,8 @@ public:
     }
     (typename info::indices_n{});
   }
-  template <typename Functor, typename M>
-  void process_outputs(Functor& f, avnd::member_iterator<M>&& in)
+  template <typename Functor>
+  void process_outputs(Functor& f, avnd::multi_instance_range auto&& in)
   {
     for (auto& i : in)
       process_outputs(f, i);
@@ -425,7 +441,15 @@ public:
     auto& field = avnd::control_input_introspection<T>::template get<N>(
         avnd::get_inputs<T>(this->impl));
 
-    std::swap(field.value, new_value);
+    if constexpr (avnd::parameter_with_update<std::decay_t<decltype(field)>, T>)
+    {
+      // Keeps the state derived from the control up to date
+      avnd::set_control_value(this->impl, field, std::move(new_value));
+    }
+    else
+    {
+      std::swap(field.value, new_value);
+    }
 
     // Mark the control as changed
     this->control.inputs_set.set(N);
@@ -463,8 +487,14 @@ public:
       this->control_buffers.reserve_space(this->impl, this->buffer_size);
     }
 
+    // Setup the ramps of the smooth controls
+    this->smoothing.reserve_space(this->impl, this->buffer_size, this->sample_rate);
+
     // Effect-specific preparation
     avnd::prepare(this->impl, setup_info);
+
+    this->latency.reset(this->impl, this->processor);
+    this->dsp_load.start(this->sample_rate);
   }
 
   void set_channels(ossia::audio_port& port, int channels)
@@ -511,6 +541,8 @@ public:
     // Process messages
     if constexpr (avnd::messages_type<T>::size > 0)
       process_messages();
+
+    this->smoothing.process(this->impl, frames);
     return true;
   }
 
@@ -595,6 +627,7 @@ public:
 
   void process_messages()
   {
+    [[maybe_unused]] avnd::trace_span span{"messages", avnd::get_name<T>()};
     avnd::messages_introspection<T>::for_all([&](auto m) { process_message(m); });
   }
 
@@ -620,6 +653,8 @@ public:
     // Clean up sample-accurate control input ports
     this->control_buffers.clear_inputs(this->impl);
 
+    this->latency.update(this->impl, this->processor);
+
     // Clear control bitsets for UI
     if constexpr (avnd::control_input_introspection<T>::size > 0)
     {
@@ -158,11 +158,21 @@ struct process_before_run
   {
     if (!port.data.get_data().empty())
     {
+      using type = typename Exec_T::processor_type;
       auto& last = port.data.get_data().back().value;
-      from_ossia_value(ctrl, last, ctrl.value);
+      if constexpr (avnd::parameter_with_update<Field, type>)
+      {
+        // Keeps the state derived from the control up to date
+        auto value = ctrl.value;
+        from_ossia_value(ctrl, last, value);
+        avnd::set_control_value(self.impl, ctrl, std::move(value));
+      }
+      else
+      {
+        from_ossia_value(ctrl, last, ctrl.value);
+      }
 
       // Get the index of the control in [0; N[
-      using type = typename Exec_T::processor_type;
       using controls = avnd::control_input_introspection<type>;
       constexpr int control_index = controls::field_index_to_index(idx);
 
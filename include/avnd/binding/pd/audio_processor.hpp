@@ -2,14 +2,21 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
+#include <avnd/binding/pd/configure.hpp>
 #include <avnd/binding/pd/helpers.hpp>
 #include <avnd/binding/pd/init.hpp>
 #include <avnd/binding/pd/messages.hpp>
+#include <avnd/common/denormals.hpp>
+#include <avnd/common/realtime_check.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/common/export.hpp>
 #include <avnd/concepts/object.hpp>
 #include <avnd/introspection/channels.hpp>
 #include <avnd/wrappers/controls.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
 #include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
+#include <avnd/wrappers/symbol_table.hpp>
 #include <cmath>
 #include <m_pd.h>
 
@@ -55,13 +62,24 @@ struct audio_processor
 
   // Our actual code
   avnd::effect_container<T> implementation;
-  avnd::process_adapter<T> processor;
+  avnd::process_adapter_for<T> processor;
+  [[no_unique_address]] avnd::dsp_load_tracker<T> dsp_load;
+  [[no_unique_address]] avnd::control_smoothing<T> smoothing;
 
   std::array<t_int, dsp_input_count> dsp_inputs;
 
   [[no_unique_address]] init_arguments<T> init_setup;
   [[no_unique_address]] messages<T> messages_setup;
 
+  using control_symbols = avnd::symbol_table<avnd::input_introspection<T>>;
+
+  // Called when the class is set up
+  static void init_symbols()
+  {
+    messages<T>::init_symbols();
+    control_symbols::init([](const char* name) { return gensym(name); });
+  }
+
   // we don't use ctor / dtor, because
   // this breaks aggregate-ness...
   void init(int argc, t_atom* argv)
@@ -112,6 +130,8 @@ struct audio_processor
 
     // Allocate buffers if supported
     avnd::prepare(implementation, setup_info);
+    smoothing.reserve_space(implementation, N, rate);
+    dsp_load.start(rate);
 
     // Notify puredata of the dsp execution
     constexpr t_perfroutine perf = +[](t_int* w)
@@ -132,7 +152,11 @@ struct audio_processor
 
   t_int* perform(t_int* w)
   {
+    [[maybe_unused]] avnd::realtime_scope realtime{"pd"};
+    [[maybe_unused]] avnd::denormal_guard<T> denormals;
     const int n = (int)(*++w);
+    [[maybe_unused]] auto load = dsp_load.measure(implementation, n);
+    [[maybe_unused]] avnd::trace_span span{"process", avnd::get_name<T>()};
 
     t_sample** input{};
     if (input_channels > 0)
@@ -154,6 +178,7 @@ struct audio_processor
       }
     }
 
+    smoothing.process(implementation, n);
     processor.process(
         implementation,
         avnd::span<t_sample*>{input, input_channels},
@@ -165,23 +190,23 @@ struct audio_processor
 
   void process_inlet_control(t_symbol* s, int argc, t_atom* argv)
   {
+    [[maybe_unused]] avnd::trace_span span{"control", avnd::get_name<T>()};
+    const int index = control_symbols::find(s);
+    if (index < 0)
+      return;
+
     switch (argv[0].a_type)
     {
       case A_FLOAT:
       {
-        // Note: teeeechnically, one could store a map of string -> {void*,typeid} and then cast...
-        // but most pd externals seem to just do a chain of if() so this is equivalent
         float res = argv[0].a_w.w_float;
-        avnd::for_each_field_ref(
-            implementation.inputs(),
-            [this, s, res]<typename C>(C& ctl)
+        avnd::input_introspection<T>::for_nth(
+            implementation.inputs(), index,
+            [this, res]<typename C>(C& ctl)
             {
               if constexpr (requires { ctl.value = float{}; })
               {
-                if (avnd::get_name<C>() == s->s_name)
-                {
-                  avnd::apply_control(ctl, res);
-                }
+                avnd::apply_control(implementation, ctl, res);
               }
             });
         break;
@@ -191,18 +216,14 @@ struct audio_processor
       {
         // TODO ?
         std::string res = argv[0].a_w.w_symbol->s_name;
-        // thread_local for perf ?
-        avnd::for_each_field_ref(
-            implementation.inputs(),
-            [this, s, &res](auto& ctl)
+        avnd::input_introspection<T>::for_nth(
+            implementation.inputs(), index,
+            [&res](auto& ctl)
             {
               if constexpr (requires { ctl.value = std::string{}; })
               {
-                if (std::string_view{ctl.name()} == s->s_name)
-                {
-                  avnd::apply_control(ctl, std::move(res));
-                  ctl.value = std::move(res);
-                }
+                avnd::apply_control(ctl, std::move(res));
+                ctl.value = std::move(res);
               }
             });
         break;
@@ -296,6 +317,14 @@ audio_processor_metaclass<T>::audio_processor_metaclass()
       = +[](instance* obj, t_symbol* s, int argc, t_atom* argv) -> void
   { obj->process(s, argc, argv); };
 
+  /// Symbols of the messages and controls ///
+  instance::init_symbols();
+
+#if defined(AVND_REALTIME_LOGGER)
+  /// Posting of the realtime logger ///
+  pd::deferred_logger::start();
+#endif
+
   /// Class creation ///
   g_class = class_new(
       symbol_from_name<T>(),
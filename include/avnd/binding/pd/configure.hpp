@@ -1,9 +1,13 @@
 #pragma once
 #include <halp/log.hpp>
+#include <halp/realtime_log.hpp>
 #include <avnd/wrappers/configure.hpp>
 #include <m_pd.h>
 
+#include <mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #if !defined(FMT_PRINTF_H_)
 #include <ostream>
@@ -72,9 +76,101 @@ struct logger
 
 static_assert(avnd::logger<pd::logger>);
 
+#if defined(FMT_PRINTF_H_)
+/**
+ * For the realtime logger, which writes from its own thread.
+ * Pd can only be called from there with sys_lock taken, and the main thread
+ * holds it while it creates and frees the objects, and thus their loggers:
+ * instead, the messages wait in a mailbox which a clock of the main thread empties.
+ */
+struct deferred_logger
+{
+  // Main thread, e.g. in the setup function of a class
+  static void start()
+  {
+    auto& m = mailbox::instance();
+    if (!m.clock)
+    {
+      m.clock = clock_new(&m, (t_method)&mailbox::tick);
+      clock_delay(m.clock, mailbox::interval);
+    }
+  }
+
+  template <typename... T>
+  static void log(fmt::format_string<T...> fmt, T&&... args)
+  {
+    mailbox::instance().push(false, fmt::format(fmt, std::forward<T>(args)...));
+  }
+  template <typename... T>
+  static void error(fmt::format_string<T...> fmt, T&&... args)
+  {
+    mailbox::instance().push(true, fmt::format(fmt, std::forward<T>(args)...));
+  }
+  template <typename... T>
+  static void trace(fmt::format_string<T...> fmt, T&&... args) noexcept { log(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void debug(fmt::format_string<T...> fmt, T&&... args) noexcept { log(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void info(fmt::format_string<T...> fmt, T&&... args) noexcept { log(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void warn(fmt::format_string<T...> fmt, T&&... args) noexcept { error(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void critical(fmt::format_string<T...> fmt, T&&... args) noexcept { error(fmt, std::forward<T>(args)...); }
+
+private:
+  struct mailbox
+  {
+    static constexpr double interval = 20.; // ms
+
+    static mailbox& instance() noexcept
+    {
+      static mailbox m;
+      return m;
+    }
+
+    void push(bool is_error, std::string msg)
+    {
+      std::lock_guard _{mutex};
+      pending.emplace_back(is_error, std::move(msg));
+    }
+
+    static void tick(mailbox* self)
+    {
+      {
+        std::lock_guard _{self->mutex};
+        std::swap(self->pending, self->posting);
+      }
+      for (auto& [is_error, msg] : self->posting)
+      {
+        if (is_error)
+          pd_error(nullptr, "%s", msg.c_str());
+        else
+          post("%s", msg.c_str());
+      }
+      self->posting.clear();
+      clock_delay(self->clock, interval);
+    }
+
+    std::mutex mutex;
+    std::vector<std::pair<bool, std::string>> pending;
+    std::vector<std::pair<bool, std::string>> posting;
+    t_clock* clock{};
+  };
+};
+#else
+struct deferred_logger : logger
+{
+  static void start() { }
+};
+#endif
+
 struct config
 {
+#if defined(AVND_REALTIME_LOGGER)
+  using logger_type = halp::realtime_logger_for<pd::deferred_logger>;
+#else
   using logger_type = pd::logger;
+#endif
 };
 
 }
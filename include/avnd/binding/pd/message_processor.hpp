@@ -2,6 +2,7 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
+#include <avnd/binding/pd/configure.hpp>
 #include <avnd/binding/pd/helpers.hpp>
 #include <avnd/binding/pd/init.hpp>
 #include <avnd/binding/pd/inputs.hpp>
@@ -97,7 +98,7 @@ struct message_processor
       {
         // This is the float that is supposed to go inside the first inlet if any ?
         if constexpr (requires { port.value = 0.f; })
-          avnd::apply_control(port, arg.a_w.w_float);
+          avnd::apply_control(implementation, port, arg.a_w.w_float);
         break;
       }
 
@@ -219,6 +220,14 @@ message_processor_metaclass<T>::message_processor_metaclass()
       = +[](instance* obj, t_symbol* s, int argc, t_atom* argv) -> void
   { obj->process(s, argc, argv); };
 
+  /// Symbols of the messages ///
+  messages<T>::init_symbols();
+
+#if defined(AVND_REALTIME_LOGGER)
+  /// Posting of the realtime logger ///
+  pd::deferred_logger::start();
+#endif
+
   /// Class creation ///
   g_class = class_new(
       symbol_from_name<T>(),
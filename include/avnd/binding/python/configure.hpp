@@ -1,5 +1,6 @@
 #pragma once
 #include <halp/log.hpp>
+#include <halp/realtime_log.hpp>
 #include <avnd/wrappers/configure.hpp>
 
 #include <utility>
@@ -8,7 +9,7 @@ namespace python
 {
 struct config
 {
-  using logger_type = halp::basic_logger;
+  using logger_type = halp::realtime_logger_for<halp::basic_logger>;
 };
 
 }
@@ -4,9 +4,12 @@
 
 #include <avnd/binding/vintage/helpers.hpp>
 #include <avnd/binding/vintage/vintage.hpp>
+#include <avnd/common/atomic_bitset.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/introspection/input.hpp>
 #include <avnd/wrappers/control_display.hpp>
 #include <avnd/wrappers/controls.hpp>
+#include <avnd/wrappers/metadatas.hpp>
 #if __has_include(<fmt/format.h>)
 #include <fmt/format.h>
 #else
@@ -52,6 +55,11 @@ requires(avnd::parameter_input_introspection<T>::size > 0) struct Controls<T>
   static const constexpr int32_t parameter_count = inputs_info_t::size;
   std::atomic<float> parameters[std::max(parameter_count, 1)];
 
+  // Parameters set since the last write, which are the only ones to convert
+  avnd::atomic_bitset<parameter_count> changed;
+
+  Controls() noexcept { changed.set_all(); }
+
   template <typename Effect_T>
   void init(Effect_T& effect)
   {
@@ -61,7 +69,10 @@ requires(avnd::parameter_input_introspection<T>::size > 0) struct Controls<T>
       auto& self = *static_cast<Effect_T*>(effect);
 
       if (index < Controls<T>::parameter_count)
-        self.controls.parameters[index].store(parameter, std::memory_order_release);
+      {
+        self.controls.parameters[index].store(parameter, std::memory_order_relaxed);
+        self.controls.changed.set(index);
+      }
     };
 
     effect.Effect::getParameter = [](Effect* effect, int32_t index) noexcept
@@ -88,24 +99,28 @@ requires(avnd::parameter_input_introspection<T>::size > 0) struct Controls<T>
     }
     (std::make_index_sequence<parameter_count>());
 
-    std::atomic_thread_fence(std::memory_order_release);
+    changed.set_all();
   }
 
   void write(avnd::effect_container<T>& implementation)
   {
-    std::atomic_thread_fence(std::memory_order_acquire);
+    [[maybe_unused]] avnd::trace_span span{"control", avnd::get_name<T>()};
 
-    [ this, &implementation ]<std::size_t... Index>(
-        std::integer_sequence<std::size_t, Index...>)
-    {
-      auto& source = this->parameters;
-      auto& sink = implementation.inputs();
-      ((inputs_info_t::template get<Index>(sink).value
-        = avnd::map_control_from_01<typename inputs_info_t::template nth_element<Index>>(
-            source[Index].load(std::memory_order_relaxed))),
-       ...);
-    }
-    (std::make_index_sequence<parameter_count>());
+    changed.consume(
+        [this, &implementation](std::size_t index)
+        {
+          inputs_info_t::for_nth_mapped(
+              implementation.inputs(),
+              int(index),
+              [this, index, &implementation]<typename C>(C& field)
+              {
+                avnd::set_control_value(
+                    implementation,
+                    field,
+                    avnd::map_control_from_01<C>(
+                        this->parameters[index].load(std::memory_order_relaxed)));
+              });
+        });
   }
 
   template <typename Effect_T>
@@ -9,10 +9,18 @@
 #include <avnd/binding/vintage/processor_setup.hpp>
 #include <avnd/binding/vintage/programs.hpp>
 #include <avnd/binding/vintage/vintage.hpp>
+#include <avnd/common/denormals.hpp>
+#include <avnd/common/realtime_check.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/common/export.hpp>
 #include <avnd/introspection/channels.hpp>
 #include <avnd/wrappers/controls.hpp>
+#include <avnd/wrappers/controls_storage.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
+#include <avnd/wrappers/latency.hpp>
+#include <avnd/wrappers/parallel_channels.hpp>
 #include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
 
 namespace vintage
 {
@@ -38,12 +46,20 @@ struct SimpleAudioEffect : vintage::Effect
 
   [[no_unique_address]] ProcessorSetup processorSetup;
 
-  [[no_unique_address]] process_adapter<T> processor;
+  [[no_unique_address]] process_adapter_for<T> processor;
 
   [[no_unique_address]] programs_setup programs;
 
   [[no_unique_address]] midi_processor<T> midi;
 
+  [[no_unique_address]] avnd::control_storage<T> control_buffers;
+
+  [[no_unique_address]] avnd::control_smoothing<T> smoothing;
+
+  avnd::latency_tracker latency;
+  [[no_unique_address]] avnd::dsp_load_tracker<T> dsp_load;
+  avnd::parallel_channels_pool<T> parallel_channels;
+
   float sample_rate{44100.};
   int buffer_size{512};
   vintage::ProcessPrecision precision = avnd::double_processor<T>
@@ -131,8 +147,34 @@ struct SimpleAudioEffect : vintage::Effect
       midi.reserve_space(this->effect, buffer_size);
     }
 
+    // Setup buffers for storing sample-accurate controls
+    if constexpr (sizeof(control_buffers) > 1)
+    {
+      control_buffers.reserve_space(effect, buffer_size);
+    }
+
+    // Setup the ramps of the smooth controls
+    smoothing.reserve_space(effect, buffer_size, sample_rate);
+
     // Effect-specific preparation
     avnd::prepare(effect, setup_info);
+
+    latency.reset(effect, processor);
+    dsp_load.start(sample_rate);
+    Effect::initialDelay = latency.latency;
+
+    parallel_channels.start(processor, setup_info.output_channels);
+  }
+
+  // Tells the host that the latency changed during processing.
+  // Called from the dispatcher, thus not from the audio thread.
+  void notify_latency_change()
+  {
+    if (latency.consume_change())
+    {
+      Effect::initialDelay = latency.latency;
+      request(HostOpcodes::IOChanged, 0, 0, nullptr, 0.f);
+    }
   }
 
   ~SimpleAudioEffect() { }
@@ -150,6 +192,11 @@ struct SimpleAudioEffect : vintage::Effect
       std::floating_point auto** outputs,
       int32_t sampleFrames)
   {
+    [[maybe_unused]] avnd::realtime_scope realtime{"vintage"};
+    [[maybe_unused]] avnd::denormal_guard<T> denormals;
+    [[maybe_unused]] auto load = dsp_load.measure(effect, sampleFrames);
+    [[maybe_unused]] avnd::trace_span span{"process", avnd::get_name<T>()};
+
     // Check if processing is to be bypassed
     if constexpr (avnd::can_bypass<T>)
     {
@@ -158,11 +205,13 @@ struct SimpleAudioEffect : vintage::Effect
           return;
     }
 
-    // Clear our midi outputs
+    // Clear our midi and sample-accurate control outputs
     midi.clear_outputs(effect);
+    control_buffers.clear_outputs(effect);
 
-    // Before processing starts, we copy all our atomics back into the struct
+    // Before processing starts, we copy the atomics changed since the last block into the struct
     controls.write(effect);
+    smoothing.process(effect, sampleFrames);
 
     // Actual processing
     using fp_t = std::decay_t<decltype(inputs[0][0])>;
@@ -172,20 +221,25 @@ struct SimpleAudioEffect : vintage::Effect
         avnd::span<fp_t*>{outputs, std::size_t(this->Effect::numOutputs)},
         sampleFrames);
 
-    // Clear our midi inputs
+    // Clear our midi and sample-accurate control inputs
     midi.clear_inputs(effect);
+    control_buffers.clear_inputs(effect);
+
+    latency.update(effect, processor);
   }
 
+  // Called from the audio thread, before process()
   void event_input(const vintage::Events* evs)
   {
+    [[maybe_unused]] avnd::realtime_scope realtime{"vintage"};
+
     if constexpr (midi_input_introspection<T>::size > 0)
     {
       using i_info = avnd::midi_input_introspection<T>;
       auto& in_port = avnd::pfr::get<i_info::index_map[0]>(effect.inputs());
 
-      // In case we need to allocate more storage:
+      // The storage was reserved in setup: the events past its capacity are dropped
       const int n = evs->numEvents;
-      midi.reserve_space(this->effect, n);
 
       for (int32_t i = 0; i < n; i++)
       {
@@ -223,6 +277,10 @@ struct SimpleAudioEffect : vintage::Effect
       return 1;
     }
 
+    // Events are sent from the audio thread
+    if (code != EffectOpcodes::ProcessEvents)
+      self.notify_latency_change();
+
     // If our plug-in has a custom dispatching implementation, then we can use it
     if constexpr (vintage::can_dispatch<T>)
     {
@@ -6,9 +6,11 @@
 #include <avnd/binding/vintage/vintage.hpp>
 #include <avnd/introspection/input.hpp>
 #include <avnd/wrappers/avnd.hpp>
+#include <avnd/wrappers/latency.hpp>
 #include <avnd/wrappers/metadatas.hpp>
 
 #include <array>
+#include <limits>
 
 namespace vintage
 {
@@ -114,8 +116,9 @@ intptr_t default_dispatch(
         if (value >= 0 && value < std::ssize(effect_type::programs))
         {
           object.current_program = value;
+          // Marks the controls of the program as changed:
+          // the audio thread applies them before the next block.
           object.controls.read(effect_type::programs[value].parameters);
-          object.controls.write(container);
           object.request(HostOpcodes::UpdateDisplay, 0, 0, nullptr, 0.f);
         }
       }
@@ -274,6 +277,14 @@ intptr_t default_dispatch(
       }
       return 1;
     }
+    case EffectOpcodes::GetTailSize: // 52
+    {
+      // 0 means "default" here, 1 means no tail
+      const uint32_t tail = avnd::get_tail(container);
+      if (tail == 0)
+        return 1;
+      return std::min(tail, uint32_t(std::numeric_limits<int32_t>::max()));
+    }
     case EffectOpcodes::GetVendorVersion: // 49
     {
       return avnd::get_int_version<effect_type>();
@@ -6,11 +6,25 @@
 #include <avnd/concepts/all.hpp>
 #include <avnd/introspection/midi.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace vintage
 {
 template <typename T>
 struct midi_processor : public avnd::midi_storage<T>
 {
+  // Messages received past the capacity reserved when starting are dropped,
+  // so that nothing is allocated in the audio thread.
+  static constexpr int minimum_capacity = 1024;
+  int capacity{};
+
+  void reserve_space(avnd::effect_container<T>& t, int buffer_size)
+  {
+    capacity = std::max(buffer_size, minimum_capacity);
+    avnd::midi_storage<T>::reserve_space(t, capacity);
+  }
+
   void
   init_midi_message(avnd::dynamic_midi_message auto& in, const vintage::MidiEvent& msg)
   {
@@ -38,6 +52,9 @@ struct midi_processor : public avnd::midi_storage<T>
       avnd::dynamic_container_midi_port auto& port,
       const vintage::MidiEvent& msg)
   {
+    if (port.midi_messages.size() >= std::size_t(capacity))
+      return;
+
     port.midi_messages.push_back({});
     auto& elt = port.midi_messages.back();
     init_midi_message(elt, msg);
@@ -46,6 +63,9 @@ struct midi_processor : public avnd::midi_storage<T>
   void
   add_message(avnd::raw_container_midi_port auto& port, const vintage::MidiEvent& msg)
   {
+    if (port.size >= capacity)
+      return;
+
     auto& elt = port.midi_messages[port.size];
     init_midi_message(elt, msg);
 
@@ -207,7 +207,7 @@ struct PolyphonicSynthesizer : vintage::Effect
         return;
     }
 
-    // Before processing starts, we copy all our atomics back into the struct
+    // Before processing starts, we copy the atomics changed since the last block into the struct
     controls.write(implementation);
 
     // Clear buffer
@@ -24,7 +24,8 @@ struct SynthControls : Controls<T>
         switch (index)
         {
           default:
-            self.controls.parameters[index].store(parameter, std::memory_order_release);
+            self.controls.parameters[index].store(parameter, std::memory_order_relaxed);
+            self.controls.changed.set(index);
             break;
           case Controls<T>::parameter_count:
             self.controls.unison_voices.store(parameter, std::memory_order_release);
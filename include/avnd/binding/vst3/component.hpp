@@ -6,11 +6,20 @@
 #include <avnd/binding/vst3/component_base.hpp>
 #include <avnd/binding/vst3/helpers.hpp>
 #include <avnd/binding/vst3/refcount.hpp>
+#include <avnd/common/denormals.hpp>
+#include <avnd/common/realtime_check.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/introspection/input.hpp>
 #include <avnd/introspection/midi.hpp>
 #include <avnd/introspection/output.hpp>
 #include <avnd/wrappers/controls.hpp>
+#include <avnd/wrappers/controls_storage.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
+#include <avnd/wrappers/latency.hpp>
+#include <avnd/wrappers/parallel_channels.hpp>
 #include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
+#include <avnd/wrappers/sub_block_process_adapter.hpp>
 
 namespace stv3
 {
@@ -72,14 +81,24 @@ struct Component final
 
   avnd::effect_container<T> effect;
 
-  [[no_unique_address]] avnd::process_adapter<T> processor;
+  [[no_unique_address]] avnd::process_adapter_for<T> processor;
 
   [[no_unique_address]] avnd::midi_storage<T> midi;
 
+  [[no_unique_address]] avnd::control_storage<T> control_buffers;
+
+  [[no_unique_address]] avnd::parameter_change_queue<T> parameter_changes;
+
+  [[no_unique_address]] avnd::control_smoothing<T> smoothing;
+
   [[no_unique_address]] stv3::audio_bus_info<T> audio_busses;
 
   [[no_unique_address]] stv3::event_bus_info<T> event_busses;
 
+  avnd::latency_tracker latency;
+  [[no_unique_address]] avnd::dsp_load_tracker<T> dsp_load;
+  avnd::parallel_channels_pool<T> parallel_channels;
+
   using inputs_info_t = avnd::parameter_input_introspection<T>;
   static const constexpr int32_t parameter_count = inputs_info_t::size;
 
@@ -325,29 +344,95 @@ struct Component final
       midi.reserve_space(this->effect, newSetup.maxSamplesPerBlock);
     }
 
+    // Setup buffers for storing sample-accurate controls
+    if constexpr (sizeof(control_buffers) > 1)
+    {
+      control_buffers.reserve_space(effect, newSetup.maxSamplesPerBlock);
+    }
+
+    // Setup the queue of the automation points when the blocks are split at them
+    if constexpr (avnd::parameter_change_queue<T>::enabled)
+    {
+      parameter_changes.reserve_space(newSetup.maxSamplesPerBlock + 4 * parameter_count);
+    }
+
+    // Setup the ramps of the smooth controls
+    smoothing.reserve_space(effect, newSetup.maxSamplesPerBlock, newSetup.sampleRate);
+
     // Effect-specific preparation
     avnd::prepare(effect, setup_info);
+
+    // The host asks for the latency after this
+    latency.reset(effect, processor);
+    dsp_load.start(newSetup.sampleRate);
+
+    parallel_channels.start(processor, setup_info.output_channels);
     return kResultOk;
   }
 
-  void processControl(IParamValueQueue& queue)
+  void applyParameter(int id, ParamValue value)
+  {
+    inputs_info_t::for_nth_raw(
+        effect.inputs(),
+        id,
+        [&]<typename C>(C& ctl) {
+          avnd::set_control_value(effect, ctl, avnd::map_control_from_01<C>(value));
+        });
+  }
+
+  // All the points of the queue are used for the sample-accurate controls,
+  // and for the processors which split their blocks at the changes.
+  // Otherwise only the last one is.
+  void processControl(IParamValueQueue& queue, int32 frames)
   {
     ParamValue value;
     int32 sampleOffset;
-    int32 numPoints = queue.getPointCount();
+    const int32 numPoints = queue.getPointCount();
+    if (numPoints <= 0)
+      return;
 
-    int id = queue.getParameterId();
-    if (queue.getPoint(numPoints - 1, sampleOffset, value) == Steinberg::kResultTrue)
-    {
-      avnd::parameter_input_introspection<T>::for_nth_raw(
-          effect.inputs(),
-          id,
-          [&]<typename C>(C& ctl) { ctl.value = avnd::map_control_from_01<C>(value); });
+    const int id = queue.getParameterId();
+    const auto frame = [frames](int32 offset) {
+      return std::clamp(int(offset), 0, std::max(0, int(frames) - 1));
     };
+
+    inputs_info_t::for_nth_raw(
+        id,
+        [&]<std::size_t Idx, typename C>(avnd::field_reflection<Idx, C>) {
+          if constexpr (avnd::sample_accurate_parameter<C>)
+          {
+            for (int32 p = 0; p < numPoints; p++)
+            {
+              if (queue.getPoint(p, sampleOffset, value) == Steinberg::kResultTrue)
+              {
+                control_buffers.push_input(
+                    effect, avnd::field_index<Idx>{}, frame(sampleOffset),
+                    avnd::map_control_from_01<C>(value));
+              }
+            }
+          }
+          else if constexpr (avnd::parameter_change_queue<T>::enabled)
+          {
+            for (int32 p = 0; p < numPoints; p++)
+            {
+              if (queue.getPoint(p, sampleOffset, value) == Steinberg::kResultTrue)
+              {
+                if (!parameter_changes.push(frame(sampleOffset), id, value))
+                  applyParameter(id, value);
+              }
+            }
+            return;
+          }
+
+          // The value at the end of the block
+          if (queue.getPoint(numPoints - 1, sampleOffset, value) == Steinberg::kResultTrue)
+            applyParameter(id, value);
+        });
   }
 
   void processControls(ProcessData& data)
   {
+    [[maybe_unused]] avnd::trace_span span{"control", avnd::get_name<T>()};
     using namespace Steinberg;
     using namespace Steinberg::Vst;
 
@@ -359,7 +444,7 @@ struct Component final
       {
         if (auto q = paramChanges->getParameterData(i))
         {
-          processControl(*q);
+          processControl(*q, data.numSamples);
         }
       }
     }
@@ -474,6 +559,43 @@ struct Component final
     }
   }
 
+  template <typename FP>
+  void processBlock(ProcessData& data, FP** in, FP** out)
+  {
+    const int32 input_channels = data.inputs[0].numChannels;
+    const int32 output_channels = data.outputs[0].numChannels;
+    if constexpr (avnd::parameter_change_queue<T>::enabled)
+    {
+      // Split at the automation points: the offset channel pointers live on the stack
+      auto in_ptrs = (FP**)alloca(sizeof(FP*) * (1 + input_channels));
+      auto out_ptrs = (FP**)alloca(sizeof(FP*) * (1 + output_channels));
+
+      parameter_changes.process(
+          data.numSamples, avnd::minimum_sub_block_frames<T>(),
+          [this](const auto& change) { applyParameter(change.index, change.value); },
+          [&](int start, int frames)
+          {
+            // The ramps go towards the values of this sub-block
+            smoothing.process(effect, frames);
+
+            for (int c = 0; c < input_channels; c++)
+              in_ptrs[c] = in[c] ? in[c] + start : nullptr;
+            for (int c = 0; c < output_channels; c++)
+              out_ptrs[c] = out[c] ? out[c] + start : nullptr;
+
+            processor.process(
+                effect, avnd::span<FP*>{in_ptrs, std::size_t(input_channels)},
+                avnd::span<FP*>{out_ptrs, std::size_t(output_channels)}, frames);
+          });
+    }
+    else
+    {
+      processor.process(
+          effect, avnd::span<FP*>{in, std::size_t(input_channels)},
+          avnd::span<FP*>{out, std::size_t(output_channels)}, data.numSamples);
+    }
+  }
+
   void processAudio(ProcessData& data)
   {
     using namespace Steinberg;
@@ -484,25 +606,18 @@ struct Component final
     auto in = stv3::getChannelBuffersPointer(processSetup, data.inputs[0]);
     auto out = stv3::getChannelBuffersPointer(processSetup, data.outputs[0]);
 
-    data.outputs[0].silenceFlags = 0;
     if (data.symbolicSampleSize == kSample32)
-    {
-      processor.process(
-          effect,
-          avnd::span<Sample32*>{(Sample32**)in, std::size_t(data.inputs[0].numChannels)},
-          avnd::span<Sample32*>{
-              (Sample32**)out, std::size_t(data.outputs[0].numChannels)},
-          data.numSamples);
-    }
+      processBlock(data, (Sample32**)in, (Sample32**)out);
     else
-    {
-      processor.process(
-          effect,
-          avnd::span<Sample64*>{(Sample64**)in, std::size_t(data.inputs[0].numChannels)},
-          avnd::span<Sample64*>{
-              (Sample64**)out, std::size_t(data.outputs[0].numChannels)},
-          data.numSamples);
-    }
+      processBlock(data, (Sample64**)in, (Sample64**)out);
+
+    // Lets the host skip the processing downstream
+    const int32 channels = data.outputs[0].numChannels;
+    if (avnd::output_silent(processor) && channels > 0)
+      data.outputs[0].silenceFlags
+          = channels >= 64 ? ~uint64(0) : (uint64(1) << channels) - 1;
+    else
+      data.outputs[0].silenceFlags = 0;
   }
 
   void processOutputs(ProcessData& data)
@@ -516,21 +631,39 @@ struct Component final
   {
     using namespace Steinberg;
     using namespace Steinberg::Vst;
+    [[maybe_unused]] avnd::realtime_scope realtime{"vst3"};
+    [[maybe_unused]] avnd::denormal_guard<T> denormals;
+    [[maybe_unused]] auto load = dsp_load.measure(effect, data.numSamples);
+    [[maybe_unused]] avnd::trace_span span{"process", avnd::get_name<T>()};
 
     // Clear outputs
     this->midi.clear_outputs(effect);
+    this->control_buffers.clear_outputs(effect);
 
     processControls(data);
     processEvents(data);
+    if constexpr (!avnd::parameter_change_queue<T>::enabled)
+      smoothing.process(effect, data.numSamples);
 
     if (data.numInputs != 0 && data.numOutputs != 0)
     {
       processAudio(data);
       processOutputs(data);
     }
+    else if constexpr (avnd::parameter_change_queue<T>::enabled)
+    {
+      // Parameter flush: without buses the changes would stay queued
+      parameter_changes.flush(
+          [this](const auto& change) { applyParameter(change.index, change.value); });
+    }
 
     // Clear inputs
     this->midi.clear_inputs(effect);
+    this->control_buffers.clear_inputs(effect);
+
+    // Changes are sent to the controller through the host, see latency_parameter_id
+    latency.update(effect, processor);
+    notifyLatencyChange(data);
 
     return kResultOk;
   }
@@ -554,7 +687,8 @@ struct Component final
             double param = 0.f;
             if (streamer.readDouble(param) == false)
               return false;
-            field.value = avnd::map_control_from_01<C>(param);
+            // Keeps the state derived from the controls up to date
+            avnd::set_control_value(this->effect, field, avnd::map_control_from_01<C>(param));
             return true;
           });
 
@@ -598,7 +732,28 @@ struct Component final
     return Steinberg::kResultTrue;
   }
 
-  uint32 getLatencySamples() override { return 0; }
+  uint32 getLatencySamples() override { return avnd::get_latency(effect, processor); }
+
+  // Tells the controller that the latency changed during processing,
+  // so that it restarts the component: the value of the hidden parameter
+  // is the new latency and tail, see encode_latency_parameter.
+  void notifyLatencyChange(ProcessData& data)
+  {
+    if constexpr (avnd::has_latency<T> || avnd::has_tail<T>)
+    {
+      if (!data.outputParameterChanges || !latency.consume_change())
+        return;
+
+      int32 index{};
+      if (auto queue
+          = data.outputParameterChanges->addParameterData(latency_parameter_id, index))
+      {
+        int32 point{};
+        queue->addPoint(
+            0, stv3::encode_latency_parameter(latency.latency, latency.tail), point);
+      }
+    }
+  }
 
   tresult setProcessing(TBool state) override
   {
@@ -609,7 +764,10 @@ struct Component final
   uint32 getTailSamples() override
   {
     using namespace Steinberg::Vst;
-    return kNoTail;
+    const uint32_t tail = avnd::get_tail(effect);
+    if (tail == avnd::infinite_tail)
+      return kInfiniteTail;
+    return tail;
   }
 
   Steinberg::tresult setActive(Steinberg::TBool state) override
@@ -8,6 +8,7 @@
 #include <avnd/wrappers/control_display.hpp>
 #include <avnd/wrappers/controls.hpp>
 #include <avnd/wrappers/controls_fp.hpp>
+#include <avnd/wrappers/latency.hpp>
 #include <avnd/wrappers/widgets.hpp>
 #include <cmath>
 #include <pluginterfaces/vst/ivstmidicontrollers.h>
@@ -65,15 +66,36 @@ class Controller final
   using inputs_info_t = avnd::parameter_input_introspection<T>;
   static const constexpr int32_t parameter_count = inputs_info_t::size;
 
+  // See latency_parameter_id
+  static const constexpr bool reports_latency_changes
+      = avnd::has_latency<T> || avnd::has_tail<T>;
+  // Last value of the latency parameter: the component is only restarted when it changes
+  ParamValue latency_value{};
+
 public:
   Controller() { }
 
   virtual ~Controller();
 
-  int32 getParameterCount() override { return inputs_info_t::size; }
+  int32 getParameterCount() override
+  {
+    return inputs_info_t::size + (reports_latency_changes ? 1 : 0);
+  }
 
   Steinberg::tresult getParameterInfo(int32 paramIndex, ParameterInfo& info) override
   {
+    if (reports_latency_changes && paramIndex == inputs_info_t::size)
+    {
+      info = {};
+      info.id = latency_parameter_id;
+      setStr(info.title, "Latency");
+      setStr(info.shortTitle, "Latency");
+      info.stepCount = 1;
+      info.unitId = 1;
+      info.flags = ParameterInfo::kIsReadOnly | ParameterInfo::kIsHidden;
+      return Steinberg::kResultTrue;
+    }
+
     if (paramIndex < 0 || paramIndex >= inputs_info_t::size)
       return Steinberg::kInvalidArgument;
 
@@ -136,6 +158,9 @@ public:
 
   ParamValue getParamNormalized(ParamID tag) override
   {
+    if (reports_latency_changes && tag == latency_parameter_id)
+      return latency_value;
+
     ParamValue res{};
 
     if constexpr (avnd::has_inputs<T>)
@@ -150,6 +175,16 @@ public:
 
   Steinberg::tresult setParamNormalized(ParamID tag, ParamValue value) override
   {
+    if (reports_latency_changes && tag == latency_parameter_id)
+    {
+      if (value != latency_value)
+      {
+        latency_value = value;
+        latencyChanged();
+      }
+      return Steinberg::kResultTrue;
+    }
+
     if (tag < 0 || tag >= inputs_info_t::size)
       return Steinberg::kInvalidArgument;
 
@@ -159,7 +194,7 @@ public:
           this->inputs_mirror,
           tag,
           [&]<typename C>(C& field)
-          { field.value = avnd::map_control_from_01<C>(value); });
+          { avnd::set_control_value(field, avnd::map_control_from_01<C>(value)); });
     }
 
     return Steinberg::kResultTrue;
@@ -185,7 +220,7 @@ public:
             double param = 0.f;
             if (streamer.readDouble(param) == false)
               return false;
-            field.value = avnd::map_control_from_01<C>(param);
+            avnd::set_control_value(field, avnd::map_control_from_01<C>(param));
             return true;
           });
 
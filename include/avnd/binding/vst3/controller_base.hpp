@@ -99,6 +99,14 @@ public:
     return Steinberg::kResultTrue;
   }
 
+  // Called when the component reports a change of its latency or tail
+  virtual void latencyChanged()
+  {
+    using namespace Steinberg::Vst;
+    if (componentHandler)
+      componentHandler->restartComponent(kLatencyChanged | kIoChanged);
+  }
+
   Steinberg::IPlugView* createView(const char* name) override { return nullptr; }
 
   Steinberg::tresult setKnobMode(Steinberg::Vst::KnobMode mode) override
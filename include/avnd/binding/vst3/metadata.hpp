@@ -6,6 +6,7 @@
 #include <pluginterfaces/base/funknown.h>
 #include <pluginterfaces/vst/vsttypes.h>
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdint>
 #include <exception>
@@ -23,6 +24,31 @@ using uint8 = Steinberg::uint8;
 using uint16 = Steinberg::uint16;
 using uint32 = Steinberg::uint32;
 using tresult = Steinberg::tresult;
+
+/**
+ * Hidden read-only parameter through which the component tells the controller
+ * that its latency or tail changed during processing: the host forwards
+ * the output parameter changes to the controller, outside of the audio thread.
+ *
+ * Its value encodes the latency and the tail, see encode_latency_parameter,
+ * so that the controller can ignore the values it already knows about,
+ * e.g. when the host restores its state or echoes it.
+ */
+static constexpr Steinberg::Vst::ParamID latency_parameter_id = 0x7fff0000;
+
+/**
+ * 24 bits of latency and 28 bits of tail, clamped, in a double in [0; 1]:
+ * the encoding is exact as both fit in the mantissa.
+ */
+inline double encode_latency_parameter(int latency, uint32_t tail) noexcept
+{
+  constexpr int64_t max_latency = (int64_t(1) << 24) - 1;
+  constexpr int64_t max_tail = (int64_t(1) << 28) - 1;
+  const int64_t l = std::clamp(int64_t(latency), int64_t(0), max_latency);
+  const int64_t t = std::min(int64_t(tail), max_tail);
+  return double((l << 28) | t) / double(int64_t(1) << 52);
+}
+
 struct UnionID
 {
   union
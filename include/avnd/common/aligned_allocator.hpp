@@ -0,0 +1,66 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <cstddef>
+#include <new>
+
+namespace avnd
+{
+// Alignment used for the audio buffers allocated by the wrappers:
+// one cache line, which is also enough for AVX-512 loads & stores.
+static constexpr std::size_t audio_buffer_alignment = 64;
+
+/**
+ * Allocator for std::vector & friends which aligns the storage
+ * on a given boundary.
+ */
+template <typename T, std::size_t Alignment = audio_buffer_alignment>
+struct aligned_allocator
+{
+  static_assert(Alignment >= alignof(T));
+
+  using value_type = T;
+
+  template <typename U>
+  struct rebind
+  {
+    using other = aligned_allocator<U, Alignment>;
+  };
+
+  constexpr aligned_allocator() noexcept = default;
+
+  template <typename U>
+  constexpr aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept
+  {
+  }
+
+  [[nodiscard]] T* allocate(std::size_t n)
+  {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept
+  {
+    ::operator delete(p, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  constexpr bool operator==(const aligned_allocator<U, Alignment>&) const noexcept
+  {
+    return true;
+  }
+};
+
+/**
+ * Rounds a number of samples up so that consecutive channels
+ * stored in a single aligned buffer all start on an aligned boundary.
+ */
+template <typename T>
+constexpr int aligned_channel_stride(int frames) noexcept
+{
+  constexpr int per_line = audio_buffer_alignment / sizeof(T);
+  return ((frames + per_line - 1) / per_line) * per_line;
+}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace avnd
+{
+/**
+ * A fixed set of flags which any thread can raise, and which one thread
+ * consumes, without locks: e.g. the parameters changed by the host
+ * since the last process call.
+ *
+ * The writes done before set(i) are visible to the consumer of flag i.
+ */
+template <std::size_t N>
+struct atomic_bitset
+{
+  static constexpr std::size_t word_bits = 64;
+  static constexpr std::size_t word_count = (N + word_bits - 1) / word_bits;
+
+  void set(std::size_t i) noexcept
+  {
+    m_words[i / word_bits].fetch_or(
+        std::uint64_t(1) << (i % word_bits), std::memory_order_release);
+  }
+
+  void set_all() noexcept
+  {
+    for (std::size_t w = 0; w < word_count; w++)
+      m_words[w].fetch_or(mask(w), std::memory_order_release);
+  }
+
+  bool any() const noexcept
+  {
+    for (std::size_t w = 0; w < word_count; w++)
+      if (m_words[w].load(std::memory_order_relaxed) != 0)
+        return true;
+    return false;
+  }
+
+  // Calls f(i) for each raised flag, in increasing order, and lowers them
+  template <typename F>
+  void consume(F&& f) noexcept(noexcept(f(std::size_t{})))
+  {
+    for (std::size_t w = 0; w < word_count; w++)
+    {
+      // Plain load first: no read-modify-write for the words without changes
+      if (m_words[w].load(std::memory_order_relaxed) == 0)
+        continue;
+
+      auto bits = m_words[w].exchange(0, std::memory_order_acquire);
+      while (bits != 0)
+      {
+        f(w * word_bits + std::countr_zero(bits));
+        bits &= bits - 1;
+      }
+    }
+  }
+
+private:
+  static constexpr std::uint64_t mask(std::size_t w) noexcept
+  {
+    const std::size_t bits = (w + 1) * word_bits <= N ? word_bits : N % word_bits;
+    return bits == word_bits ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+  }
+
+  std::atomic<std::uint64_t> m_words[word_count]{};
+};
+}
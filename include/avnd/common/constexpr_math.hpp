@@ -0,0 +1,100 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <limits>
+
+/**
+ * The few transcendental functions needed to compute tables at compile time,
+ * as the ones of <cmath> are not constexpr before C++26.
+ *
+ * They are accurate to a few ulps over the ranges used for the parameter
+ * mappings; they are not meant for the audio processing itself.
+ */
+namespace avnd::constexpr_math
+{
+inline constexpr double ln2 = 0.693147180559945309417232121458176568;
+inline constexpr double ln10 = 2.302585092994045684017991454684364208;
+
+constexpr double exp(double x) noexcept
+{
+  if (x != x)
+    return x;
+  if (x > 709.)
+    return std::numeric_limits<double>::infinity();
+  if (x < -745.)
+    return 0.;
+
+  // x = k * ln(2) + r, with |r| <= ln(2) / 2
+  const int k = int(x / ln2 + (x < 0 ? -0.5 : 0.5));
+  const double r = x - k * ln2;
+
+  double sum = 1., term = 1.;
+  for (int n = 1; n < 24; n++)
+  {
+    term *= r / n;
+    sum += term;
+  }
+
+  if (k > 0)
+    for (int i = 0; i < k; i++)
+      sum *= 2.;
+  else
+    for (int i = 0; i < -k; i++)
+      sum *= 0.5;
+  return sum;
+}
+
+constexpr double log(double x) noexcept
+{
+  if (x != x || x < 0.)
+    return std::numeric_limits<double>::quiet_NaN();
+  if (x == 0.)
+    return -std::numeric_limits<double>::infinity();
+  if (x == std::numeric_limits<double>::infinity())
+    return x;
+
+  // x = m * 2^e, with m in [1; 2)
+  int e = 0;
+  while (x >= 2.)
+  {
+    x *= 0.5;
+    e++;
+  }
+  while (x < 1.)
+  {
+    x *= 2.;
+    e--;
+  }
+
+  // log(m) = 2 * atanh(s), with s = (m - 1) / (m + 1) in [0; 1/3)
+  const double s = (x - 1.) / (x + 1.);
+  const double s2 = s * s;
+  double sum = 0., term = s;
+  for (int n = 1; n < 64; n += 2)
+  {
+    sum += term / n;
+    term *= s2;
+  }
+  return 2. * sum + e * ln2;
+}
+
+constexpr double pow(double x, double y) noexcept
+{
+  if (y == 0.)
+    return 1.;
+  if (x == 0.)
+    return y > 0. ? 0. : std::numeric_limits<double>::infinity();
+  return exp(y * log(x));
+}
+
+constexpr double pow10(double x) noexcept
+{
+  return exp(x * ln10);
+}
+
+constexpr double log10(double x) noexcept
+{
+  return log(x) / ln10;
+}
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AVND_CONVERT_SAMPLES_SSE2 1
+#include <immintrin.h>
+#endif
+#if defined(__AVX__)
+// We are already building for AVX: no need to check at run-time
+#define AVND_CONVERT_SAMPLES_AVX 1
+#define AVND_CONVERT_SAMPLES_AVX_TARGET
+#elif defined(__GNUC__) && defined(AVND_CONVERT_SAMPLES_SSE2)
+// Build the AVX kernels anyways and check at run-time whether we can use them
+#define AVND_CONVERT_SAMPLES_AVX 1
+#define AVND_CONVERT_SAMPLES_AVX_DISPATCH 1
+#define AVND_CONVERT_SAMPLES_AVX_TARGET __attribute__((target("avx")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AVND_CONVERT_SAMPLES_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace avnd
+{
+/**
+ * float <-> double conversion kernels used by the process adapters
+ * when the host does not send samples in the type the processor uses.
+ */
+namespace convert_kernels
+{
+inline void scalar(const float* in, double* out, int n) noexcept
+{
+  for (int i = 0; i < n; i++)
+    out[i] = in[i];
+}
+
+inline void scalar(const double* in, float* out, int n) noexcept
+{
+  for (int i = 0; i < n; i++)
+    out[i] = static_cast<float>(in[i]);
+}
+
+#if AVND_CONVERT_SAMPLES_SSE2
+inline void sse2(const float* in, double* out, int n) noexcept
+{
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 x = _mm_loadu_ps(in + i);
+    _mm_storeu_pd(out + i, _mm_cvtps_pd(x));
+    _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+  }
+  scalar(in + i, out + i, n - i);
+}
+
+inline void sse2(const double* in, float* out, int n) noexcept
+{
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(in + i));
+    const __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2));
+    _mm_storeu_ps(out + i, _mm_movelh_ps(lo, hi));
+  }
+  scalar(in + i, out + i, n - i);
+}
+#endif
+
+#if AVND_CONVERT_SAMPLES_AVX
+AVND_CONVERT_SAMPLES_AVX_TARGET
+inline void avx(const float* in, double* out, int n) noexcept
+{
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 x = _mm256_loadu_ps(in + i);
+    _mm256_storeu_pd(out + i, _mm256_cvtps_pd(_mm256_castps256_ps128(x)));
+    _mm256_storeu_pd(out + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)));
+  }
+  scalar(in + i, out + i, n - i);
+}
+
+AVND_CONVERT_SAMPLES_AVX_TARGET
+inline void avx(const double* in, float* out, int n) noexcept
+{
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(in + i));
+    const __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(in + i + 4));
+    _mm256_storeu_ps(out + i, _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1));
+  }
+  scalar(in + i, out + i, n - i);
+}
+#endif
+
+#if AVND_CONVERT_SAMPLES_NEON
+inline void neon(const float* in, double* out, int n) noexcept
+{
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const float32x4_t x = vld1q_f32(in + i);
+    vst1q_f64(out + i, vcvt_f64_f32(vget_low_f32(x)));
+    vst1q_f64(out + i + 2, vcvt_high_f64_f32(x));
+  }
+  scalar(in + i, out + i, n - i);
+}
+
+inline void neon(const double* in, float* out, int n) noexcept
+{
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const float32x2_t lo = vcvt_f32_f64(vld1q_f64(in + i));
+    vst1q_f32(out + i, vcvt_high_f32_f64(lo, vld1q_f64(in + i + 2)));
+  }
+  scalar(in + i, out + i, n - i);
+}
+#endif
+
+#if AVND_CONVERT_SAMPLES_AVX_DISPATCH
+inline bool cpu_has_avx() noexcept
+{
+  static const bool ok = __builtin_cpu_supports("avx");
+  return ok;
+}
+#endif
+
+// Picks the best kernel available on this machine
+template <typename In, typename Out>
+inline void best(const In* in, Out* out, int n) noexcept
+{
+#if AVND_CONVERT_SAMPLES_AVX_DISPATCH
+  if (cpu_has_avx())
+    return avx(in, out, n);
+  return sse2(in, out, n);
+#elif AVND_CONVERT_SAMPLES_AVX
+  return avx(in, out, n);
+#elif AVND_CONVERT_SAMPLES_SSE2
+  return sse2(in, out, n);
+#elif AVND_CONVERT_SAMPLES_NEON
+  return neon(in, out, n);
+#else
+  return scalar(in, out, n);
+#endif
+}
+}
+
+/**
+ * Copies n samples from in to out, converting between float and double if needed.
+ */
+template <typename In, typename Out>
+inline void convert_samples(const In* in, Out* out, int n) noexcept
+{
+  if constexpr (std::is_same_v<std::remove_const_t<In>, Out>)
+    std::copy_n(in, n, out);
+  else
+    convert_kernels::best(in, out, n);
+}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define AVND_CYCLE_COUNTER_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define AVND_CYCLE_COUNTER_TSC 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define AVND_CYCLE_COUNTER_AARCH64 1
+#endif
+
+namespace avnd
+{
+/**
+ * The cheapest monotonic counter of the platform: the time-stamp counter on x86,
+ * the virtual counter on ARM64, and the steady clock (in ns) elsewhere.
+ */
+struct cycle_counter
+{
+  static uint64_t now() noexcept
+  {
+#if AVND_CYCLE_COUNTER_TSC
+    return __rdtsc();
+#elif AVND_CYCLE_COUNTER_AARCH64
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  // Measured once against the steady clock, on the first call: not realtime-safe
+  static double ns_per_tick() noexcept
+  {
+#if AVND_CYCLE_COUNTER_TSC || AVND_CYCLE_COUNTER_AARCH64
+    static const double ratio = [] {
+      using clock = std::chrono::steady_clock;
+      const auto t0 = clock::now();
+      const uint64_t c0 = now();
+      auto t1 = t0;
+      while (t1 - t0 < std::chrono::milliseconds(2))
+        t1 = clock::now();
+      const uint64_t c1 = now();
+      const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+      return c1 > c0 ? ns / double(c1 - c0) : 1.;
+    }();
+    return ratio;
+#else
+    return 1.;
+#endif
+  }
+};
+}
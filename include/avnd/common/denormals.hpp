@@ -0,0 +1,101 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AVND_DENORMALS_SSE 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define AVND_DENORMALS_AARCH64 1
+#elif defined(__arm__) && defined(__ARM_FP) && (defined(__GNUC__) || defined(__clang__))
+#define AVND_DENORMALS_ARM 1
+#endif
+
+namespace avnd
+{
+/**
+ * Sets the floating-point environment of the current thread so that
+ * denormal numbers are flushed to zero (FTZ) and treated as zero
+ * when read (DAZ), and restores the previous one on destruction.
+ *
+ * Without this, the decaying tails of IIR filters, reverbs, etc.
+ * end up computing with denormals, which is much slower on most CPUs.
+ *
+ * On ARM there is a single flag (FZ) for both behaviours.
+ * On other platforms this does nothing.
+ */
+struct scoped_flush_denormals
+{
+#if AVND_DENORMALS_SSE
+  static constexpr unsigned int flags = 0x8040; // FTZ | DAZ
+  unsigned int m_previous;
+
+  scoped_flush_denormals() noexcept
+      : m_previous{_mm_getcsr()}
+  {
+    _mm_setcsr(m_previous | flags);
+  }
+  ~scoped_flush_denormals() { _mm_setcsr(m_previous); }
+#elif AVND_DENORMALS_AARCH64
+  static constexpr uint64_t flags = uint64_t(1) << 24; // FZ
+  uint64_t m_previous;
+
+  scoped_flush_denormals() noexcept
+  {
+    asm volatile("mrs %0, fpcr" : "=r"(m_previous));
+    asm volatile("msr fpcr, %0" : : "r"(m_previous | flags));
+  }
+  ~scoped_flush_denormals() { asm volatile("msr fpcr, %0" : : "r"(m_previous)); }
+#elif AVND_DENORMALS_ARM
+  static constexpr uint32_t flags = uint32_t(1) << 24; // FZ
+  uint32_t m_previous;
+
+  scoped_flush_denormals() noexcept
+  {
+    asm volatile("vmrs %0, fpscr" : "=r"(m_previous));
+    asm volatile("vmsr fpscr, %0" : : "r"(m_previous | flags));
+  }
+  ~scoped_flush_denormals() { asm volatile("vmsr fpscr, %0" : : "r"(m_previous)); }
+#else
+  scoped_flush_denormals() noexcept { }
+#endif
+
+  scoped_flush_denormals(const scoped_flush_denormals&) = delete;
+  scoped_flush_denormals(scoped_flush_denormals&&) = delete;
+  scoped_flush_denormals& operator=(const scoped_flush_denormals&) = delete;
+  scoped_flush_denormals& operator=(scoped_flush_denormals&&) = delete;
+};
+
+struct scoped_keep_denormals
+{
+};
+
+/**
+ * Denormals are flushed during the processing, unless the processor opts out,
+ * e.g. because it relies on them or manages the FP environment itself:
+ *
+ *   static constexpr bool flush_denormals = false;
+ */
+template <typename T>
+constexpr bool flushes_denormals() noexcept
+{
+  if constexpr (requires { bool(T::flush_denormals); })
+    return T::flush_denormals;
+  else
+    return true;
+}
+
+/**
+ * The guard the bindings put around their process entry points:
+ *
+ *   [[maybe_unused]] avnd::denormal_guard<T> guard;
+ */
+template <typename T>
+using denormal_guard = std::conditional_t<
+    flushes_denormals<T>(),
+    scoped_flush_denormals,
+    scoped_keep_denormals>;
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/cycle_counter.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace avnd
+{
+/**
+ * What a dsp_load_meter has measured since the processing started.
+ * Durations are in nanoseconds per process call; the load is the time
+ * spent processing as a percentage of the duration of the processed audio,
+ * i.e. of the deadline of the block.
+ */
+struct dsp_load_stats
+{
+  int64_t blocks{};
+  double min_ns{};
+  double avg_ns{};
+  double p99_ns{};
+  double max_ns{};
+  double load{};
+  double max_load{};
+};
+
+/**
+ * Measures the time spent in each process call of an instance.
+ *
+ * The audio thread is the only writer, the counters are read with relaxed atomics
+ * from any other thread: nothing is locked, and a reading can be off by the block
+ * being recorded at that time.
+ *
+ * The durations are stored in a log-linear histogram, with 8 buckets per octave,
+ * from which the 99th percentile is computed when reading.
+ */
+class dsp_load_meter
+{
+public:
+  static constexpr int sub_bits = 3;
+  static constexpr int sub_buckets = 1 << sub_bits;
+  static constexpr int max_bits = 40; // ~18 minutes
+  static constexpr int bucket_count = (max_bits - sub_bits + 1) * sub_buckets;
+
+  explicit dsp_load_meter(std::string_view name = {});
+  ~dsp_load_meter();
+  dsp_load_meter(const dsp_load_meter&) = delete;
+  dsp_load_meter& operator=(const dsp_load_meter&) = delete;
+
+  // Name of the processor: the instances of a processor share it
+  std::string_view name() const noexcept { return m_name; }
+
+  // Tells apart the instances of a processor, in the order of their creation:
+  // unique among the meters of the process, and never reused
+  int64_t id() const noexcept { return m_id; }
+
+  // Call when the processing (re)starts: not realtime-safe the first time
+  void start(double sample_rate) noexcept
+  {
+    m_ns_per_tick = cycle_counter::ns_per_tick();
+    m_ns_per_frame = sample_rate > 0. ? 1e9 / sample_rate : 0.;
+    clear();
+    m_reset.store(false, std::memory_order_relaxed);
+  }
+
+  // Call from the audio thread, around the processing of a block
+  uint64_t begin() const noexcept { return cycle_counter::now(); }
+  void end(uint64_t begin_ticks, int frames) noexcept
+  {
+    const uint64_t ticks = cycle_counter::now() - begin_ticks;
+
+    if (m_reset.load(std::memory_order_relaxed))
+    {
+      clear();
+      m_reset.store(false, std::memory_order_relaxed);
+    }
+
+    const uint64_t ns = uint64_t(double(ticks) * m_ns_per_tick);
+    const double deadline = frames * m_ns_per_frame;
+    const float load = deadline > 0. ? float(100. * double(ns) / deadline) : 0.f;
+
+    auto add = [](auto& counter, auto value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+    add(m_blocks, 1);
+    add(m_total_ns, ns);
+    add(m_total_deadline_ns, uint64_t(deadline));
+    add(m_histogram[bucket(ns)], 1u);
+    if (ns < m_min_ns.load(std::memory_order_relaxed))
+      m_min_ns.store(ns, std::memory_order_relaxed);
+    if (ns > m_max_ns.load(std::memory_order_relaxed))
+      m_max_ns.store(ns, std::memory_order_relaxed);
+    if (load > m_max_load.load(std::memory_order_relaxed))
+      m_max_load.store(load, std::memory_order_relaxed);
+    m_last_load.store(load, std::memory_order_relaxed);
+  }
+
+  // Load of the last processed block, in percent
+  float last_load() const noexcept { return m_last_load.load(std::memory_order_relaxed); }
+
+  // From any thread
+  dsp_load_stats stats() const noexcept
+  {
+    dsp_load_stats s;
+    s.blocks = m_blocks.load(std::memory_order_relaxed);
+    if (s.blocks == 0)
+      return s;
+
+    const double total = m_total_ns.load(std::memory_order_relaxed);
+    const double deadline = m_total_deadline_ns.load(std::memory_order_relaxed);
+    s.min_ns = m_min_ns.load(std::memory_order_relaxed);
+    s.max_ns = m_max_ns.load(std::memory_order_relaxed);
+    s.avg_ns = total / s.blocks;
+    s.load = deadline > 0. ? 100. * total / deadline : 0.;
+    s.max_load = m_max_load.load(std::memory_order_relaxed);
+
+    // Upper bound of the bucket where 99% of the blocks are reached
+    int64_t count = 0;
+    for (const auto& c : m_histogram)
+      count += c.load(std::memory_order_relaxed);
+    const int64_t target = count - count / 100;
+    int64_t cumulated = 0;
+    for (int b = 0; b < bucket_count; b++)
+    {
+      cumulated += m_histogram[b].load(std::memory_order_relaxed);
+      if (cumulated >= target)
+      {
+        s.p99_ns = std::min(std::max(double(bucket_end(b)), s.min_ns), s.max_ns);
+        break;
+      }
+    }
+    return s;
+  }
+
+  // From any thread: the audio thread clears the counters before the next block
+  void reset() noexcept { m_reset.store(true, std::memory_order_relaxed); }
+
+  static constexpr int bucket(uint64_t ns) noexcept
+  {
+    if (ns < sub_buckets)
+      return int(ns);
+    const int msb = std::bit_width(ns) - 1;
+    const int b = (msb - sub_bits + 1) * sub_buckets
+                  + int((ns >> (msb - sub_bits)) & (sub_buckets - 1));
+    return std::min(b, bucket_count - 1);
+  }
+
+  // First duration past a bucket
+  static constexpr uint64_t bucket_end(int b) noexcept
+  {
+    if (b < sub_buckets)
+      return b + 1;
+    const int msb = b / sub_buckets + sub_bits - 1;
+    const uint64_t low = (uint64_t(1) << msb)
+                         | (uint64_t(b % sub_buckets) << (msb - sub_bits));
+    return low + (uint64_t(1) << (msb - sub_bits));
+  }
+
+private:
+  void clear() noexcept
+  {
+    m_blocks.store(0, std::memory_order_relaxed);
+    m_total_ns.store(0, std::memory_order_relaxed);
+    m_total_deadline_ns.store(0, std::memory_order_relaxed);
+    m_min_ns.store(UINT64_MAX, std::memory_order_relaxed);
+    m_max_ns.store(0, std::memory_order_relaxed);
+    m_max_load.store(0.f, std::memory_order_relaxed);
+    m_last_load.store(0.f, std::memory_order_relaxed);
+    for (auto& c : m_histogram)
+      c.store(0, std::memory_order_relaxed);
+  }
+
+  std::string_view m_name;
+  int64_t m_id{};
+  double m_ns_per_tick{1.};
+  double m_ns_per_frame{};
+
+  std::atomic<int64_t> m_blocks{};
+  std::atomic<uint64_t> m_total_ns{};
+  std::atomic<uint64_t> m_total_deadline_ns{};
+  std::atomic<uint64_t> m_min_ns{UINT64_MAX};
+  std::atomic<uint64_t> m_max_ns{};
+  std::atomic<float> m_max_load{};
+  std::atomic<float> m_last_load{};
+  std::atomic_bool m_reset{};
+  std::array<std::atomic<uint32_t>, bucket_count> m_histogram{};
+};
+
+/**
+ * All the dsp_load_meter alive in the process, to find which instance
+ * is the slowest e.g. when a session glitches.
+ * Meters register themselves on construction: the audio thread never uses this.
+ */
+class dsp_load_registry
+{
+public:
+  static dsp_load_registry& instance() noexcept
+  {
+    static dsp_load_registry registry;
+    return registry;
+  }
+
+  // f(const dsp_load_meter&) is called with the registry locked
+  void for_each(auto&& f) const
+  {
+    std::lock_guard _{m_mutex};
+    for (const dsp_load_meter* meter : m_meters)
+      f(*meter);
+  }
+
+  // Returns the id of the meter
+  int64_t add(const dsp_load_meter& meter)
+  {
+    std::lock_guard _{m_mutex};
+    m_meters.push_back(&meter);
+    return ++m_last_id;
+  }
+
+  void remove(const dsp_load_meter& meter)
+  {
+    std::lock_guard _{m_mutex};
+    std::erase(m_meters, &meter);
+  }
+
+private:
+  mutable std::mutex m_mutex;
+  std::vector<const dsp_load_meter*> m_meters;
+  int64_t m_last_id{};
+};
+
+inline dsp_load_meter::dsp_load_meter(std::string_view name)
+    : m_name{name}
+{
+  m_id = dsp_load_registry::instance().add(*this);
+}
+
+inline dsp_load_meter::~dsp_load_meter()
+{
+  dsp_load_registry::instance().remove(*this);
+}
+}
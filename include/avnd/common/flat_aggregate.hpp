@@ -0,0 +1,377 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/aggregates.hpp>
+
+#include <cstddef>
+
+namespace avnd
+{
+/**
+ * An aggregate whose members are of the given types, in order:
+ * flat_aggregate<typelist<A, B>> is struct { A f0; B f1; }.
+ *
+ * This allows to build structs out of other structs at compile-time,
+ * e.g. a single "inputs" struct with the ports of several processors,
+ * which the reflection then sees like any other inputs struct.
+ */
+template <typename Types>
+struct flat_aggregate;
+
+static constexpr std::size_t flat_aggregate_max_fields = 32;
+
+// clang-format off
+template <>
+struct flat_aggregate<typelist<>> { };
+
+template <typename T0>
+struct flat_aggregate<typelist<T0>> { T0 f0; };
+
+template <typename T0, typename T1>
+struct flat_aggregate<typelist<T0, T1>> { T0 f0; T1 f1; };
+
+template <typename T0, typename T1, typename T2>
+struct flat_aggregate<typelist<T0, T1, T2>> { T0 f0; T1 f1; T2 f2; };
+
+template <typename T0, typename T1, typename T2, typename T3>
+struct flat_aggregate<typelist<T0, T1, T2, T3>> { T0 f0; T1 f1; T2 f2; T3 f3; };
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23,
+    typename T24>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23, T24>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+  T24 f24;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23,
+    typename T24, typename T25>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23, T24, T25>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+  T24 f24; T25 f25;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23,
+    typename T24, typename T25, typename T26>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23, T24, T25, T26>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+  T24 f24; T25 f25; T26 f26;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23,
+    typename T24, typename T25, typename T26, typename T27>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23, T24, T25, T26, T27>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+  T24 f24; T25 f25; T26 f26; T27 f27;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23,
+    typename T24, typename T25, typename T26, typename T27, typename T28>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23, T24, T25, T26, T27, T28>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+  T24 f24; T25 f25; T26 f26; T27 f27; T28 f28;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23,
+    typename T24, typename T25, typename T26, typename T27, typename T28, typename T29>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23, T24, T25, T26, T27, T28, T29>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+  T24 f24; T25 f25; T26 f26; T27 f27; T28 f28; T29 f29;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23,
+    typename T24, typename T25, typename T26, typename T27, typename T28, typename T29, typename T30>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23, T24, T25, T26, T27, T28, T29, T30>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+  T24 f24; T25 f25; T26 f26; T27 f27; T28 f28; T29 f29; T30 f30;
+};
+
+template <
+    typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7,
+    typename T8, typename T9, typename T10, typename T11, typename T12, typename T13, typename T14, typename T15,
+    typename T16, typename T17, typename T18, typename T19, typename T20, typename T21, typename T22, typename T23,
+    typename T24, typename T25, typename T26, typename T27, typename T28, typename T29, typename T30, typename T31>
+struct flat_aggregate<typelist<
+    T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
+    T16, T17, T18, T19, T20, T21, T22, T23, T24, T25, T26, T27, T28, T29, T30, T31>>
+{
+  T0 f0; T1 f1; T2 f2; T3 f3; T4 f4; T5 f5; T6 f6; T7 f7;
+  T8 f8; T9 f9; T10 f10; T11 f11; T12 f12; T13 f13; T14 f14; T15 f15;
+  T16 f16; T17 f17; T18 f18; T19 f19; T20 f20; T21 f21; T22 f22; T23 f23;
+  T24 f24; T25 f25; T26 f26; T27 f27; T28 f28; T29 f29; T30 f30; T31 f31;
+};
+
+// clang-format on
+}
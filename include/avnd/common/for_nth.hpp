@@ -2,8 +2,8 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
-#include <avnd/common/coroutines.hpp>
 #include <avnd/common/aggregates.hpp>
+#include <avnd/common/member_range.hpp>
 
 #include <cassert>
 #include <utility>
@@ -11,14 +11,52 @@
 namespace avnd
 {
 
-template <std::size_t N>
-constexpr void for_nth(int k, auto&& f)
+namespace detail
 {
-  [k]<std::size_t... Index>(std::index_sequence<Index...>, auto&& f)
+// One entry per index: entry k calls f.operator()<k-th index>()
+template <typename F, typename K, K... Index>
+inline constexpr void (*const index_dispatch_table[])(F&)
+    = {+[](F& f) { f.template operator()<Index>(); }...};
+}
+
+// Below that, a chain of comparisons is as fast and lets the compiler inline f
+inline constexpr std::size_t index_dispatch_threshold = 8;
+
+/**
+ * Calls f.operator()<I>() with I the k-th element of the sequence,
+ * or nothing if k is out of bounds.
+ *
+ * For more than a handful of elements, this goes through a table of function
+ * pointers generated at compile time: the cost does not depend on the number
+ * of elements, unlike a fold over them, which matters with e.g. one
+ * host parameter change per call and processors with hundreds of parameters.
+ */
+template <typename F, typename K, K... Index>
+constexpr void index_dispatch(int k, F&& f, std::integer_sequence<K, Index...>)
+{
+  constexpr std::size_t N = sizeof...(Index);
+  if constexpr (N > 0)
   {
-    ((void)(Index == k && (f.template operator()<Index>(), true)), ...);
+    if (k < 0 || std::size_t(k) >= N)
+      return;
+
+    if constexpr (N <= index_dispatch_threshold)
+    {
+      int i = 0;
+      ((void)(i++ == k && (f.template operator()<Index>(), true)), ...);
+    }
+    else
+    {
+      using func_type = std::remove_reference_t<F>;
+      detail::index_dispatch_table<func_type, K, Index...>[k](f);
+    }
   }
-  (std::make_index_sequence<N>(), f);
+}
+
+template <std::size_t N>
+constexpr void for_nth(int k, auto&& f)
+{
+  avnd::index_dispatch(k, f, std::make_index_sequence<N>());
 }
 
 template <class T, class F>
@@ -42,26 +80,10 @@ constexpr void for_each_field_ref(T&& value, F&& func)
 #endif
 }
 
-template <class T, class F>
-void for_each_field_ref(avnd::member_iterator<T>&& value, F&& func)
-{
-  for (auto& v : value)
-  {
-    for_each_field_ref(v, func);
-  }
-}
-template <class T, class F>
-void for_each_field_ref(avnd::member_iterator<T>& value, F&& func)
-{
-  for (auto& v : value)
-  {
-    for_each_field_ref(v, func);
-  }
-}
-template <class T, class F>
-void for_each_field_ref(const avnd::member_iterator<T>& value, F&& func)
+template <avnd::multi_instance_range T, class F>
+void for_each_field_ref(T&& value, F&& func)
 {
-  for (auto& v : value)
+  for (auto&& v : value)
   {
     for_each_field_ref(v, func);
   }
@@ -0,0 +1,185 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/aligned_allocator.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace avnd
+{
+/**
+ * Linear-phase half-band FIR low-pass, used for 2x up- and down-sampling.
+ *
+ * Half of the taps of such a filter are zero, and the center one is 1/2:
+ * in polyphase form, one phase is a plain delay and the other one a FIR
+ * with the `taps` non-zero coefficients, run at the low rate.
+ *
+ * The coefficients are a Kaiser-windowed sinc: the passband is flat up to
+ * 0.42 * the low rate, and the attenuation is above 70 dB from 0.58 * the low rate,
+ * e.g. for the image of a 20 kHz tone at 48 kHz.
+ */
+template <typename FP>
+struct halfband_filter
+{
+  // Non-zero taps on each side of the center one
+  static constexpr int half_taps = 16;
+
+  // Non-zero taps of the polyphase FIR
+  static constexpr int taps = 2 * half_taps;
+
+  // Group delay, in samples of the high rate
+  static constexpr int delay = 2 * half_taps - 1;
+
+  // Coefficients of the polyphase FIR, for x[n], x[n-1], ... x[n - taps + 1]
+  static const std::array<FP, taps>& coefficients() noexcept
+  {
+    static const std::array<FP, taps> coefs = [] {
+      constexpr double beta = 8.;
+      constexpr double pi = 3.141592653589793238462643383279502884;
+      constexpr int length = 4 * half_taps - 1;
+      constexpr int center = length / 2;
+
+      // Zeroth-order modified Bessel function of the first kind
+      auto i0 = [](double x) {
+        double sum = 1., term = 1.;
+        for (int k = 1; k < 32; k++)
+        {
+          term *= (x / (2. * k)) * (x / (2. * k));
+          sum += term;
+        }
+        return sum;
+      };
+
+      std::array<double, taps> h;
+      double sum = 0.;
+      for (int j = 0; j < taps; j++)
+      {
+        const int k = 2 * j - center;
+        const double r = double(k) / center;
+        const double window = i0(beta * std::sqrt(1. - r * r)) / i0(beta);
+        h[j] = std::sin(pi * k / 2.) / (pi * k) * window;
+        sum += h[j];
+      }
+
+      // The non-zero taps of a half-band filter add up to 1/2
+      std::array<FP, taps> res;
+      for (int j = 0; j < taps; j++)
+        res[j] = FP(h[j] * 0.5 / sum);
+      return res;
+    }();
+    return coefs;
+  }
+};
+
+/**
+ * Convolution of the last halfband_filter::taps samples of a buffer with the filter:
+ *   out[i] = gain * sum_j coefs[j] * in[i - j], for i in [0, n).
+ * in[-taps + 1] must be readable.
+ *
+ * The loop over the frames is the inner one so that it gets vectorized.
+ */
+template <typename FP>
+void halfband_convolve(const FP* in, FP* out, int n, FP gain) noexcept
+{
+  using filter = halfband_filter<FP>;
+  const auto& coefs = filter::coefficients();
+
+  std::fill_n(out, n, FP{});
+  for (int j = 0; j < filter::taps; j++)
+  {
+    const FP c = gain * coefs[j];
+    const FP* src = in - j;
+    for (int i = 0; i < n; i++)
+      out[i] += c * src[i];
+  }
+}
+
+/**
+ * 2x upsampler for a single channel: n input frames give 2n output frames.
+ */
+template <typename FP>
+struct halfband_upsampler
+{
+  using filter = halfband_filter<FP>;
+  static constexpr int history = filter::taps - 1;
+
+  std::vector<FP, avnd::aligned_allocator<FP>> m_input, m_even;
+  int m_max_frames{};
+
+  void reset(int max_frames)
+  {
+    filter::coefficients();
+    m_max_frames = max_frames;
+    m_input.assign(history + max_frames, FP{});
+    m_even.assign(max_frames, FP{});
+  }
+
+  // n must be <= max_frames
+  void process(const FP* in, FP* out, int n) noexcept
+  {
+    FP* x = m_input.data() + history;
+    std::copy_n(in, n, x);
+
+    // Even phase: the FIR, with a gain of 2 to compensate the zero-stuffing
+    halfband_convolve(x, m_even.data(), n, FP(2));
+
+    // Odd phase: the center tap, i.e. a delay
+    const FP* delayed = x - (filter::half_taps - 1);
+    for (int i = 0; i < n; i++)
+    {
+      out[2 * i] = m_even[i];
+      out[2 * i + 1] = delayed[i];
+    }
+
+    std::copy_n(x + n - history, history, m_input.data());
+  }
+};
+
+/**
+ * 2x downsampler for a single channel: 2n input frames give n output frames.
+ */
+template <typename FP>
+struct halfband_downsampler
+{
+  using filter = halfband_filter<FP>;
+  static constexpr int even_history = filter::taps - 1;
+  static constexpr int odd_history = filter::half_taps;
+
+  std::vector<FP, avnd::aligned_allocator<FP>> m_even, m_odd;
+  int m_max_frames{};
+
+  void reset(int max_frames)
+  {
+    filter::coefficients();
+    m_max_frames = max_frames;
+    m_even.assign(even_history + max_frames, FP{});
+    m_odd.assign(odd_history + max_frames, FP{});
+  }
+
+  // n (the output frame count) must be <= max_frames
+  void process(const FP* in, FP* out, int n) noexcept
+  {
+    FP* even = m_even.data() + even_history;
+    FP* odd = m_odd.data() + odd_history;
+    for (int i = 0; i < n; i++)
+    {
+      even[i] = in[2 * i];
+      odd[i] = in[2 * i + 1];
+    }
+
+    halfband_convolve(even, out, n, FP(1));
+
+    // Center tap
+    const FP* delayed = odd - filter::half_taps;
+    for (int i = 0; i < n; i++)
+      out[i] += FP(0.5) * delayed[i];
+
+    std::copy_n(even + n - even_history, even_history, m_even.data());
+    std::copy_n(odd + n - odd_history, odd_history, m_odd.data());
+  }
+};
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/cycle_counter.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace avnd
+{
+enum class log_level : uint8_t
+{
+  trace,
+  debug,
+  info,
+  warn,
+  error,
+  critical
+};
+
+/**
+ * Messages of an instance, formatted on its audio thread and written
+ * by the background thread of the log_consumer.
+ *
+ * The messages are stored in fixed-size slots allocated on construction:
+ * the audio thread is the only producer, writes without locks nor allocations,
+ * and longer messages are truncated.
+ *
+ * A message is dropped when the queue is full, or when the audio thread logs
+ * more than max_per_second messages (with bursts up to the same count):
+ * both are counted, and the counts are written with the next messages.
+ *
+ * The queues are shared with the log_consumer, which writes them:
+ * see log_consumer::add and log_consumer::remove.
+ */
+class log_queue
+{
+public:
+  static constexpr int message_size = 256;
+  struct message
+  {
+    log_level level{};
+    uint16_t size{};
+    char text[message_size - 4];
+  };
+
+  struct options
+  {
+    int capacity = 128; // must be a power of two
+    int max_per_second = 200;
+  };
+
+  struct dropped_count
+  {
+    uint64_t full{};
+    uint64_t rate_limited{};
+  };
+
+  // Called from the consumer thread to write the messages, e.g. to a console
+  using writer = void (*)(log_level, std::string_view);
+
+  explicit log_queue(writer w) : log_queue{w, options{}} { }
+  log_queue(writer w, options opts);
+  log_queue(const log_queue&) = delete;
+  log_queue& operator=(const log_queue&) = delete;
+
+  // Audio thread: the slot to format a message into, or nullptr to drop it
+  message* claim(log_level level) noexcept
+  {
+    if (!take_token())
+    {
+      m_rate_limited.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    const uint32_t w = m_write.load(std::memory_order_relaxed);
+    if (w - m_read.load(std::memory_order_acquire) > m_mask)
+    {
+      m_full.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    message& m = m_messages[w & m_mask];
+    m.level = level;
+    m.size = 0;
+    return &m;
+  }
+
+  // Audio thread: makes the claimed message visible to the consumer
+  void commit() noexcept
+  {
+    m_write.store(m_write.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Any thread
+  dropped_count dropped() const noexcept
+  {
+    return {
+        m_full.load(std::memory_order_relaxed),
+        m_rate_limited.load(std::memory_order_relaxed)};
+  }
+
+  // Consumer thread: writes the pending messages
+  void drain()
+  {
+    std::lock_guard _{m_drain_mutex};
+    uint32_t r = m_read.load(std::memory_order_relaxed);
+    const uint32_t w = m_write.load(std::memory_order_acquire);
+    for (; r != w; r++)
+    {
+      const message& m = m_messages[r & m_mask];
+      m_write_message(m.level, std::string_view{m.text, m.size});
+    }
+    m_read.store(r, std::memory_order_release);
+
+    const auto d = dropped();
+    if (d.full != m_reported.full || d.rate_limited != m_reported.rate_limited)
+    {
+      std::string msg = "log messages dropped: ";
+      msg += std::to_string(d.full - m_reported.full);
+      msg += " (queue full), ";
+      msg += std::to_string(d.rate_limited - m_reported.rate_limited);
+      msg += " (rate limited)";
+      m_write_message(log_level::warn, msg);
+      m_reported = d;
+    }
+  }
+
+private:
+  bool take_token() noexcept
+  {
+    const uint64_t now = cycle_counter::now();
+    const double refill = double(now - m_last_refill) / m_ticks_per_token;
+    m_last_refill = now;
+    m_tokens = std::min(m_tokens + refill, m_max_tokens);
+    if (m_tokens < 1.)
+      return false;
+    m_tokens -= 1.;
+    return true;
+  }
+
+  writer m_write_message{};
+  std::mutex m_drain_mutex;
+  std::unique_ptr<message[]> m_messages;
+  uint32_t m_mask{};
+
+  // Rate limiting, only used by the audio thread
+  double m_ticks_per_token{1.};
+  double m_max_tokens{};
+  double m_tokens{};
+  uint64_t m_last_refill{};
+
+  std::atomic<uint32_t> m_write{};
+  std::atomic<uint32_t> m_read{};
+  std::atomic<uint64_t> m_full{};
+  std::atomic<uint64_t> m_rate_limited{};
+  dropped_count m_reported{};
+};
+
+/**
+ * The background thread which writes the messages of all the log_queue
+ * of the process. It is started with the first queue, and checks
+ * them every few milliseconds: the audio threads never wake it up.
+ *
+ * The queues are written without holding the lock of the list of queues:
+ * the writers may take locks of their own, e.g. the one of the host,
+ * which may be held when a queue is added or removed.
+ */
+class log_consumer
+{
+public:
+  static constexpr std::chrono::milliseconds interval{10};
+
+  static log_consumer& instance() noexcept
+  {
+    static log_consumer consumer;
+    return consumer;
+  }
+
+  ~log_consumer()
+  {
+    {
+      std::lock_guard _{m_mutex};
+      m_stop = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  void add(std::shared_ptr<log_queue> queue)
+  {
+    std::lock_guard _{m_mutex};
+    m_queues.push_back(std::move(queue));
+    if (!m_thread.joinable())
+      m_thread = std::thread{[this] { run(); }};
+  }
+
+  // Does not wait: the pending messages of the queue are written
+  // by the next pass of the consumer, which then releases it.
+  void remove(const log_queue& queue)
+  {
+    std::lock_guard _{m_mutex};
+    auto it = std::find_if(m_queues.begin(), m_queues.end(), [&](const auto& q) {
+      return q.get() == &queue;
+    });
+    if (it != m_queues.end())
+    {
+      m_removed.push_back(std::move(*it));
+      m_queues.erase(it);
+    }
+  }
+
+  // Writes the pending messages now, e.g. before exiting
+  void flush()
+  {
+    std::vector<std::shared_ptr<log_queue>> queues;
+    take_queues(queues);
+    for (auto& queue : queues)
+      queue->drain();
+  }
+
+private:
+  // The queues to write, and those removed since the last pass
+  void take_queues(std::vector<std::shared_ptr<log_queue>>& queues)
+  {
+    std::lock_guard _{m_mutex};
+    queues.assign(m_queues.begin(), m_queues.end());
+    queues.insert(
+        queues.end(), std::make_move_iterator(m_removed.begin()),
+        std::make_move_iterator(m_removed.end()));
+    m_removed.clear();
+  }
+
+  void run()
+  {
+    std::vector<std::shared_ptr<log_queue>> queues;
+    for (;;)
+    {
+      {
+        std::unique_lock lock{m_mutex};
+        m_wake.wait_for(lock, interval, [this] { return m_stop; });
+        if (m_stop)
+          break;
+      }
+
+      take_queues(queues);
+      for (auto& queue : queues)
+        queue->drain();
+      queues.clear();
+    }
+  }
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::vector<std::shared_ptr<log_queue>> m_queues;
+  std::vector<std::shared_ptr<log_queue>> m_removed;
+  std::thread m_thread;
+  bool m_stop{};
+};
+
+inline log_queue::log_queue(writer w, options opts)
+    : m_write_message{w}
+    , m_messages{std::make_unique<message[]>(opts.capacity)}
+    , m_mask(opts.capacity - 1)
+    , m_ticks_per_token{1e9 / (cycle_counter::ns_per_tick() * opts.max_per_second)}
+    , m_max_tokens(opts.max_per_second)
+    , m_tokens(opts.max_per_second)
+    , m_last_refill{cycle_counter::now()}
+{
+}
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/coroutines.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Set to 1 to get the previous behaviour where iterating over the
+// instances of an effect_container goes through a coroutine (member_iterator).
+// Note that this allocates a coroutine frame each time a range is created.
+#if !defined(AVND_USE_COROUTINE_MEMBER_RANGE)
+#define AVND_USE_COROUTINE_MEMBER_RANGE 0
+#endif
+
+namespace avnd
+{
+/**
+ * Non-allocating range over a contiguous array of objects,
+ * which yields a projection of each object.
+ *
+ * This is what effect_container uses to iterate e.g. over
+ * all the per-channel instances of a monophonic processor:
+ * it is just a pair of pointers, so it can be created in the audio thread.
+ */
+template <typename Object, typename Projection>
+class member_range
+{
+public:
+  using reference = decltype(std::declval<const Projection&>()(std::declval<Object&>()));
+
+  class iterator
+  {
+  public:
+    constexpr iterator(Object* ptr, const Projection& proj) noexcept
+        : m_ptr{ptr}
+        , m_proj{proj}
+    {
+    }
+
+    constexpr iterator& operator++() noexcept
+    {
+      ++m_ptr;
+      return *this;
+    }
+
+    constexpr reference operator*() const noexcept { return m_proj(*m_ptr); }
+
+    constexpr bool operator==(const iterator& other) const noexcept
+    {
+      return m_ptr == other.m_ptr;
+    }
+
+  private:
+    Object* m_ptr{};
+    [[no_unique_address]] Projection m_proj;
+  };
+
+  constexpr member_range(Object* begin, Object* end, Projection proj) noexcept
+      : m_begin{begin}
+      , m_end{end}
+      , m_proj{std::move(proj)}
+  {
+  }
+
+  constexpr iterator begin() const noexcept { return iterator{m_begin, m_proj}; }
+  constexpr iterator end() const noexcept { return iterator{m_end, m_proj}; }
+
+  constexpr std::size_t size() const noexcept { return m_end - m_begin; }
+  constexpr bool empty() const noexcept { return m_begin == m_end; }
+
+  constexpr reference operator[](std::size_t i) const noexcept { return m_proj(m_begin[i]); }
+
+private:
+  Object* m_begin{};
+  Object* m_end{};
+  [[no_unique_address]] Projection m_proj;
+};
+
+#if AVND_USE_COROUTINE_MEMBER_RANGE
+template <typename Object, typename Projection>
+auto make_member_range(Object* begin, Object* end, Projection proj)
+    -> member_iterator<std::remove_reference_t<decltype(proj(*begin))>>
+{
+  for (; begin != end; ++begin)
+  {
+    decltype(auto) r = proj(*begin);
+    co_yield r;
+  }
+}
+#else
+template <typename Object, typename Projection>
+constexpr auto make_member_range(Object* begin, Object* end, Projection proj) noexcept
+{
+  return member_range<Object, Projection>{begin, end, std::move(proj)};
+}
+#endif
+
+template <typename T>
+struct is_member_range : std::false_type
+{
+};
+
+template <typename Object, typename Projection>
+struct is_member_range<member_range<Object, Projection>> : std::true_type
+{
+};
+
+#if AVND_DISABLE_COROUTINES == 0
+template <typename T>
+struct is_member_range<member_iterator<T>> : std::true_type
+{
+};
+#endif
+
+/**
+ * Matches the ranges returned by effect_container when
+ * there are multiple instances of an effect (e.g. one per channel).
+ */
+template <typename T>
+concept multi_instance_range = is_member_range<std::remove_cvref_t<T>>::value;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace avnd
+{
+// splitmix64 finalizer
+constexpr std::uint64_t hash_mix(std::uint64_t x) noexcept
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// FNV-1a
+constexpr std::uint64_t hash_string(std::string_view s) noexcept
+{
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  for (char c : s)
+  {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+/**
+ * A perfect hash table over a fixed set of N 64-bit keys: a lookup is
+ * two integer hashes and one comparison, whatever the number of keys.
+ *
+ * The keys are first split in buckets; each bucket then gets a seed which
+ * sends its keys to free slots of the table ("hash and displace").
+ * It can be built at compile time, e.g. from the hash of names,
+ * or once at startup, e.g. from the addresses of interned symbols.
+ */
+template <std::size_t N>
+struct perfect_hash
+{
+  static constexpr std::size_t table_size = std::bit_ceil(std::max<std::size_t>(2 * N, 1));
+  static constexpr std::size_t bucket_count = std::max<std::size_t>(table_size / 4, 1);
+
+  constexpr perfect_hash() noexcept { m_index.fill(-1); }
+
+  // Index of the key in the array given to build(), or -1
+  constexpr int find(std::uint64_t key) const noexcept
+  {
+    const std::size_t slot = slot_of(key, m_seeds[bucket_of(key)]);
+    return m_keys[slot] == key ? m_index[slot] : -1;
+  }
+
+  // When a key is present more than once, its first index is kept.
+  // Returns false if no seed could be found for some bucket.
+  constexpr bool build(const std::array<std::uint64_t, N>& keys) noexcept
+  {
+    m_seeds.fill(0);
+    m_keys.fill(0);
+    m_index.fill(-1);
+
+    // Sort the keys by bucket
+    std::array<std::size_t, bucket_count + 1> start{};
+    for (std::uint64_t key : keys)
+      start[bucket_of(key) + 1]++;
+    std::size_t largest = 0;
+    for (std::size_t b = 0; b < bucket_count; b++)
+    {
+      largest = std::max(largest, start[b + 1]);
+      start[b + 1] += start[b];
+    }
+
+    std::array<int, N> order{};
+    {
+      auto next = start;
+      for (std::size_t i = 0; i < N; i++)
+        order[next[bucket_of(keys[i])]++] = int(i);
+    }
+
+    // The largest buckets are placed first, while the table is mostly free
+    std::array<std::size_t, N> slots{};
+    for (std::size_t size = largest; size > 0; size--)
+    {
+      for (std::size_t b = 0; b < bucket_count; b++)
+      {
+        if (start[b + 1] - start[b] != size)
+          continue;
+
+        const int* first = order.data() + start[b];
+        const int* last = order.data() + start[b + 1];
+
+        bool placed = false;
+        for (std::uint64_t attempt = 1; attempt <= max_attempts && !placed; attempt++)
+        {
+          const std::uint64_t seed = attempt * 0x9e3779b97f4a7c15ULL;
+          placed = true;
+          for (const int* it = first; it != last && placed; ++it)
+          {
+            const std::uint64_t key = keys[*it];
+            const std::size_t slot = slot_of(key, seed);
+            slots[it - first] = slot;
+            if (m_index[slot] != -1)
+            {
+              placed = false;
+              break;
+            }
+            for (const int* prev = first; prev != it; ++prev)
+            {
+              // Duplicates go to the same slot: it is not a collision
+              if (slots[prev - first] == slot && keys[*prev] != key)
+              {
+                placed = false;
+                break;
+              }
+            }
+          }
+
+          if (placed)
+          {
+            m_seeds[b] = seed;
+            for (const int* it = first; it != last; ++it)
+            {
+              const std::size_t slot = slots[it - first];
+              if (m_index[slot] == -1)
+              {
+                m_keys[slot] = keys[*it];
+                m_index[slot] = *it;
+              }
+            }
+          }
+        }
+
+        if (!placed)
+          return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  static constexpr std::uint64_t max_attempts = 1 << 16;
+
+  static constexpr std::size_t bucket_of(std::uint64_t key) noexcept
+  {
+    return hash_mix(key) & (bucket_count - 1);
+  }
+
+  static constexpr std::size_t slot_of(std::uint64_t key, std::uint64_t seed) noexcept
+  {
+    return hash_mix(key ^ seed) & (table_size - 1);
+  }
+
+  std::array<std::uint64_t, bucket_count> m_seeds{};
+  std::array<std::uint64_t, table_size> m_keys{};
+  std::array<int, table_size> m_index{};
+};
+
+/**
+ * Finds a name in a fixed list, through a perfect hash of the names
+ * computed at compile time.
+ */
+template <std::size_t N>
+struct name_index
+{
+  std::array<std::string_view, N> names{};
+  perfect_hash<N> hash{};
+  bool valid{};
+
+  // Index of the first occurrence of the name, or -1
+  constexpr int find(std::string_view name) const noexcept
+  {
+    const int i = hash.find(hash_string(name));
+    return i >= 0 && names[i] == name ? i : -1;
+  }
+};
+
+template <std::size_t N>
+consteval name_index<N> make_name_index(const std::array<std::string_view, N>& names)
+{
+  std::array<std::uint64_t, N> keys{};
+  for (std::size_t i = 0; i < N; i++)
+    keys[i] = hash_string(names[i]);
+
+  name_index<N> res{.names = names};
+  res.valid = res.hash.build(keys);
+  return res;
+}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#if defined(AVND_RT_CHECK)
+#include <atomic>
+#endif
+
+/**
+ * Realtime-safety checks of the process entry points of the bindings.
+ *
+ * When building with AVND_RT_CHECK defined (see the AVENDISH_RT_CHECK CMake option),
+ * each binding wraps its process callback in an avnd::realtime_scope.
+ * src/realtime_check.cpp, linked in the same binary, intercepts the allocator
+ * (malloc / free and friends, operator new / delete) and pthread_mutex_lock:
+ * a call from inside a realtime scope is a violation, which is reported
+ * on stderr with a backtrace of the call site.
+ *
+ * Otherwise, avnd::realtime_scope is an empty object.
+ */
+namespace avnd
+{
+#if defined(AVND_RT_CHECK)
+
+// The state is read from inside malloc: it must not need an allocation
+// the first time a thread accesses it, like dynamic TLS does in shared objects
+#if defined(__GNUC__)
+#define AVND_RT_CHECK_TLS __attribute__((tls_model("initial-exec")))
+#else
+#define AVND_RT_CHECK_TLS
+#endif
+
+namespace rt_check
+{
+enum class action
+{
+  abort,  // Print the violation and abort: the default
+  report, // Print the violation and carry on
+  count   // Only count the violations, e.g. for tests
+};
+
+AVND_RT_CHECK_TLS inline thread_local const char* current_scope{};
+AVND_RT_CHECK_TLS inline thread_local int suspended{};
+
+inline std::atomic_int violations{0};
+inline std::atomic<action> on_violation{action::abort};
+
+inline bool checking() noexcept
+{
+  return current_scope && suspended == 0;
+}
+
+// Called by the interceptors; defined in src/realtime_check.cpp
+void violation(const char* what) noexcept;
+
+// Allows a non-realtime call on purpose inside a realtime scope
+struct unchecked_scope
+{
+  unchecked_scope() noexcept { suspended++; }
+  ~unchecked_scope() { suspended--; }
+  unchecked_scope(const unchecked_scope&) = delete;
+  unchecked_scope& operator=(const unchecked_scope&) = delete;
+};
+}
+
+struct realtime_scope
+{
+  // Nested scopes keep the name of the outermost one
+  explicit realtime_scope(const char* name) noexcept
+      : m_previous{rt_check::current_scope}
+  {
+    if (!m_previous)
+      rt_check::current_scope = name;
+  }
+  ~realtime_scope() { rt_check::current_scope = m_previous; }
+
+  realtime_scope(const realtime_scope&) = delete;
+  realtime_scope& operator=(const realtime_scope&) = delete;
+
+private:
+  const char* m_previous{};
+};
+
+#else
+
+namespace rt_check
+{
+struct unchecked_scope
+{
+};
+}
+
+struct realtime_scope
+{
+  explicit constexpr realtime_scope(const char*) noexcept { }
+};
+
+#endif
+}
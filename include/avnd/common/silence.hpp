@@ -0,0 +1,50 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace avnd
+{
+/**
+ * Checks whether a buffer only contains zeros (positive or negative).
+ *
+ * This works on the bit patterns so that the loop gets vectorized
+ * by the compiler; it stops early at the first chunk which has
+ * a non-zero sample, which is the common case for non-silent audio.
+ */
+template <typename FP>
+bool is_silent(const FP* samples, int n) noexcept
+{
+  static_assert(std::is_floating_point_v<FP>);
+  using bits_type = std::conditional_t<sizeof(FP) == 4, uint32_t, uint64_t>;
+  static_assert(sizeof(bits_type) == sizeof(FP));
+  constexpr bits_type no_sign = ~(bits_type(1) << (8 * sizeof(FP) - 1));
+  constexpr int chunk = 64;
+
+  int i = 0;
+  for (; i + chunk <= n; i += chunk)
+  {
+    bits_type acc = 0;
+    for (int k = 0; k < chunk; k++)
+    {
+      bits_type b;
+      std::memcpy(&b, samples + i + k, sizeof(FP));
+      acc |= b;
+    }
+    if (acc & no_sign)
+      return false;
+  }
+
+  bits_type acc = 0;
+  for (; i < n; i++)
+  {
+    bits_type b;
+    std::memcpy(&b, samples + i, sizeof(FP));
+    acc |= b;
+  }
+  return !(acc & no_sign);
+}
+}
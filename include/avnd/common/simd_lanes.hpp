@@ -0,0 +1,131 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <cstddef>
+
+namespace avnd
+{
+// Size in bytes of the widest vector registers we are being compiled for
+#if defined(__AVX512F__)
+static constexpr std::size_t simd_register_size = 64;
+#elif defined(__AVX__)
+static constexpr std::size_t simd_register_size = 32;
+#else
+// SSE2 and NEON
+static constexpr std::size_t simd_register_size = 16;
+#endif
+
+template <typename FP>
+static constexpr int simd_native_lanes = simd_register_size / sizeof(FP);
+
+/**
+ * A minimal "lane-generic" scalar type: N values of type FP,
+ * processed at once with the usual arithmetic operators.
+ *
+ * This allows processors written as templates on their sample type
+ * (e.g. template<typename Sample> Sample operator()(Sample in)) to process
+ * multiple channels in a single pass.
+ */
+template <typename FP, int N>
+struct simd_lanes
+{
+  static constexpr int lanes = N;
+  using value_type = FP;
+
+#if defined(__GNUC__)
+  typedef FP vector_type __attribute__((vector_size(N * sizeof(FP))));
+  vector_type v{};
+
+  constexpr simd_lanes() noexcept = default;
+  constexpr simd_lanes(FP broadcast) noexcept
+      : v{vector_type{} + broadcast}
+  {
+  }
+
+  FP& operator[](int i) noexcept { return reinterpret_cast<FP*>(&v)[i]; }
+  constexpr FP operator[](int i) const noexcept { return v[i]; }
+
+#define AVND_SIMD_LANES_BINARY_OP(op)                                             \
+  friend constexpr simd_lanes operator op(simd_lanes a, simd_lanes b) noexcept  \
+  {                                                                             \
+    a.v = a.v op b.v;                                                           \
+    return a;                                                                   \
+  }                                                                             \
+  friend constexpr simd_lanes operator op(simd_lanes a, FP b) noexcept          \
+  {                                                                             \
+    a.v = a.v op b;                                                             \
+    return a;                                                                   \
+  }                                                                             \
+  friend constexpr simd_lanes operator op(FP a, simd_lanes b) noexcept          \
+  {                                                                             \
+    b.v = a op b.v;                                                             \
+    return b;                                                                   \
+  }                                                                             \
+  constexpr simd_lanes& operator op##=(simd_lanes b) noexcept                  \
+  {                                                                             \
+    v = v op b.v;                                                               \
+    return *this;                                                               \
+  }
+
+  constexpr simd_lanes operator-() const noexcept
+  {
+    simd_lanes r;
+    r.v = -v;
+    return r;
+  }
+#else
+  alignas(N * sizeof(FP)) FP v[N]{};
+
+  constexpr simd_lanes() noexcept = default;
+  constexpr simd_lanes(FP broadcast) noexcept
+  {
+    for (int i = 0; i < N; i++)
+      v[i] = broadcast;
+  }
+
+  constexpr FP& operator[](int i) noexcept { return v[i]; }
+  constexpr FP operator[](int i) const noexcept { return v[i]; }
+
+#define AVND_SIMD_LANES_BINARY_OP(op)                                             \
+  friend constexpr simd_lanes operator op(simd_lanes a, simd_lanes b) noexcept  \
+  {                                                                             \
+    for (int i = 0; i < N; i++)                                                 \
+      a.v[i] = a.v[i] op b.v[i];                                                \
+    return a;                                                                   \
+  }                                                                             \
+  friend constexpr simd_lanes operator op(simd_lanes a, FP b) noexcept          \
+  {                                                                             \
+    for (int i = 0; i < N; i++)                                                 \
+      a.v[i] = a.v[i] op b;                                                     \
+    return a;                                                                   \
+  }                                                                             \
+  friend constexpr simd_lanes operator op(FP a, simd_lanes b) noexcept          \
+  {                                                                             \
+    for (int i = 0; i < N; i++)                                                 \
+      b.v[i] = a op b.v[i];                                                     \
+    return b;                                                                   \
+  }                                                                             \
+  constexpr simd_lanes& operator op##=(simd_lanes b) noexcept                  \
+  {                                                                             \
+    for (int i = 0; i < N; i++)                                                 \
+      v[i] = v[i] op b.v[i];                                                    \
+    return *this;                                                               \
+  }
+
+  constexpr simd_lanes operator-() const noexcept
+  {
+    simd_lanes r;
+    for (int i = 0; i < N; i++)
+      r.v[i] = -v[i];
+    return r;
+  }
+#endif
+
+  AVND_SIMD_LANES_BINARY_OP(+)
+  AVND_SIMD_LANES_BINARY_OP(-)
+  AVND_SIMD_LANES_BINARY_OP(*)
+  AVND_SIMD_LANES_BINARY_OP(/)
+#undef AVND_SIMD_LANES_BINARY_OP
+};
+}
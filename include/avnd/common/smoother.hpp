@@ -0,0 +1,132 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <algorithm>
+#include <cmath>
+
+namespace avnd
+{
+enum class smoothing_mode
+{
+  linear,     // Constant slope, reaches the target after the smoothing time
+  exponential // One-pole, reaches 99% of the target after the smoothing time
+};
+
+struct smoothing
+{
+  double milliseconds{};
+  smoothing_mode mode{smoothing_mode::linear};
+};
+
+/**
+ * Ramps from a value to the next one, e.g. to avoid zipper noise
+ * when a control changes.
+ *
+ * It can be used one sample at a time with next(),
+ * or to fill a buffer with the values of the following frames.
+ */
+template <typename FP>
+struct smoother
+{
+  // ln(100): after the smoothing time, 1% of the distance remains
+  static constexpr double exponential_time_constants = 4.605170185988091;
+
+  void setup(smoothing s, double rate) noexcept
+  {
+    m_mode = s.mode;
+    m_length = std::max(1, int(std::round(s.milliseconds * rate / 1000.)));
+    m_coefficient = FP(std::exp(-exponential_time_constants / m_length));
+    m_remaining = 0;
+    m_current = m_target;
+  }
+
+  void reset(FP value) noexcept
+  {
+    m_current = value;
+    m_target = value;
+    m_remaining = 0;
+  }
+
+  void set_target(FP target) noexcept
+  {
+    if (target == m_target)
+      return;
+    m_target = target;
+    if (m_mode == smoothing_mode::linear)
+    {
+      m_remaining = m_length;
+      m_step = (m_target - m_current) / FP(m_length);
+    }
+    else
+    {
+      // At twice the smoothing time the distance is down to 0.01%: snap there
+      m_remaining = 2 * m_length;
+    }
+  }
+
+  FP current() const noexcept { return m_current; }
+  FP target() const noexcept { return m_target; }
+  bool settled() const noexcept { return m_remaining == 0; }
+
+  FP next() noexcept
+  {
+    if (m_remaining == 0)
+      return m_current;
+
+    if (--m_remaining == 0)
+      m_current = m_target;
+    else if (m_mode == smoothing_mode::linear)
+      m_current += m_step;
+    else
+      m_current = m_target + (m_current - m_target) * m_coefficient;
+    return m_current;
+  }
+
+  // The values of the next n frames, i.e. n calls to next()
+  void fill(FP* out, int n) noexcept
+  {
+    int i = 0;
+    if (m_remaining > 0)
+    {
+      const int ramp = std::min(n, m_remaining - 1);
+      if (m_mode == smoothing_mode::linear)
+      {
+        // Closed form so that the loop can be vectorized
+        const FP start = m_current;
+        const FP step = m_step;
+        for (int k = 0; k < ramp; k++)
+          out[k] = start + step * FP(k + 1);
+        if (ramp > 0)
+          m_current = out[ramp - 1];
+      }
+      else
+      {
+        FP current = m_current;
+        for (int k = 0; k < ramp; k++)
+          out[k] = current = m_target + (current - m_target) * m_coefficient;
+        m_current = current;
+      }
+      m_remaining -= ramp;
+      i = ramp;
+
+      if (i < n)
+      {
+        // Last frame of the ramp
+        m_remaining = 0;
+        m_current = m_target;
+      }
+    }
+    std::fill(out + i, out + n, m_current);
+  }
+
+private:
+  FP m_current{};
+  FP m_target{};
+  FP m_step{};
+  FP m_coefficient{};
+  int m_length{1};
+  int m_remaining{};
+  smoothing_mode m_mode{smoothing_mode::linear};
+};
+}
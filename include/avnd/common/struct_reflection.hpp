@@ -2,9 +2,10 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
-#include <avnd/common/coroutines.hpp>
+#include <avnd/common/member_range.hpp>
 #include <avnd/common/dummy.hpp>
 #include <avnd/common/errors.hpp>
+#include <avnd/common/for_nth.hpp>
 #include <avnd/common/index_sequence.hpp>
 #include <avnd/common/aggregates.hpp>
 #include <boost/mp11.hpp>
@@ -106,19 +107,14 @@ struct fields_introspection
 
   static constexpr void for_nth(int n, auto&& func) noexcept
   {
-    // TODO maybe there is some dirty hack to do here with offsetof computations...
-    // technically, we ought to be able to compute the address of member "n" at compile time...
-    // and reinterpret_cast &fields+addr....
-
     if constexpr (size > 0)
     {
-      [ n, &func ]<typename K, K... Index>(std::integer_sequence<K, Index...>)
-      {
-        // TODO compare with || logical-or fold ?
-        ((void)(Index == n && (func(field_reflection<Index, pfr::tuple_element_t<Index, type>>{}), true)),
-         ...);
-      }
-      (indices_n{});
+      avnd::index_dispatch(
+          n,
+          [&func]<auto Index>() {
+            func(field_reflection<Index, pfr::tuple_element_t<Index, type>>{});
+          },
+          indices_n{});
     }
   }
 
@@ -142,30 +138,20 @@ struct fields_introspection
 
   static constexpr void for_nth(type& fields, int n, auto&& func) noexcept
   {
-    // TODO maybe there is some dirty hack to do here with offsetof computations...
-    // technically, we ought to be able to compute the address of member "n" at compile time...
-    // and reinterpret_cast &fields+addr....
-
     if constexpr (size > 0)
     {
-#if AVND_USE_BOOST_PFR
-      [ n, &func, &fields ]<typename K, K... Index>(std::integer_sequence<K, Index...>)
-      {
-        auto&& ppl = pfr::detail::tie_as_tuple(fields);
-        // TODO compare with || logical-or fold ?
-        ((void)(Index == n && (func(pfr::detail::sequence_tuple::get<Index>(ppl)), true)),
-         ...);
-      }
-      (indices_n{});
-#else
-      [ n, &func, &fields ]<typename K, K... Index>(std::integer_sequence<K, Index...>)
-      {
-        auto&& [...elts] = fields;
-        // TODO compare with || logical-or fold ?
-        ((void)(Index == n && (func(elts), true)), ...);
-      }
-      (indices_n{});
-#endif
+      avnd::index_dispatch(
+          n, [&func, &fields]<auto Index>() { func(pfr::get<Index>(fields)); },
+          indices_n{});
+    }
+  }
+
+  static constexpr void
+  for_nth(multi_instance_range auto&& fields, int n, auto&& func) noexcept
+  {
+    for (auto& m : fields)
+    {
+      for_nth(m, n, func);
     }
   }
 };
@@ -204,6 +190,17 @@ struct predicate_introspection
   static constexpr auto index_map = integer_sequence_to_array(indices_n{});
   static constexpr auto size = indices_n::size();
 
+  // Inverse of index_map, with -1 for the fields which do not match the predicate
+  static constexpr auto field_index_map = []
+  {
+    std::array<int, pfr::tuple_size_v<type>> m{};
+    for (auto& i : m)
+      i = -1;
+    for (std::size_t k = 0; k < size; k++)
+      m[index_map[k]] = int(k);
+    return m;
+  }();
+
   // TODO consteval when clang < 14 is dropped
   template<std::size_t Idx>
   static constexpr int map() noexcept {
@@ -226,8 +223,10 @@ struct predicate_introspection
   static constexpr auto index_to_field_index(int pred_idx) noexcept {
       return index_map[pred_idx];
   }
-  static constexpr auto field_index_to_index(int field_idx) noexcept {
-      return avnd::index_of_element(field_idx, indices_n{});
+  static constexpr int field_index_to_index(int field_idx) noexcept {
+      if (field_idx < 0 || std::size_t(field_idx) >= field_index_map.size())
+        return -1;
+      return field_index_map[field_idx];
   }
 
   static constexpr void for_all(auto&& func) noexcept
@@ -245,16 +244,7 @@ struct predicate_introspection
   // n is in [0; total number of ports[ (even those that don't match the predicate)
   static constexpr void for_nth_raw(int n, auto&& func) noexcept
   {
-    if constexpr (size > 0)
-    {
-      [ n, &func ]<typename K, K... Index>(std::integer_sequence<K, Index...>)
-      {
-        // TODO compare with || logical-or fold ?
-        ((void)(Index == n && (func(field_reflection<Index, pfr::tuple_element_t<Index, T>>{}), true)),
-         ...);
-      }
-      (indices_n{});
-    }
+    for_nth_mapped(field_index_to_index(n), func);
   }
 
   // n is in [0; number of ports matching that predicate[
@@ -262,14 +252,12 @@ struct predicate_introspection
   {
     if constexpr (size > 0)
     {
-      [ k = index_map[n], &
-        func ]<typename K, K... Index>(std::integer_sequence<K, Index...>)
-      {
-        // TODO compare with || logical-or fold ?
-        ((void)(Index == k && (func(field_reflection<Index, pfr::tuple_element_t<Index, T>>{}), true)),
-         ...);
-      }
-      (indices_n{});
+      avnd::index_dispatch(
+          n,
+          [&func]<auto Index>() {
+            func(field_reflection<Index, pfr::tuple_element_t<Index, T>>{});
+          },
+          indices_n{});
     }
   }
 
@@ -327,27 +315,8 @@ struct predicate_introspection
     }
   }
 
-  template <typename U>
-  static constexpr void
-  for_all(member_iterator<U>&& unfiltered_fields, auto&& func) noexcept
-  {
-    if constexpr (size > 0)
-    {
-      [&func, &
-       unfiltered_fields ]<typename K, K... Index>(std::integer_sequence<K, Index...>)
-      {
-        for (auto& m : unfiltered_fields)
-        {
-          (func(pfr::get<Index>(m)), ...);
-        }
-      }
-      (indices_n{});
-    }
-  }
-
-  template <typename U>
   static constexpr void
-  for_all(member_iterator<U>& unfiltered_fields, auto&& func) noexcept
+  for_all(multi_instance_range auto&& unfiltered_fields, auto&& func) noexcept
   {
     if constexpr (size > 0)
     {
@@ -400,9 +369,8 @@ struct predicate_introspection
     }
   }
 
-  template <typename U>
   static constexpr void
-  for_all_n(member_iterator<U> unfiltered_fields, auto&& func) noexcept
+  for_all_n(multi_instance_range auto&& unfiltered_fields, auto&& func) noexcept
   {
     if constexpr (size > 0)
     {
@@ -441,9 +409,9 @@ struct predicate_introspection
     }
   }
 
-  template <typename U>
+  template <multi_instance_range U>
   static constexpr bool
-  for_all_unless(member_iterator<U> unfiltered_fields, auto&& func) noexcept
+  for_all_unless(U&& unfiltered_fields, auto&& func) noexcept
   {
     if constexpr (size > 0)
     {
@@ -458,28 +426,16 @@ struct predicate_introspection
 
   static constexpr void for_nth_raw(type& fields, int n, auto&& func) noexcept
   {
-    if constexpr (size > 0)
-    {
-      [ n, &func, &fields ]<typename K, K... Index>(std::integer_sequence<K, Index...>)
-      {
-        ((void)(Index == n && (func(pfr::get<Index>(fields)), true)),
-         ...);
-      }
-      (indices_n{});
-    }
+    for_nth_mapped(fields, field_index_to_index(n), func);
   }
 
   static constexpr void for_nth_mapped(type& fields, int n, auto&& func) noexcept
   {
     if constexpr (size > 0)
     {
-      [ k = index_map[n], &func, &
-        fields ]<typename K, K... Index>(std::integer_sequence<K, Index...>)
-      {
-        ((void)(Index == k && (func(pfr::get<Index>(fields)), true)),
-         ...);
-      }
-      (indices_n{});
+      avnd::index_dispatch(
+          n, [&func, &fields]<auto Index>() { func(pfr::get<Index>(fields)); },
+          indices_n{});
     }
   }
 };
@@ -0,0 +1,263 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/realtime_check.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#include <pthread.h>
+#elif __has_include(<pthread.h>)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace avnd
+{
+inline void cpu_relax() noexcept
+{
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  _mm_pause();
+#elif (defined(__aarch64__) || defined(__arm__)) && (defined(__GNUC__) || defined(__clang__))
+  asm volatile("yield");
+#endif
+}
+
+/**
+ * Gives the calling thread a realtime priority, in the range of the audio threads:
+ * the audio thread waits for the workers of a thread_pool, which must not be
+ * preempted by the normal threads in the meantime.
+ *
+ * Best effort: without the privileges for it, the thread keeps its priority.
+ */
+inline bool set_realtime_priority() noexcept
+{
+#if defined(_WIN32)
+  return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#elif defined(__APPLE__)
+  // Time-constraint threads are the ones which CoreAudio uses
+  mach_timebase_info_data_t timebase{};
+  mach_timebase_info(&timebase);
+  const double ms = 1e6 * double(timebase.denom) / double(timebase.numer);
+  thread_time_constraint_policy_data_t policy{};
+  policy.period = 0;
+  policy.computation = uint32_t(1. * ms);
+  policy.constraint = uint32_t(2. * ms);
+  policy.preemptible = true;
+  return thread_policy_set(
+             pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+             (thread_policy_t)&policy, THREAD_TIME_CONSTRAINT_POLICY_COUNT)
+         == KERN_SUCCESS;
+#elif __has_include(<pthread.h>)
+  sched_param param{};
+  param.sched_priority = std::clamp(
+      80, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+  return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Something which can run a batch of independent tasks, possibly in parallel,
+ * e.g. a thread pool or the one of the host.
+ */
+struct parallel_executor
+{
+  using task_type = void (*)(void* context, int index) noexcept;
+
+  virtual ~parallel_executor() = default;
+
+  // Calls task(context, i) for each i in [0, count) and returns once they are all done.
+  // Called from the audio thread.
+  virtual void run(int count, void* context, task_type task) noexcept = 0;
+};
+
+/**
+ * Fixed-size pool of worker threads, usable from the audio thread:
+ * running a batch never locks nor allocates.
+ *
+ * The calling thread works on the batch too; the tasks are handed out one by one
+ * through an atomic counter, so that a worker which is done takes the next
+ * available task. Between batches, the workers spin for a short while
+ * before going to sleep on an atomic wait. They run with a realtime priority,
+ * see set_realtime_priority.
+ *
+ * A pool can be shared by processors running on different audio threads,
+ * see shared_thread_pool: when a batch is already running, the tasks
+ * of the other one are run by the calling thread.
+ */
+class thread_pool final : public parallel_executor
+{
+public:
+  explicit thread_pool(int workers)
+  {
+    m_threads.reserve(std::max(0, workers));
+    for (int i = 0; i < workers; i++)
+      m_threads.emplace_back([this] {
+        set_realtime_priority();
+        worker();
+      });
+  }
+
+  ~thread_pool()
+  {
+    m_stop.store(true);
+    m_generation.fetch_add(2);
+    m_generation.notify_all();
+    for (auto& t : m_threads)
+      t.join();
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  int workers() const noexcept { return m_threads.size(); }
+
+  void run(int count, void* context, task_type task) noexcept override
+  {
+    if (count <= 0)
+      return;
+
+    // The workers are busy with the batch of another audio thread
+    if (m_threads.empty() || count == 1 || m_busy.test_and_set(std::memory_order_acquire))
+    {
+      for (int i = 0; i < count; i++)
+        task(context, i);
+      return;
+    }
+
+    // Odd generation: the batch is being written, the workers keep off.
+    // Wait for those still looking at the previous batch to leave it.
+    m_generation.fetch_add(1);
+    while (m_active.load() != 0)
+      cpu_relax();
+
+    m_count = count;
+    m_context = context;
+    m_task = task;
+    m_next.store(0, std::memory_order_relaxed);
+    m_done.store(0, std::memory_order_relaxed);
+
+    // Even generation: the batch is ready
+    m_generation.fetch_add(1);
+    m_generation.notify_all();
+
+    work();
+    while (m_done.load(std::memory_order_acquire) != count)
+      cpu_relax();
+
+    m_busy.clear(std::memory_order_release);
+  }
+
+private:
+  // Runs tasks of the current batch until there are none left
+  void work() noexcept
+  {
+    for (int i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count;
+         i = m_next.fetch_add(1, std::memory_order_relaxed))
+    {
+      m_task(m_context, i);
+      m_done.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  void worker() noexcept
+  {
+    static constexpr int spin_count = 4096;
+    uint32_t seen = m_generation.load();
+    while (!m_stop.load(std::memory_order_relaxed))
+    {
+      // Wait for a new batch: spin first, as they come at each audio buffer
+      uint32_t current = m_generation.load(std::memory_order_relaxed);
+      for (int i = 0; i < spin_count && (current == seen || current % 2 == 1); i++)
+      {
+        cpu_relax();
+        current = m_generation.load(std::memory_order_relaxed);
+      }
+      if (current == seen || current % 2 == 1)
+      {
+        m_generation.wait(current);
+        continue;
+      }
+
+      // Enter the batch, unless a new one started being written in-between
+      m_active.fetch_add(1);
+      if (m_generation.load() == current)
+      {
+        seen = current;
+        if (!m_stop.load(std::memory_order_relaxed))
+        {
+          [[maybe_unused]] realtime_scope realtime{"thread_pool"};
+          work();
+        }
+      }
+      m_active.fetch_sub(1);
+    }
+  }
+
+  std::vector<std::thread> m_threads;
+
+  alignas(64) std::atomic<uint32_t> m_generation{0};
+  alignas(64) std::atomic<int> m_active{0};
+  alignas(64) std::atomic<int> m_next{0};
+  alignas(64) std::atomic<int> m_done{0};
+  std::atomic_bool m_stop{false};
+  std::atomic_flag m_busy = ATOMIC_FLAG_INIT;
+
+  // The current batch
+  int m_count{};
+  void* m_context{};
+  task_type m_task{};
+};
+
+/**
+ * The thread pool shared by all the processors of the process: it is created
+ * when the first processor needs it, and destroyed when the last one lets go of it.
+ * One pool for hundreds of instances, instead of a pool per instance,
+ * avoids having thousands of threads spinning and fighting over the cores.
+ *
+ * When a processor needs more workers than the current pool has, a larger pool
+ * becomes the current one; the processors holding the previous one keep using it
+ * until they acquire a pool again.
+ *
+ * acquire() locks and creates threads: it must only be called from
+ * the non-realtime preparation functions.
+ */
+struct shared_thread_pool
+{
+  static std::shared_ptr<thread_pool> acquire(int workers)
+  {
+    static std::mutex mutex;
+    static std::weak_ptr<thread_pool> current;
+
+    std::lock_guard lock{mutex};
+    auto pool = current.lock();
+    if (pool && pool->workers() >= workers)
+      return pool;
+
+    pool = std::make_shared<thread_pool>(workers);
+    current = pool;
+    return pool;
+  }
+};
+}
@@ -0,0 +1,316 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <string_view>
+
+#if defined(AVND_TRACE)
+#include <avnd/common/cycle_counter.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#endif
+
+/**
+ * Tracing of what the bindings do: preparation, processing, messages and controls.
+ *
+ * When building with AVND_TRACE defined (see the AVENDISH_TRACE CMake option),
+ * each avnd::trace_span records the time spent in its scope. The spans go into
+ * a ring buffer per thread, without locks nor allocations, and a background
+ * thread of the avnd::trace_session writes them to a file in the Chrome trace
+ * event format, which chrome://tracing and https://ui.perfetto.dev open.
+ *
+ * Otherwise, both are empty objects.
+ */
+namespace avnd
+{
+#if defined(AVND_TRACE)
+namespace trace
+{
+// The strings must outlive the session, e.g. literals or processor names
+struct event
+{
+  std::string_view name;
+  std::string_view detail;
+  uint64_t begin{};
+  uint64_t end{};
+};
+
+/**
+ * Single-producer, single-consumer ring of events:
+ * the thread it belongs to pushes, the session thread pops.
+ */
+class ring
+{
+public:
+  ring(int capacity, int thread)
+      : m_events{std::make_unique<event[]>(capacity)}
+      , m_mask(capacity - 1)
+      , m_thread{thread}
+  {
+  }
+
+  int thread() const noexcept { return m_thread; }
+  uint32_t dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+  void push(const event& e) noexcept
+  {
+    const uint32_t w = m_write.load(std::memory_order_relaxed);
+    if (w - m_read.load(std::memory_order_acquire) > m_mask)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    m_events[w & m_mask] = e;
+    m_write.store(w + 1, std::memory_order_release);
+  }
+
+  void pop_all(auto&& f)
+  {
+    uint32_t r = m_read.load(std::memory_order_relaxed);
+    const uint32_t w = m_write.load(std::memory_order_acquire);
+    for (; r != w; r++)
+      f(m_events[r & m_mask]);
+    m_read.store(r, std::memory_order_release);
+  }
+
+private:
+  std::unique_ptr<event[]> m_events;
+  uint32_t m_mask{};
+  int m_thread{};
+  std::atomic<uint32_t> m_write{};
+  std::atomic<uint32_t> m_read{};
+  std::atomic<uint32_t> m_dropped{};
+};
+
+class session;
+inline std::atomic<session*> current_session{};
+inline std::atomic<uint64_t> session_count{};
+
+/**
+ * Owns the rings of all the threads and the file they are written to.
+ * The rings are allocated up-front: a thread takes the next free one the
+ * first time it records a span, and threads past the limit are not traced.
+ *
+ * There is one session at a time, which must outlive the processing.
+ */
+class session
+{
+public:
+  struct options
+  {
+    int max_threads = 64;
+    int events_per_thread = 1 << 14; // must be a power of two
+    std::chrono::milliseconds flush_interval{20};
+  };
+
+  explicit session(const std::string& path) : session{path, options{}} { }
+  session(const std::string& path, options opts)
+      : m_file{std::fopen(path.c_str(), "w")}
+      , m_options{opts}
+      , m_id{++session_count}
+      , m_origin{cycle_counter::now()}
+      , m_ns_per_tick{cycle_counter::ns_per_tick()}
+  {
+    if (!m_file)
+    {
+      std::fprintf(stderr, "avnd: cannot write the trace to %s\n", path.c_str());
+      return;
+    }
+
+    m_rings.reserve(opts.max_threads);
+    for (int i = 0; i < opts.max_threads; i++)
+      m_rings.push_back(std::make_unique<ring>(opts.events_per_thread, i + 1));
+
+    std::fputs("{\"traceEvents\":[\n", m_file);
+    m_thread = std::thread{[this] { run(); }};
+
+    session* expected = nullptr;
+    if (!current_session.compare_exchange_strong(expected, this))
+      std::fprintf(stderr, "avnd: a trace session is already running\n");
+  }
+
+  ~session()
+  {
+    if (!m_file)
+      return;
+
+    session* self = this;
+    current_session.compare_exchange_strong(self, nullptr);
+    {
+      std::lock_guard _{m_mutex};
+      m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+
+    flush();
+    uint32_t dropped = 0;
+    for (auto& r : m_rings)
+      dropped += r->dropped();
+    std::fputs("\n],\"displayTimeUnit\":\"ns\"}\n", m_file);
+    std::fclose(m_file);
+    if (dropped > 0)
+      std::fprintf(stderr, "avnd: %u trace events were dropped\n", dropped);
+  }
+
+  session(const session&) = delete;
+  session& operator=(const session&) = delete;
+
+  // The ring of the calling thread, or nullptr if there are none left
+  ring* thread_ring() noexcept
+  {
+    static thread_local ring* r{};
+    static thread_local uint64_t owner{};
+    if (owner != m_id)
+    {
+      owner = m_id;
+      const int index = m_next_ring.fetch_add(1, std::memory_order_relaxed);
+      r = index < int(m_rings.size()) ? m_rings[index].get() : nullptr;
+    }
+    return r;
+  }
+
+private:
+  void run()
+  {
+    std::unique_lock lock{m_mutex};
+    while (!m_stop)
+    {
+      m_wake.wait_for(lock, m_options.flush_interval);
+      flush();
+    }
+  }
+
+  static void write_string(std::FILE* f, std::string_view str)
+  {
+    std::fputc('"', f);
+    for (char c : str)
+    {
+      if (c == '"' || c == '\\')
+        std::fputc('\\', f);
+      if (uint8_t(c) >= 0x20)
+        std::fputc(c, f);
+    }
+    std::fputc('"', f);
+  }
+
+  void flush()
+  {
+    const int used = std::min(int(m_rings.size()), m_next_ring.load());
+    for (int i = 0; i < used; i++)
+    {
+      m_rings[i]->pop_all([this, tid = m_rings[i]->thread()](const event& e) {
+        const double ts = double(int64_t(e.begin - m_origin)) * m_ns_per_tick / 1000.;
+        const double dur = double(e.end - e.begin) * m_ns_per_tick / 1000.;
+        std::fputs(m_first ? "" : ",\n", m_file);
+        m_first = false;
+        std::fputs("{\"name\":", m_file);
+        write_string(m_file, e.name);
+        std::fprintf(
+            m_file, ",\"cat\":\"avnd\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d",
+            ts, dur, tid);
+        if (!e.detail.empty())
+        {
+          std::fputs(",\"args\":{\"processor\":", m_file);
+          write_string(m_file, e.detail);
+          std::fputc('}', m_file);
+        }
+        std::fputc('}', m_file);
+      });
+    }
+    std::fflush(m_file);
+  }
+
+  std::FILE* m_file{};
+  options m_options;
+  uint64_t m_id{};
+  uint64_t m_origin{};
+  double m_ns_per_tick{1.};
+  bool m_first{true};
+
+  std::vector<std::unique_ptr<ring>> m_rings;
+  std::atomic_int m_next_ring{};
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  bool m_stop{};
+};
+}
+
+struct trace_span
+{
+  explicit trace_span(std::string_view name, std::string_view detail = {}) noexcept
+      : m_session{trace::current_session.load(std::memory_order_acquire)}
+      , m_event{name, detail}
+  {
+    if (m_session)
+      m_event.begin = cycle_counter::now();
+  }
+
+  ~trace_span()
+  {
+    if (m_session)
+    {
+      m_event.end = cycle_counter::now();
+      if (auto* r = m_session->thread_ring())
+        r->push(m_event);
+    }
+  }
+
+  trace_span(const trace_span&) = delete;
+  trace_span& operator=(const trace_span&) = delete;
+
+private:
+  trace::session* m_session{};
+  trace::event m_event;
+};
+
+/**
+ * Traces the whole program while it exists, e.g. in main():
+ * the file is given by the AVND_TRACE_FILE environment variable,
+ * or else the default path.
+ */
+struct trace_session
+{
+  explicit trace_session(std::string_view default_path)
+      : m_session{path(default_path)}
+  {
+  }
+
+private:
+  static std::string path(std::string_view default_path)
+  {
+    if (const char* env = std::getenv("AVND_TRACE_FILE"); env && *env)
+      return env;
+    return std::string{default_path};
+  }
+
+  trace::session m_session;
+};
+
+#else
+
+struct trace_span
+{
+  explicit constexpr trace_span(std::string_view, std::string_view = {}) noexcept { }
+};
+
+struct trace_session
+{
+  explicit constexpr trace_session(std::string_view) noexcept { }
+};
+
+#endif
+}
@@ -2,6 +2,7 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later OR BSL-1.0 OR CC0-1.0 OR CC-PDCC OR 0BSD */
 
+#include <concepts>
 #include <iterator>
 
 namespace avnd
@@ -24,4 +25,71 @@ concept can_prepare = requires(T t)
   t.prepare({});
 };
 
+/**
+ * Processors which only read the "value" of their sample-accurate controls,
+ * but still want changes to be applied at the right sample:
+ * the process call gets split at each timestamped control change.
+ *
+ *   halp_flag(split_at_control_changes);
+ */
+template <typename T>
+concept splits_at_control_changes = requires { T::split_at_control_changes; };
+
+/**
+ * Processors whose output is silent as soon as their input is,
+ * e.g. a gain or a distortion: the process call can be skipped
+ * entirely for silent input blocks.
+ *
+ *   halp_flag(silence_in_silence_out);
+ */
+template <typename T>
+concept silence_in_silence_out = requires { T::silence_in_silence_out; };
+
+/**
+ * Monophonic processors duplicated per channel whose instances
+ * can run in parallel, e.g. for a lot of channels or expensive instances:
+ *
+ *   halp_flag(parallel_channels);
+ *
+ * The number of worker threads can be fixed with:
+ *
+ *   static constexpr int parallel_workers = 4;
+ */
+template <typename T>
+concept parallel_channels_processor = requires { T::parallel_channels; };
+
+/**
+ * Nonlinear processors can ask to run at a multiple of the host rate,
+ * to reduce aliasing:
+ *
+ *   static constexpr int oversampling = 4; // 2, 4 or 8
+ *
+ * They then see the oversampled rate and frame counts in prepare()
+ * and operator().
+ * Other factors do not compile.
+ */
+template <typename T>
+concept oversampled_processor = requires {
+  { T::oversampling } -> std::convertible_to<int>;
+};
+
+constexpr bool supported_oversampling_factor(int factor) noexcept
+{
+  return factor == 2 || factor == 4 || factor == 8;
+}
+
+template <typename T>
+constexpr int oversampling_factor() noexcept
+{
+  if constexpr (oversampled_processor<T>)
+  {
+    static_assert(
+        supported_oversampling_factor(T::oversampling),
+        "Unsupported oversampling factor: it must be 2, 4 or 8");
+    return T::oversampling;
+  }
+  else
+    return 1;
+}
+
 }
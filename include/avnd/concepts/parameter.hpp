@@ -84,6 +84,34 @@ concept parameter_with_minmax_range = requires
   avnd::get_range<C>().init;
 };
 
+/**
+ * A numeric control whose range is not mapped linearly to the [0; 1] range
+ * of the hosts, e.g. halp::log_hslider_f32:
+ *
+ *   struct normalize {
+ *     static constexpr double map(double min, double max, double v) { ... }
+ *   };
+ *
+ * map goes from [0; 1] to [min; max], see halp/mappings.hpp.
+ */
+template <typename T>
+concept mapped_parameter
+    = (float_parameter<T> || int_parameter<T>) && parameter_with_minmax_range<T>
+      && has_normalize<T> && requires(double v) {
+           { avnd::get_normalize<T>().map(v, v, v) } -> std::convertible_to<double>;
+         };
+
+/**
+ * A parameter with a hook that the bindings call on each instance of the
+ * processor when its value changes, in the audio thread, before processing:
+ *
+ *   struct : halp::knob_f32<"Cutoff"> {
+ *     void update(MyFilter& self) { self.recompute_coefficients(); }
+ *   } cutoff;
+ */
+template <typename C, typename T>
+concept parameter_with_update = parameter<C> && requires(C& c, T& t) { c.update(t); };
+
 /**
  * A "control" is a parameter + some metadata:
  *
@@ -137,6 +165,28 @@ concept string_value_port = string_parameter<T> && !control<T>;
 template <typename T>
 concept value_port = parameter<T> && !control<T>;
 
+/**
+ * An output parameter that the bindings set to the DSP load of the processor,
+ * in percent of the block deadline, e.g. halp::dsp_load_bar.
+ */
+template <typename T>
+concept dsp_load_parameter = float_parameter<T> && requires { T::dsp_load; };
+
+/**
+ * A float input which the bindings ramp towards its value, e.g. halp::smooth:
+ *
+ *   static constexpr avnd::smoothing smoothing{.milliseconds = 20.};
+ *   std::span<const float> ramp;
+ *
+ * ramp is set before each process call to the values of each frame of the block.
+ */
+template <typename T>
+concept smooth_parameter = float_parameter<T> && requires(T t) {
+  T::smoothing.milliseconds;
+  T::smoothing.mode;
+  t.ramp = {};
+};
+
 /**
  * Timed values are used for sample-accurate ports.
  * That is, ports where the time (sample) at which the value
@@ -90,10 +90,20 @@ template <typename FP, typename T>
 concept polyphonic_single_port_audio_effect = poly_sample_array_input_port_count<FP, T>
 == 1 && poly_sample_array_output_port_count<FP, T> == 1;
 
+// void operator()(FP* in, FP* out, [const inputs&], [outputs&], int frames);
 template <typename FP, typename T>
 concept monophonic_arg_audio_effect = requires(T t)
 {
   t.operator()((FP*)nullptr, (FP*)nullptr, (int32_t)0);
+} || requires(T t, const typename T::inputs& ins)
+{
+  t.operator()((FP*)nullptr, (FP*)nullptr, ins, (int32_t)0);
+} || requires(T t, typename T::outputs& outs)
+{
+  t.operator()((FP*)nullptr, (FP*)nullptr, outs, (int32_t)0);
+} || requires(T t, const typename T::inputs& ins, typename T::outputs& outs)
+{
+  t.operator()((FP*)nullptr, (FP*)nullptr, ins, outs, (int32_t)0);
 };
 
 template <typename FP, typename T>
@@ -22,6 +22,12 @@ struct control_input_introspection : control_introspection<typename inputs_type<
 {
 };
 
+template <typename T>
+struct smooth_parameter_input_introspection
+    : smooth_parameter_introspection<typename inputs_type<T>::type>
+{
+};
+
 template <typename T>
 struct linear_timed_parameter_input_introspection
     : linear_timed_parameter_introspection<typename inputs_type<T>::type>
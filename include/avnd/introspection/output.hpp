@@ -22,6 +22,12 @@ struct control_output_introspection
 {
 };
 
+template <typename T>
+struct dsp_load_output_introspection
+    : dsp_load_parameter_introspection<typename outputs_type<T>::type>
+{
+};
+
 template <typename T>
 struct linear_timed_parameter_output_introspection
     : linear_timed_parameter_introspection<typename outputs_type<T>::type>
@@ -34,6 +34,17 @@ struct control_introspection : predicate_introspection<T, is_control_t>
 {
 };
 
+template <typename Field>
+using is_dsp_load_parameter_t = boost::mp11::mp_bool<dsp_load_parameter<Field>>;
+template <typename T>
+using dsp_load_parameter_introspection
+    = predicate_introspection<T, is_dsp_load_parameter_t>;
+
+template <typename Field>
+using is_smooth_parameter_t = boost::mp11::mp_bool<smooth_parameter<Field>>;
+template <typename T>
+using smooth_parameter_introspection = predicate_introspection<T, is_smooth_parameter_t>;
+
 template <typename Field>
 using is_linear_timed_parameter_t
     = boost::mp11::mp_bool<linear_sample_accurate_parameter<Field>>;
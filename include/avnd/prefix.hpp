@@ -2,17 +2,35 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
+#include <avnd/common/aligned_allocator.hpp>
+#include <avnd/common/atomic_bitset.hpp>
 #include <avnd/common/concepts_polyfill.hpp>
+#include <avnd/common/constexpr_math.hpp>
+#include <avnd/common/convert_samples.hpp>
 #include <avnd/common/coroutines.hpp>
+#include <avnd/common/cycle_counter.hpp>
+#include <avnd/common/denormals.hpp>
+#include <avnd/common/dsp_load.hpp>
 #include <avnd/common/dummy.hpp>
 #include <avnd/common/export.hpp>
+#include <avnd/common/flat_aggregate.hpp>
 #include <avnd/common/for_nth.hpp>
 #include <avnd/common/function_reflection.hpp>
+#include <avnd/common/halfband.hpp>
 #include <avnd/common/index_sequence.hpp>
 #include <avnd/common/limited_string.hpp>
 #include <avnd/common/limited_string_view.hpp>
+#include <avnd/common/log_queue.hpp>
+#include <avnd/common/member_range.hpp>
+#include <avnd/common/perfect_hash.hpp>
+#include <avnd/common/realtime_check.hpp>
+#include <avnd/common/silence.hpp>
+#include <avnd/common/simd_lanes.hpp>
+#include <avnd/common/smoother.hpp>
 #include <avnd/common/span_polyfill.hpp>
 #include <avnd/common/struct_reflection.hpp>
+#include <avnd/common/thread_pool.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/common/widechar.hpp>
 #include <avnd/concepts/all.hpp>
 #include <avnd/concepts/audio_port.hpp>
@@ -34,11 +52,14 @@
 #include <halp/controls.hpp>
 #include <halp/layout.hpp>
 #include <halp/log.hpp>
+#include <halp/mappings.hpp>
 #include <halp/messages.hpp>
 #include <halp/meta.hpp>
 #include <halp/midi.hpp>
 #include <halp/reactive_value.hpp>
+#include <halp/realtime_log.hpp>
 #include <halp/sample_accurate_controls.hpp>
+#include <halp/smooth.hpp>
 #include <halp/static_string.hpp>
 #include <halp/texture.hpp>
 #include <avnd/introspection/channels.hpp>
@@ -51,15 +72,28 @@
 #include <avnd/wrappers/audio_channel_manager.hpp>
 #include <avnd/wrappers/avnd.hpp>
 #include <avnd/wrappers/bus_host_process_adapter.hpp>
+#include <avnd/wrappers/chain.hpp>
 #include <avnd/wrappers/configure.hpp>
 #include <avnd/wrappers/control_display.hpp>
 #include <avnd/wrappers/controls.hpp>
 #include <avnd/wrappers/controls_double.hpp>
 #include <avnd/wrappers/controls_fp.hpp>
 #include <avnd/wrappers/controls_storage.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
 #include <avnd/wrappers/effect_container.hpp>
+#include <avnd/wrappers/fixed_block_process_adapter.hpp>
+#include <avnd/wrappers/latency.hpp>
+#include <avnd/wrappers/mapping.hpp>
 #include <avnd/wrappers/metadatas.hpp>
+#include <avnd/wrappers/oversampling_process_adapter.hpp>
+#include <avnd/wrappers/parallel_channels.hpp>
 #include <avnd/wrappers/prepare.hpp>
 #include <avnd/wrappers/process_adapter.hpp>
 #include <avnd/wrappers/process_execution.hpp>
+#include <avnd/wrappers/silence_process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
+#include <avnd/wrappers/sub_block_process_adapter.hpp>
+#include <avnd/wrappers/symbol_table.hpp>
+#include <avnd/wrappers/timed_values.hpp>
 #include <avnd/wrappers/widgets.hpp>
+#include <avnd/wrappers/zero_buffers.hpp>
@@ -0,0 +1,357 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/aligned_allocator.hpp>
+#include <avnd/common/flat_aggregate.hpp>
+#include <avnd/concepts/audio_processor.hpp>
+#include <avnd/concepts/parameter.hpp>
+#include <avnd/concepts/processor.hpp>
+#include <avnd/introspection/input.hpp>
+#include <avnd/wrappers/effect_container.hpp>
+#include <avnd/wrappers/fixed_block_process_adapter.hpp>
+#include <avnd/wrappers/latency.hpp>
+#include <avnd/wrappers/prepare.hpp>
+#include <boost/mp11.hpp>
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace avnd
+{
+/**
+ * The processors which can be a stage of a chain: monophonic ones taking their
+ * audio as arguments, either one sample at a time or one channel at a time.
+ */
+template <typename FP, typename T>
+concept chain_sample_stage = !has_tick<T> && mono_per_sample_arg_processor<FP, T>;
+
+template <typename FP, typename T>
+concept chain_block_stage = !has_tick<T> && mono_per_channel_arg_processor<FP, T>;
+
+// Per-sample stages are given FP samples even if they work with another type,
+// like when they are used on their own
+template <typename FP, typename T>
+concept chain_stage = chain_sample_stage<float, T> || chain_sample_stage<double, T>
+                      || chain_block_stage<FP, T>;
+
+namespace detail
+{
+template <typename T>
+struct chain_stage_state
+    : inputs_storage<T>
+    , outputs_storage<T>
+{
+  T effect;
+
+  auto& inputs() noexcept
+  {
+    if constexpr (inputs_is_type<T>)
+      return this->inputs_storage;
+    else if constexpr (inputs_is_value<T>)
+      return effect.inputs;
+    else
+      return dummy_instance;
+  }
+
+  auto& outputs() noexcept
+  {
+    if constexpr (outputs_is_type<T>)
+      return this->outputs_storage;
+    else if constexpr (outputs_is_value<T>)
+      return effect.outputs;
+    else
+      return dummy_instance;
+  }
+};
+
+template <bool>
+struct chain_silence_flag
+{
+};
+
+template <>
+struct chain_silence_flag<true>
+{
+  enum
+  {
+    silence_in_silence_out
+  };
+};
+}
+
+/**
+ * Composes monophonic processors into a single one, which runs them one after
+ * the other on each channel:
+ *
+ *   struct MyStrip : avnd::chain<Gain, Filter, Saturation>
+ *   {
+ *     halp_meta(name, "My strip")
+ *     ...
+ *   };
+ *
+ * The inputs of all the stages are exposed as a single "inputs" struct, in order.
+ * Their values are copied to the stages at the start of each block, and the
+ * update() hooks of the stages are called when they change. The stages thus
+ * cannot have smoothed or sample-accurate inputs, nor outputs other than audio.
+ *
+ * Consecutive per-sample stages are fused in a single loop over the samples,
+ * without any buffer in-between. Per-channel stages read and write whole blocks:
+ * they ping-pong between the output buffer and a single scratch buffer.
+ */
+template <typename... Stages>
+struct chain : detail::chain_silence_flag<(avnd::silence_in_silence_out<Stages> && ...)>
+{
+  static_assert(sizeof...(Stages) > 0);
+  static_assert(
+      !(avnd::oversampled_processor<Stages> || ...),
+      "Oversampled processors cannot be part of a chain");
+  static_assert(
+      !(avnd::fixed_block_processor<Stages> || ...),
+      "Fixed-size block processors cannot be part of a chain");
+  static_assert(
+      ((smooth_parameter_input_introspection<Stages>::size == 0) && ...),
+      "Smoothed controls are not supported in a chain");
+  static_assert(
+      ((linear_timed_parameter_input_introspection<Stages>::size == 0
+        && span_timed_parameter_input_introspection<Stages>::size == 0
+        && dynamic_timed_parameter_input_introspection<Stages>::size == 0)
+       && ...),
+      "Sample-accurate controls are not supported in a chain");
+  static_assert(
+      ((outputs_type<Stages>::size == 0) && ...),
+      "The outputs of the stages are not exposed by the chain");
+
+  static constexpr std::size_t stage_count = sizeof...(Stages);
+
+  using inputs_types
+      = boost::mp11::mp_append<typelist<>, typename inputs_type<Stages>::tuple...>;
+  static_assert(
+      boost::mp11::mp_size<inputs_types>::value <= flat_aggregate_max_fields,
+      "Too many inputs in the chain");
+
+  // Index of the first input of each stage in the chain inputs
+  static constexpr std::array<std::size_t, stage_count + 1> input_offsets = [] {
+    const std::size_t sizes[] = {std::size_t(inputs_type<Stages>::size)...};
+    std::array<std::size_t, stage_count + 1> offsets{};
+    for (std::size_t k = 0; k < stage_count; k++)
+      offsets[k + 1] = offsets[k] + sizes[k];
+    return offsets;
+  }();
+
+  using inputs = flat_aggregate<inputs_types>;
+
+  struct outputs
+  {
+  };
+
+  std::tuple<detail::chain_stage_state<Stages>...> stages;
+
+  struct setup
+  {
+    int input_channels{};
+    int output_channels{};
+    int frames{};
+    double rate{};
+  };
+
+  void prepare(setup info)
+  {
+    const process_setup stage_setup{
+        info.input_channels, info.output_channels, info.frames, info.rate};
+    std::apply(
+        [&](auto&... stage) { (avnd::prepare(stage.effect, stage_setup), ...); },
+        stages);
+
+    const int frames = std::max(0, info.frames);
+    if constexpr (segment_count() > 1)
+    {
+      if constexpr ((chain_stage<float, Stages> && ...))
+        m_scratch_f.assign(frames, 0.f);
+      if constexpr ((chain_stage<double, Stages> && ...))
+        m_scratch_d.assign(frames, 0.);
+    }
+  }
+
+  template <std::floating_point FP>
+  requires(chain_stage<FP, Stages>&&...)
+  void operator()(FP* in, FP* out, const inputs& ins, int frames)
+  {
+    copy_inputs(ins, std::make_index_sequence<stage_count>{});
+
+    if constexpr (segment_count() == 1)
+    {
+      run_from<0>(in, out, (FP*)nullptr, frames);
+    }
+    else
+    {
+      auto& scratch = scratch_for(FP{});
+      const int max_frames = scratch.size();
+      if (max_frames == 0)
+      {
+        std::fill_n(out, frames, FP{});
+        return;
+      }
+
+      // Hosts may send more frames than announced
+      for (int done = 0; done < frames; done += max_frames)
+      {
+        const int n = std::min(frames - done, max_frames);
+        run_from<0>(in + done, out + done, scratch.data(), n);
+      }
+    }
+  }
+
+  int latency() const noexcept requires(avnd::has_latency<Stages> || ...)
+  {
+    return std::apply(
+        [](const auto&... stage) { return (avnd::get_latency(stage.effect) + ...); },
+        stages);
+  }
+
+  int64_t tail() const noexcept requires(avnd::has_tail<Stages> || ...)
+  {
+    int64_t total = 0;
+    auto add = [&](const auto& stage) {
+      const uint32_t tail = avnd::get_tail(stage.effect);
+      total = (tail == infinite_tail) ? int64_t(infinite_tail) : total + tail;
+    };
+    std::apply([&](const auto&... stage) { (add(stage), ...); }, stages);
+    return std::min(total, int64_t(infinite_tail));
+  }
+
+private:
+  static constexpr std::array<bool, stage_count> block_stages
+      = {!(chain_sample_stage<float, Stages> || chain_sample_stage<double, Stages>)...};
+
+  // A segment is either a run of per-sample stages, or a single per-channel stage
+  static constexpr std::size_t segment_end(std::size_t begin) noexcept
+  {
+    if (block_stages[begin])
+      return begin + 1;
+    while (begin < stage_count && !block_stages[begin])
+      begin++;
+    return begin;
+  }
+
+  static constexpr int segment_count(std::size_t begin = 0) noexcept
+  {
+    int count = 0;
+    for (; begin < stage_count; begin = segment_end(begin))
+      count++;
+    return count;
+  }
+
+  auto& scratch_for(float) noexcept { return m_scratch_f; }
+  auto& scratch_for(double) noexcept { return m_scratch_d; }
+
+  // Only the values are forwarded: the stages see the state of the controls
+  // at the beginning of the block. The update() hooks are called there too.
+  template <std::size_t... K>
+  void copy_inputs(const inputs& ins, std::index_sequence<K...>) noexcept
+  {
+    (copy_stage_inputs<K>(ins), ...);
+  }
+
+  template <std::size_t K>
+  void copy_stage_inputs(const inputs& ins) noexcept
+  {
+    constexpr std::size_t offset = input_offsets[K];
+    constexpr std::size_t count = input_offsets[K + 1] - offset;
+    if constexpr (count > 0)
+    {
+      auto& stage = std::get<K>(stages);
+      auto& dst = stage.inputs();
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (copy_port(stage.effect, pfr::get<offset + I>(ins), pfr::get<I>(dst)), ...);
+      }(std::make_index_sequence<count>{});
+    }
+  }
+
+  template <typename S>
+  static void copy_port(S& effect, const auto& src, auto& dst) noexcept
+  {
+    if constexpr (avnd::parameter_with_update<std::decay_t<decltype(dst)>, S>)
+    {
+      if (dst.value != src.value)
+      {
+        dst.value = src.value;
+        dst.update(effect);
+      }
+    }
+    else if constexpr (requires { dst.value = src.value; })
+      dst.value = src.value;
+    else
+      dst = src;
+  }
+
+  template <typename FP, typename S>
+  static FP process_sample(detail::chain_stage_state<S>& stage, FP in)
+  {
+    auto& fx = stage.effect;
+    auto& ins = stage.inputs();
+    auto& outs = stage.outputs();
+    if constexpr (requires { fx(in, ins, outs); })
+      return FP(fx(in, ins, outs));
+    else if constexpr (requires { fx(in, ins); })
+      return FP(fx(in, ins));
+    else if constexpr (requires { fx(in, outs); })
+      return FP(fx(in, outs));
+    else
+      return FP(fx(in));
+  }
+
+  template <typename FP, typename S>
+  static void process_block(detail::chain_stage_state<S>& stage, FP* in, FP* out, int n)
+  {
+    auto& fx = stage.effect;
+    auto& ins = stage.inputs();
+    auto& outs = stage.outputs();
+    if constexpr (requires { fx(in, out, ins, outs, n); })
+      fx(in, out, ins, outs, n);
+    else if constexpr (requires { fx(in, out, ins, n); })
+      fx(in, out, ins, n);
+    else if constexpr (requires { fx(in, out, outs, n); })
+      fx(in, out, outs, n);
+    else
+      fx(in, out, n);
+  }
+
+  // Runs the segments from the one starting at Begin.
+  // The last one writes to the output, the previous ones alternate
+  // with the scratch buffer.
+  template <std::size_t Begin, typename FP>
+  void run_from(FP* src, FP* out, FP* scratch, int n)
+  {
+    if constexpr (Begin < stage_count)
+    {
+      constexpr std::size_t End = segment_end(Begin);
+      FP* dst = (segment_count(End) % 2 == 0) ? out : scratch;
+
+      if constexpr (block_stages[Begin])
+      {
+        process_block(std::get<Begin>(stages), src, dst, n);
+      }
+      else
+      {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          for (int i = 0; i < n; i++)
+          {
+            FP x = src[i];
+            ((x = process_sample(std::get<Begin + I>(stages), x)), ...);
+            dst[i] = x;
+          }
+        }(std::make_index_sequence<End - Begin>{});
+      }
+
+      run_from<End>(dst, out, scratch, n);
+    }
+  }
+
+  std::vector<float, avnd::aligned_allocator<float>> m_scratch_f;
+  std::vector<double, avnd::aligned_allocator<double>> m_scratch_d;
+};
+}
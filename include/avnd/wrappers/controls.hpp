@@ -4,6 +4,8 @@
 
 #include <avnd/common/for_nth.hpp>
 #include <avnd/wrappers/avnd.hpp>
+#include <avnd/wrappers/effect_container.hpp>
+#include <avnd/wrappers/mapping.hpp>
 #include <avnd/wrappers/widgets.hpp>
 #include <cmath>
 
@@ -24,6 +26,10 @@ static constexpr void init_controls(I&& inputs)
           if_possible(ctl.value = c.init) // Default case
           else if_possible(ctl.value = c.values[c.init]) // For string enums
         }
+
+        // Computes the conversion table now, if it is not done at compile time
+        if constexpr (avnd::mapped_parameter<T>)
+          avnd::mapping_table<T>::values();
       });
 }
 
@@ -48,6 +54,66 @@ static constexpr void apply_control(T& ctl, std::floating_point auto v)
       ctl.value = c.max;
   }
 }
+/**
+ * @brief Used when the host sets a control: if the control has an update hook
+ * (see avnd::parameter_with_update), it is called on each instance of the processor
+ * when the value changes.
+ */
+template <typename T, typename C, typename V>
+static constexpr void
+set_control_value(avnd::effect_container<T>& implementation, C& ctl, V&& value)
+{
+  if constexpr (avnd::parameter_with_update<C, T>)
+  {
+    auto v = static_cast<std::decay_t<decltype(ctl.value)>>(std::forward<V>(value));
+    if (ctl.value != v)
+    {
+      ctl.value = std::move(v);
+      for (auto& effect : implementation.effects())
+        ctl.update(effect);
+    }
+  }
+  else
+  {
+    ctl.value = std::forward<V>(value);
+  }
+}
+
+/**
+ * @brief Same as apply_control, for the hosts which set the controls of
+ * a processor: the update hook of the control, if any, is called on each
+ * instance when the value changes, as in set_control_value.
+ */
+template <typename T, typename C>
+static constexpr void apply_control(
+    avnd::effect_container<T>& implementation, C& ctl, std::floating_point auto v)
+{
+  if constexpr (avnd::parameter_with_update<C, T>)
+  {
+    const auto previous = ctl.value;
+    apply_control(ctl, v);
+    if (ctl.value != previous)
+      for (auto& effect : implementation.effects())
+        ctl.update(effect);
+  }
+  else
+  {
+    apply_control(ctl, v);
+  }
+}
+
+/**
+ * @brief Used when the host sets a control which is only mirrored, without
+ * an instance of the processor, e.g. in the VST3 controller: there is
+ * no processor to pass to the update hooks, they are called by the
+ * binding which owns the instances.
+ */
+template <typename C, typename V>
+static constexpr void set_control_value(C& ctl, V&& value)
+{
+  ctl.value = std::forward<V>(value);
+}
+
 /*
 static void apply_control(auto& ctl, std::string&& v)
 {
@@ -64,7 +130,13 @@ static void apply_control(auto& ctl, std::string&& v)
 template <avnd::float_parameter T>
 static constexpr auto map_control_from_01(std::floating_point auto v)
 {
-  if constexpr (avnd::has_range<T>)
+  if constexpr (avnd::mapped_parameter<T>)
+  {
+    constexpr auto c = avnd::get_range<T>();
+    using value_type = decltype(c.min + v * (c.max - c.min));
+    return value_type(avnd::mapping_table<T>::from_01(v));
+  }
+  else if constexpr (avnd::has_range<T>)
   {
     constexpr auto c = avnd::get_range<T>();
     return c.min + v * (c.max - c.min);
@@ -77,7 +149,13 @@ static constexpr auto map_control_from_01(std::floating_point auto v)
 template <avnd::int_parameter T>
 static constexpr auto map_control_from_01(std::floating_point auto v)
 {
-  if constexpr (avnd::has_range<T>)
+  if constexpr (avnd::mapped_parameter<T>)
+  {
+    constexpr auto c = avnd::get_range<T>();
+    using value_type = decltype(c.min + v * (c.max - c.min));
+    return value_type(avnd::mapping_table<T>::from_01(v));
+  }
+  else if constexpr (avnd::has_range<T>)
   {
     constexpr auto c = avnd::get_range<T>();
     return c.min + v * (c.max - c.min);
@@ -118,7 +196,11 @@ static constexpr auto map_control_to_01(const auto& value)
 {
   // Apply the value
   double v{};
-  if constexpr (avnd::has_range<T>)
+  if constexpr (avnd::mapped_parameter<T>)
+  {
+    v = avnd::mapping_table<T>::to_01(value);
+  }
+  else if constexpr (avnd::has_range<T>)
   {
     constexpr auto c = avnd::get_range<T>();
 
@@ -136,7 +218,11 @@ static constexpr auto map_control_to_01(const auto& value)
 {
   // Apply the value
   double v{};
-  if constexpr (avnd::has_range<T>)
+  if constexpr (avnd::mapped_parameter<T>)
+  {
+    v = avnd::mapping_table<T>::to_01(value);
+  }
+  else if constexpr (avnd::has_range<T>)
   {
     // TODO generalize
     static_assert(avnd::get_range<T>().max != avnd::get_range<T>().min);
@@ -3,6 +3,7 @@
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include <avnd/wrappers/avnd.hpp>
+#include <avnd/wrappers/mapping.hpp>
 #include <avnd/wrappers/widgets.hpp>
 #include <cmath>
 
@@ -17,7 +18,13 @@ namespace avnd
 template <avnd::float_parameter T>
 static constexpr auto map_control_from_01_to_fp(std::floating_point auto v)
 {
-  if constexpr (avnd::has_range<T>)
+  if constexpr (avnd::mapped_parameter<T>)
+  {
+    constexpr auto c = avnd::get_range<T>();
+    using value_type = decltype(c.min + v * (c.max - c.min));
+    return value_type(avnd::mapping_table<T>::from_01(v));
+  }
+  else if constexpr (avnd::has_range<T>)
   {
     constexpr auto c = avnd::get_range<T>();
     return c.min + v * (c.max - c.min);
@@ -31,7 +38,13 @@ static constexpr auto map_control_from_01_to_fp(std::floating_point auto v)
 template <avnd::int_parameter T>
 static constexpr auto map_control_from_01_to_fp(std::floating_point auto v)
 {
-  if constexpr (avnd::has_range<T>)
+  if constexpr (avnd::mapped_parameter<T>)
+  {
+    constexpr auto c = avnd::get_range<T>();
+    using value_type = decltype(c.min + v * (c.max - c.min));
+    return value_type(avnd::mapping_table<T>::from_01(v));
+  }
+  else if constexpr (avnd::has_range<T>)
   {
     constexpr auto c = avnd::get_range<T>();
     return c.min + v * (c.max - c.min);
@@ -75,7 +88,11 @@ static constexpr auto map_control_from_fp_to_01(std::floating_point auto value)
 {
   // Apply the value
   double v{};
-  if constexpr (avnd::has_range<T>)
+  if constexpr (avnd::mapped_parameter<T>)
+  {
+    v = avnd::mapping_table<T>::to_01(value);
+  }
+  else if constexpr (avnd::has_range<T>)
   {
     constexpr auto c = avnd::get_range<T>();
 
@@ -93,7 +110,11 @@ static constexpr auto map_control_from_fp_to_01(std::floating_point auto value)
 {
   // Apply the value
   double v{};
-  if constexpr (avnd::has_range<T>)
+  if constexpr (avnd::mapped_parameter<T>)
+  {
+    v = avnd::mapping_table<T>::to_01(value);
+  }
+  else if constexpr (avnd::has_range<T>)
   {
     // TODO generalize
     static_assert(avnd::get_range<T>().max != avnd::get_range<T>().min);
@@ -213,6 +213,7 @@ struct control_storage
       {
         auto& buf = tpl::get<Idx>(this->span_inputs);
         buf.resize(0);
+        port.values = {buf.data(), std::size_t(0)};
       };
       span_in::for_all_n(avnd::get_inputs(t), init_raw_in);
     }
@@ -221,6 +222,114 @@ struct control_storage
     dyn_in::for_all(avnd::get_inputs(t), init_dyn);
   }
 
+  /**
+   * Adds a value at the given frame to the sample-accurate input
+   * at index Idx of the inputs, with frame in [0; buffer_size[,
+   * in each instance for mono processors duplicated per channel.
+   *
+   * This does not allocate: a span input keeps at most buffer_size values
+   * per block, and a dynamic one as many as it could reserve. The next ones
+   * are dropped, the bindings still set the last value of the block.
+   */
+  template <std::size_t Idx>
+  void push_input(
+      avnd::effect_container<T>& t, avnd::field_index<Idx>, int frame,
+      const auto& value) noexcept
+  {
+    auto&& inputs = avnd::get_inputs(t);
+    if constexpr (multi_instance_range<decltype(inputs)>)
+    {
+      // The linear and span buffers are shared by the instances
+      bool stored = false;
+      for (auto& instance : inputs)
+      {
+        if (!stored)
+          stored = push_value(instance, avnd::field_index<Idx>{}, frame, value);
+        else
+          push_shared(instance, avnd::field_index<Idx>{}, frame, value);
+      }
+    }
+    else
+    {
+      push_value(inputs, avnd::field_index<Idx>{}, frame, value);
+    }
+  }
+
+private:
+  // Returns true if the value was stored
+  template <std::size_t Idx>
+  bool push_value(auto& inputs, avnd::field_index<Idx>, int frame, const auto& value) noexcept
+  {
+    auto& port = avnd::pfr::get<Idx>(inputs);
+    using port_type = std::decay_t<decltype(port)>;
+    if constexpr (avnd::linear_sample_accurate_parameter<port_type>)
+    {
+      port.values[frame] = value;
+      return true;
+    }
+    else if constexpr (avnd::span_sample_accurate_parameter<port_type>)
+    {
+      constexpr int span_index = span_in::field_index_to_index(avnd::field_index<Idx>{});
+      auto& buf = tpl::get<span_index>(this->span_inputs);
+      if (buf.size() == buf.capacity())
+        return false;
+
+      typename std::decay_t<decltype(buf)>::value_type v{};
+      v.value = value;
+      v.frame = frame;
+      buf.push_back(v);
+      port.values = {buf.data(), buf.size()};
+      return true;
+    }
+    else if constexpr (avnd::dynamic_sample_accurate_parameter<port_type>)
+    {
+      return push_dynamic(port, frame, value);
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  // For the next instances, once the value is in the shared buffers
+  template <std::size_t Idx>
+  void push_shared(auto& inputs, avnd::field_index<Idx>, int frame, const auto& value) noexcept
+  {
+    auto& port = avnd::pfr::get<Idx>(inputs);
+    using port_type = std::decay_t<decltype(port)>;
+    if constexpr (avnd::span_sample_accurate_parameter<port_type>)
+    {
+      constexpr int span_index = span_in::field_index_to_index(avnd::field_index<Idx>{});
+      auto& buf = tpl::get<span_index>(this->span_inputs);
+      port.values = {buf.data(), buf.size()};
+    }
+    else if constexpr (avnd::dynamic_sample_accurate_parameter<port_type>)
+    {
+      push_dynamic(port, frame, value);
+    }
+  }
+
+  // Maps which cannot reserve, e.g. std::map, would allocate a node
+  static bool push_dynamic(auto& port, int frame, const auto& value) noexcept
+  {
+    auto& values = port.values;
+    if constexpr (requires { values.capacity(); })
+    {
+      if (auto it = values.find(frame); it != values.end())
+        it->second = value;
+      else if (values.size() < values.capacity())
+        values.emplace(frame, value);
+      else
+        return false;
+      return true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+public:
   void clear_outputs(avnd::effect_container<T>& t)
   {
     if constexpr (lin_out::size > 0)
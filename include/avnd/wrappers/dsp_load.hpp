@@ -0,0 +1,99 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/dsp_load.hpp>
+#include <avnd/introspection/output.hpp>
+#include <avnd/wrappers/effect_container.hpp>
+#include <avnd/wrappers/metadatas.hpp>
+
+namespace avnd
+{
+/**
+ * The bindings time their process calls when building with AVND_DSP_LOAD defined
+ * (see the AVENDISH_DSP_LOAD CMake option), or when the processor has an
+ * output for it:
+ *
+ *   struct outputs {
+ *     halp::dsp_load_bar<"DSP load"> load;
+ *   } outputs;
+ *
+ * which is set before each process call to the load of the previous block.
+ */
+template <typename T>
+constexpr bool measures_dsp_load() noexcept
+{
+#if defined(AVND_DSP_LOAD)
+  return true;
+#else
+  return dsp_load_output_introspection<T>::size > 0;
+#endif
+}
+
+/**
+ * Records the duration of a process call on destruction
+ */
+struct dsp_load_scope
+{
+  dsp_load_meter& meter;
+  uint64_t begin;
+  int frames;
+
+  ~dsp_load_scope() { meter.end(begin, frames); }
+};
+
+/**
+ * Member of the bindings, next to the processor:
+ *
+ *   [[no_unique_address]] avnd::dsp_load_tracker<T> dsp_load;
+ *
+ *   // when starting
+ *   dsp_load.start(sample_rate);
+ *
+ *   // in the process entry point
+ *   [[maybe_unused]] auto load = dsp_load.measure(effect, frames);
+ *
+ * When the processor is not measured this is empty and does nothing.
+ * Otherwise, its stats() can be read from any thread, and the instance is
+ * listed in avnd::dsp_load_registry.
+ */
+template <typename T>
+struct dsp_load_tracker
+{
+  dsp_load_meter meter{avnd::get_name<T>()};
+
+  void start(double sample_rate) noexcept { meter.start(sample_rate); }
+
+  [[nodiscard]] dsp_load_scope
+  measure(avnd::effect_container<T>& implementation, int frames) noexcept
+  {
+    if constexpr (dsp_load_output_introspection<T>::size > 0)
+    {
+      const float load = meter.last_load();
+      dsp_load_output_introspection<T>::for_all(
+          implementation.outputs(), [load](auto& port) { port.value = load; });
+    }
+    return dsp_load_scope{meter, meter.begin(), frames};
+  }
+
+  dsp_load_stats stats() const noexcept { return meter.stats(); }
+  void reset() noexcept { meter.reset(); }
+};
+
+template <typename T>
+requires(!measures_dsp_load<T>())
+struct dsp_load_tracker<T>
+{
+  void start(double) noexcept { }
+  constexpr int measure(avnd::effect_container<T>&, int) noexcept { return 0; }
+};
+
+/**
+ * Matches the bindings whose DSP load can be read, e.g. by a host
+ * embedding them: b.dsp_load.stats()
+ */
+template <typename Binding>
+concept has_dsp_load = requires(const Binding& b) {
+  { b.dsp_load.stats() } -> std::same_as<dsp_load_stats>;
+};
+}
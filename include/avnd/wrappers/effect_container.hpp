@@ -2,7 +2,9 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
-#include <avnd/common/coroutines.hpp>
+#include <avnd/common/function_reflection.hpp>
+#include <avnd/common/member_range.hpp>
+#include <avnd/common/simd_lanes.hpp>
 #include <avnd/concepts/all.hpp>
 
 #include <vector>
@@ -97,7 +99,10 @@ struct effect_container
       return dummy_instance;
   }
 
-  member_iterator<T> effects() { co_yield effect; }
+  auto effects() noexcept
+  {
+    return make_member_range(&effect, &effect + 1, [](T& e) -> T& { return e; });
+  }
 };
 
 template <typename T>
@@ -118,7 +123,10 @@ requires(!has_inputs<T> && !has_outputs<T> && !monophonic_audio_processor<T>) st
   auto& outputs() noexcept { return dummy_instance; }
   auto& outputs() const noexcept { return dummy_instance; }
 
-  member_iterator<T> effects() { co_yield effect; }
+  auto effects() noexcept
+  {
+    return make_member_range(&effect, &effect + 1, [](T& e) -> T& { return e; });
+  }
 
   struct ref
   {
@@ -129,10 +137,9 @@ requires(!has_inputs<T> && !has_outputs<T> && !monophonic_audio_processor<T>) st
     [[no_unique_address]] dummy outputs;
   };
 
-  member_iterator<ref> full_state()
+  auto full_state() noexcept
   {
-    ref r{effect, {}, {}};
-    co_yield r;
+    return make_member_range(&effect, &effect + 1, [](T& e) { return ref{e, {}, {}}; });
   }
 };
 
@@ -161,10 +168,10 @@ requires(!has_inputs<T> && !has_outputs<T> && monophonic_audio_processor<T>) str
   auto& outputs() noexcept { return dummy_instance; }
   auto& outputs() const noexcept { return dummy_instance; }
 
-  member_iterator<T> effects()
+  auto effects() noexcept
   {
-    for (auto& eff : effect)
-      co_yield eff;
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(), [](T& e) -> T& { return e; });
   }
 
   struct ref
@@ -176,13 +183,11 @@ requires(!has_inputs<T> && !has_outputs<T> && monophonic_audio_processor<T>) str
     [[no_unique_address]] dummy outputs;
   };
 
-  member_iterator<ref> full_state()
+  auto full_state() noexcept
   {
-    for (auto& e : effect)
-    {
-      ref r{e, {}, {}};
-      co_yield r;
-    }
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [](T& e) { return ref{e, {}, {}}; });
   }
 };
 
@@ -214,25 +219,25 @@ struct effect_container<T>
     typename T::outputs& outputs;
   };
 
-  member_iterator<ref> full_state()
+  auto full_state() noexcept
   {
-    for (state& e : effect)
-    {
-      ref r{e.effect, this->inputs_storage, e.outputs_storage};
-      co_yield r;
-    }
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [this](state& e) { return ref{e.effect, this->inputs_storage, e.outputs_storage}; });
   }
 
-  member_iterator<T> effects()
+  auto effects() noexcept
   {
-    for (auto& e : effect)
-      co_yield e.effect;
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [](state& e) -> T& { return e.effect; });
   }
 
-  member_iterator<typename T::outputs> outputs()
+  auto outputs() noexcept
   {
-    for (auto& e : effect)
-      co_yield e.outputs_storage;
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [](state& e) -> typename T::outputs& { return e.outputs_storage; });
   }
 };
 
@@ -261,25 +266,24 @@ struct effect_container<T>
     typename T::inputs& inputs;
     decltype(T::outputs)& outputs;
   };
-  member_iterator<ref> full_state()
+  auto full_state() noexcept
   {
-    for (T& e : effect)
-    {
-      ref r{e.effect, this->inputs_storage, e.effect.outputs};
-      co_yield r;
-    }
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [this](T& e) { return ref{e, this->inputs_storage, e.outputs}; });
   }
 
-  member_iterator<T> effects()
+  auto effects() noexcept
   {
-    for (auto& e : effect)
-      co_yield e;
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(), [](T& e) -> T& { return e; });
   }
 
-  member_iterator<typename T::outputs> outputs()
+  auto outputs() noexcept
   {
-    for (auto& e : effect)
-      co_yield e.output;
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [](T& e) -> decltype(T::outputs)& { return e.outputs; });
   }
 };
 
@@ -312,30 +316,124 @@ struct effect_container<T>
     decltype(T::inputs)& inputs;
     decltype(T::outputs)& outputs;
   };
-  member_iterator<ref> full_state()
+  auto full_state() noexcept
   {
-    for (T& e : effect)
-    {
-      ref r{e.effect, e.effect.inputs, e.effect.outputs};
-      co_yield r;
-    }
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [](T& e) { return ref{e, e.inputs, e.outputs}; });
   }
 
-  member_iterator<T> effects()
+  auto effects() noexcept
   {
-    for (auto& e : effect)
-      co_yield e;
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(), [](T& e) -> T& { return e; });
   }
 
-  member_iterator<decltype(T::inputs)> inputs()
+  auto inputs() noexcept
   {
-    for (auto& e : effect)
-      co_yield e.inputs;
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [](T& e) -> decltype(T::inputs)& { return e.inputs; });
   }
-  member_iterator<decltype(T::outputs)> outputs()
+  auto outputs() noexcept
+  {
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [](T& e) -> decltype(T::outputs)& { return e.outputs; });
+  }
+};
+
+/**
+ * A mono per-sample processor written as a template on its sample type can opt-in
+ * to have its per-channel instances packed in SIMD lanes, by exposing:
+ *
+ * template <typename S>
+ * using rebind_sample = MyProcessor<S>;
+ *
+ * The number of channels processed at once can be set with
+ * static constexpr int lanes = 8;
+ * otherwise it is the widest vector register size we are building for.
+ */
+template <typename T>
+concept lane_generic_processor = requires
+{
+  typename T::template rebind_sample<float>;
+};
+
+template <typename T>
+struct lane_packing
+{
+  using sample_type = typename function_reflection<&T::operator()>::return_type;
+
+  static constexpr int lanes = []
+  {
+    if constexpr (requires { T::lanes; })
+      return int(T::lanes);
+    else
+      return simd_native_lanes<sample_type>;
+  }();
+
+  using lane_type = simd_lanes<sample_type, lanes>;
+  using packed_type = typename T::template rebind_sample<lane_type>;
+};
+
+// The inputs are shared across all the instances, thus they must not depend on the
+// sample type. Outputs cannot be split across lanes so we do not support them.
+template <typename T>
+concept lane_packed_processor
+    = lane_generic_processor<T>
+      && (mono_per_sample_arg_processor<double, T> || mono_per_sample_arg_processor<float, T>)
+      && inputs_is_type<T> && outputs_is_type<T>
+      && std::is_same_v<typename lane_packing<T>::packed_type::inputs, typename T::inputs>
+      && std::is_empty_v<typename T::outputs>;
+
+/**
+ * Structure-of-arrays storage for lane-generic mono processors:
+ * each instance of the packed processor handles "lanes" channels at once.
+ */
+template <avnd::monophonic_audio_processor T>
+requires avnd::inputs_is_type<T> && avnd::outputs_is_type<T> && avnd::lane_packed_processor<T>
+struct effect_container<T>
+{
+  using type = T;
+  using packed_type = typename lane_packing<T>::packed_type;
+  static constexpr int lanes = lane_packing<T>::lanes;
+
+  typename T::inputs inputs_storage;
+  typename T::outputs outputs_storage;
+
+  std::vector<packed_type> effect;
+
+  void init_channels(int input, int output)
+  {
+    const int channels = std::max(input, output);
+    effect.resize((channels + lanes - 1) / lanes);
+  }
+
+  auto& inputs() noexcept { return inputs_storage; }
+  auto& inputs() const noexcept { return inputs_storage; }
+  auto& outputs() noexcept { return outputs_storage; }
+  auto& outputs() const noexcept { return outputs_storage; }
+
+  struct ref
+  {
+    packed_type& effect;
+    typename T::inputs& inputs;
+    typename T::outputs& outputs;
+  };
+
+  auto full_state() noexcept
+  {
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [this](packed_type& e) { return ref{e, this->inputs_storage, this->outputs_storage}; });
+  }
+
+  auto effects() noexcept
   {
-    for (auto& e : effect)
-      co_yield e.outputs;
+    return make_member_range(
+        effect.data(), effect.data() + effect.size(),
+        [](packed_type& e) -> packed_type& { return e; });
   }
 };
 
@@ -0,0 +1,134 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/aligned_allocator.hpp>
+#include <avnd/introspection/input.hpp>
+#include <avnd/wrappers/process/base.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace avnd
+{
+/**
+ * Processors which want to always be called with the same number of frames,
+ * whatever the host does, e.g. for FFT-based analysis:
+ *
+ *   static constexpr int fixed_block_size = 1024;
+ */
+template <typename T>
+concept fixed_block_processor = requires
+{
+  {
+    T::fixed_block_size
+    } -> avnd::int_ish;
+}
+&&(T::fixed_block_size > 0);
+
+/**
+ * Re-buffers the audio from the host in blocks of exactly T::fixed_block_size frames.
+ *
+ * The input is accumulated until a full block is available, which is then processed;
+ * the output of a block is played while the next one accumulates.
+ * This works for any host block size, even when it changes from a call to another,
+ * at the cost of a constant latency of fixed_block_size frames.
+ */
+template <typename T>
+struct fixed_block_process_adapter : process_adapter<T>
+{
+  static constexpr int block_size = T::fixed_block_size;
+
+  // The ramps cover the frames of the host, not those of the fixed blocks
+  static_assert(
+      smooth_parameter_input_introspection<T>::size == 0,
+      "Smooth controls cannot be used with fixed_block_size");
+
+  template <typename FP>
+  struct fifo
+  {
+    std::vector<FP, avnd::aligned_allocator<FP>> in, out;
+    std::vector<FP*> in_ptrs, out_ptrs;
+  };
+  fifo<float> m_fifo_f;
+  fifo<double> m_fifo_d;
+
+  // Position in the current block, the same for all the channels
+  int m_position{};
+
+  auto& fifo_for(float) noexcept { return m_fifo_f; }
+  auto& fifo_for(double) noexcept { return m_fifo_d; }
+
+  int latency() const noexcept { return block_size; }
+
+  template <std::floating_point SrcFP>
+  void allocate_buffers(process_setup setup, SrcFP f)
+  {
+    // The processor only ever sees blocks of block_size frames
+    process_setup inner = setup;
+    inner.frames_per_buffer = block_size;
+    process_adapter<T>::allocate_buffers(inner, f);
+
+    const int stride = aligned_channel_stride<SrcFP>(block_size);
+    auto& b = fifo_for(f);
+    b.in.assign(stride * setup.input_channels, SrcFP{});
+    b.out.assign(stride * setup.output_channels, SrcFP{});
+    b.in_ptrs.resize(setup.input_channels);
+    b.out_ptrs.resize(setup.output_channels);
+    for (int c = 0; c < setup.input_channels; c++)
+      b.in_ptrs[c] = b.in.data() + c * stride;
+    for (int c = 0; c < setup.output_channels; c++)
+      b.out_ptrs[c] = b.out.data() + c * stride;
+
+    m_position = 0;
+  }
+
+  template <std::floating_point FP>
+  void process(
+      avnd::effect_container<T>& implementation,
+      avnd::span<FP*> in,
+      avnd::span<FP*> out,
+      int32_t n)
+  {
+    auto& b = fifo_for(FP{});
+    const int input_channels = std::min(in.size(), b.in_ptrs.size());
+    const int output_channels = std::min(out.size(), b.out_ptrs.size());
+
+    int32_t done = 0;
+    while (done < n)
+    {
+      const int frames = std::min(n - done, block_size - m_position);
+
+      // Read all the inputs before writing any output, as they may alias
+      for (int c = 0; c < input_channels; c++)
+      {
+        if (in[c])
+          std::copy_n(in[c] + done, frames, b.in_ptrs[c] + m_position);
+        else
+          std::fill_n(b.in_ptrs[c] + m_position, frames, FP{});
+      }
+      for (int c = 0; c < output_channels; c++)
+        if (out[c])
+          std::copy_n(b.out_ptrs[c] + m_position, frames, out[c] + done);
+
+      m_position += frames;
+      done += frames;
+
+      if (m_position == block_size)
+      {
+        process_adapter<T>::process(
+            implementation,
+            avnd::span<FP*>(b.in_ptrs.data(), input_channels),
+            avnd::span<FP*>(b.out_ptrs.data(), output_channels),
+            block_size);
+        m_position = 0;
+      }
+    }
+
+    // Outputs the host has and we do not know about
+    for (int c = output_channels; c < int(out.size()); c++)
+      if (out[c])
+        std::fill_n(out[c], n, FP{});
+  }
+};
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/wrappers/effect_container.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace avnd
+{
+/**
+ * Processors can declare the latency they introduce, in frames,
+ * for the host to compensate it. Any of these work:
+ *
+ *   static constexpr int latency = 64;   // never changes
+ *   int latency = 64;                    // can change at run-time
+ *   int latency() const noexcept;        // ditto
+ *
+ * The same goes for the tail, i.e. how many frames of output they
+ * keep producing once the input is silent, e.g. for a reverb:
+ *
+ *   static constexpr int tail = 48000;
+ *
+ * with avnd::infinite_tail meaning that the output may never stop.
+ */
+template <typename T>
+concept has_latency = requires(const T& t) { int(t.latency()); }
+                      || requires(const T& t) { int(t.latency); };
+
+template <typename T>
+concept has_tail = requires(const T& t) { int64_t(t.tail()); }
+                   || requires(const T& t) { int64_t(t.tail); };
+
+static constexpr uint32_t infinite_tail = std::numeric_limits<uint32_t>::max();
+
+template <typename T>
+int get_latency(const T& t) noexcept
+{
+  if constexpr (requires { int(t.latency()); })
+    return t.latency();
+  else if constexpr (requires { int(t.latency); })
+    return t.latency;
+  else
+    return 0;
+}
+
+template <typename T>
+uint32_t get_tail(const T& t) noexcept
+{
+  int64_t tail = 0;
+  if constexpr (requires { int64_t(t.tail()); })
+    tail = t.tail();
+  else if constexpr (requires { int64_t(t.tail); })
+    tail = t.tail;
+
+  if (tail < 0 || tail >= int64_t(infinite_tail))
+    return infinite_tail;
+  return uint32_t(tail);
+}
+
+/**
+ * Latency in frames added by the process adapter, to be reported to the host.
+ */
+template <typename Adapter>
+int process_latency(const Adapter& processor) noexcept
+{
+  if constexpr (requires { processor.latency(); })
+    return processor.latency();
+  else
+    return 0;
+}
+
+/**
+ * Latency of the processor as seen by the host: the one declared by the processor,
+ * plus the one introduced by the process adapter (e.g. for fixed-size blocks).
+ */
+template <typename T>
+int get_latency(avnd::effect_container<T>& implementation, const auto& processor) noexcept
+{
+  int latency = avnd::process_latency(processor);
+  if constexpr (has_latency<T>)
+  {
+    for (auto& fx : implementation.effects())
+    {
+      latency += get_latency(fx);
+      break;
+    }
+  }
+  return latency;
+}
+
+template <typename T>
+uint32_t get_tail(avnd::effect_container<T>& implementation) noexcept
+{
+  if constexpr (has_tail<T>)
+  {
+    for (auto& fx : implementation.effects())
+      return get_tail(fx);
+  }
+  return 0;
+}
+
+/**
+ * Used by the bindings to notice when the latency or tail of a processor changes
+ * during processing, and to tell the host about it later from a non-realtime thread.
+ */
+struct latency_tracker
+{
+  std::atomic<int> latency{};
+  std::atomic<uint32_t> tail{};
+  std::atomic_bool changed{};
+
+  // Call from the audio thread, after processing
+  template <typename T>
+  void update(avnd::effect_container<T>& implementation, const auto& processor) noexcept
+  {
+    if constexpr (has_latency<T> || has_tail<T>)
+    {
+      const int l = get_latency(implementation, processor);
+      const uint32_t t = get_tail(implementation);
+      if (l != latency.load(std::memory_order_relaxed)
+          || t != tail.load(std::memory_order_relaxed))
+      {
+        latency.store(l, std::memory_order_relaxed);
+        tail.store(t, std::memory_order_relaxed);
+        changed.store(true, std::memory_order_release);
+      }
+    }
+  }
+
+  // Call when the processor is (re)started: the host will ask for the new values
+  template <typename T>
+  void reset(avnd::effect_container<T>& implementation, const auto& processor) noexcept
+  {
+    latency = get_latency(implementation, processor);
+    tail = get_tail(implementation);
+    changed = false;
+  }
+
+  // Returns true once after each change
+  bool consume_change() noexcept
+  {
+    return changed.exchange(false, std::memory_order_acquire);
+  }
+};
+}
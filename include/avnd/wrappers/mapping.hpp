@@ -0,0 +1,125 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/concepts/parameter.hpp>
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace avnd
+{
+/**
+ * Whether the mapping of a control can be computed at compile time
+ */
+template <typename T>
+concept constexpr_mapping = mapped_parameter<T> && requires {
+  typename std::integral_constant<double, avnd::get_normalize<T>().map(1., 2., 0.5)>;
+};
+
+// A mapping can restrict the ranges it works with, e.g. no 0 for a logarithm
+template <typename T>
+constexpr bool mapping_accepts_range(double min, double max) noexcept
+{
+  constexpr auto mapping = avnd::get_normalize<T>();
+  if constexpr (requires { mapping.valid_range(min, max); })
+    return mapping.valid_range(min, max);
+  else
+    return true;
+}
+
+template <typename T>
+struct mapping_table;
+
+// The table of mapping_table<T>, for constexpr mappings
+template <typename T>
+inline constexpr typename mapping_table<T>::table_type mapping_table_values
+    = mapping_table<T>::compute();
+
+/**
+ * Conversions between [0; 1] and the range of a control with a mapping
+ * (see avnd::mapped_parameter), through a table of the mapping sampled
+ * at regular intervals and linearly interpolated.
+ *
+ * The inverse conversion is the inverse of the interpolated mapping,
+ * found with a binary search in the same table: going back and forth between
+ * the host value and the control value always gives the same values.
+ *
+ * The table is computed at compile time when the mapping is constexpr,
+ * e.g. for the halp mappings, otherwise once, the first time it is used.
+ */
+template <typename T>
+struct mapping_table
+{
+  static constexpr int segments = 256;
+  using table_type = std::array<double, segments + 1>;
+
+  static constexpr double min = avnd::get_range<T>().min;
+  static constexpr double max = avnd::get_range<T>().max;
+  static_assert(min < max);
+  static_assert(
+      mapping_accepts_range<T>(min, max),
+      "The range of the control is not supported by its mapping");
+
+  static constexpr table_type compute() noexcept
+  {
+    constexpr auto mapping = avnd::get_normalize<T>();
+
+    table_type t{};
+    t[0] = min;
+    for (int i = 1; i < segments; i++)
+      t[i] = std::clamp(double(mapping.map(min, max, double(i) / segments)), min, max);
+    t[segments] = max;
+    return t;
+  }
+
+  static const table_type& runtime_values() noexcept
+  {
+    static const table_type t = compute();
+    return t;
+  }
+
+  static constexpr const table_type& values() noexcept
+  {
+    if constexpr (constexpr_mapping<T>)
+    {
+      return mapping_table_values<T>;
+    }
+    else
+    {
+      return runtime_values();
+    }
+  }
+
+  // [0; 1] -> [min; max]
+  static constexpr double from_01(double v) noexcept
+  {
+    const auto& t = values();
+    if (!(v > 0.))
+      return t[0];
+    if (v >= 1.)
+      return t[segments];
+
+    const double x = v * segments;
+    const int i = std::min(int(x), segments - 1);
+    return t[i] + (x - i) * (t[i + 1] - t[i]);
+  }
+
+  // [min; max] -> [0; 1]
+  static constexpr double to_01(double v) noexcept
+  {
+    const auto& t = values();
+    if (!(v > t[0]))
+      return 0.;
+    if (v >= t[segments])
+      return 1.;
+
+    // t[i] <= v < t[i + 1]
+    const int i = int(std::upper_bound(t.begin(), t.end(), v) - t.begin()) - 1;
+    const double width = t[i + 1] - t[i];
+    const double frac = width > 0. ? (v - t[i]) / width : 0.;
+    return (i + frac) / segments;
+  }
+};
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/aligned_allocator.hpp>
+#include <avnd/common/halfband.hpp>
+#include <avnd/concepts/audio_processor.hpp>
+#include <avnd/introspection/input.hpp>
+#include <avnd/wrappers/latency.hpp>
+#include <avnd/wrappers/process/base.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace avnd
+{
+/**
+ * Runs processors which satisfy oversampled_processor at T::oversampling times
+ * the host rate: the inputs are upsampled and the outputs downsampled
+ * with cascaded 2x half-band stages.
+ *
+ * The processor (through the Base adapter) gets T::oversampling times more frames.
+ * The delay of the filters is reported as latency: the output is delayed
+ * a bit more if needed so that it is a whole number of host frames.
+ */
+template <typename T, typename Base>
+struct oversampling_process_adapter : Base
+{
+  static constexpr int factor = avnd::oversampling_factor<T>();
+  static constexpr int stages = factor == 8 ? 3 : factor == 4 ? 2 : 1;
+
+  // The ramps cover the frames of the host, not the oversampled ones
+  static_assert(
+      smooth_parameter_input_introspection<T>::size == 0,
+      "Smooth controls cannot be used with oversampling");
+
+  template <typename FP>
+  using aligned_vector = std::vector<FP, avnd::aligned_allocator<FP>>;
+
+  template <typename FP>
+  struct buffers
+  {
+    // Stage s goes from 2^s to 2^(s+1) times the host rate
+    std::vector<std::array<halfband_upsampler<FP>, stages>> up;
+    std::vector<std::array<halfband_downsampler<FP>, stages>> down;
+
+    // Oversampled audio, as seen by the processor, with room for the padding
+    // delay before the outputs
+    aligned_vector<FP> in, out;
+    std::vector<FP*> in_ptrs, out_ptrs;
+
+    // Between the stages
+    aligned_vector<FP> scratch[2];
+  };
+  buffers<float> m_buffers_f;
+  buffers<double> m_buffers_d;
+
+  // Frames at the host rate that we process at once
+  int m_max_frames{};
+
+  auto& buffers_for(float) noexcept { return m_buffers_f; }
+  auto& buffers_for(double) noexcept { return m_buffers_d; }
+
+  // Delay of the filters, in samples of the oversampled rate: each stage delays by
+  // halfband_filter::delay samples at its high rate, when upsampling and when downsampling.
+  static constexpr int filters_delay = [] {
+    int delay = 0;
+    for (int s = 0; s < stages; s++)
+      delay += 2 * halfband_filter<double>::delay * (factor >> (s + 1));
+    return delay;
+  }();
+
+  // Extra delay so that the total is a whole number of host frames
+  static constexpr int padding = (factor - filters_delay % factor) % factor;
+
+  int latency() const noexcept
+  {
+    const int inner = avnd::process_latency(static_cast<const Base&>(*this));
+    return (filters_delay + padding + inner) / factor;
+  }
+
+  template <std::floating_point SrcFP>
+  void allocate_buffers(process_setup setup, SrcFP f)
+  {
+    m_max_frames = std::max(1, setup.frames_per_buffer);
+
+    process_setup inner = setup;
+    inner.frames_per_buffer = m_max_frames * factor;
+    inner.rate = setup.rate * factor;
+    Base::allocate_buffers(inner, f);
+
+    auto& b = buffers_for(f);
+    b.up.resize(setup.input_channels);
+    for (auto& chan : b.up)
+      for (int s = 0; s < stages; s++)
+        chan[s].reset(m_max_frames << s);
+    b.down.resize(setup.output_channels);
+    for (auto& chan : b.down)
+      for (int s = 0; s < stages; s++)
+        chan[s].reset(m_max_frames << s);
+
+    const int in_stride = aligned_channel_stride<SrcFP>(m_max_frames * factor);
+    const int out_stride = aligned_channel_stride<SrcFP>(padding + m_max_frames * factor);
+    b.in.assign(in_stride * setup.input_channels, SrcFP{});
+    b.out.assign(out_stride * setup.output_channels, SrcFP{});
+    b.in_ptrs.resize(setup.input_channels);
+    b.out_ptrs.resize(setup.output_channels);
+    for (int c = 0; c < setup.input_channels; c++)
+      b.in_ptrs[c] = b.in.data() + c * in_stride;
+    for (int c = 0; c < setup.output_channels; c++)
+      b.out_ptrs[c] = b.out.data() + c * out_stride + padding;
+
+    for (auto& s : b.scratch)
+      s.assign(m_max_frames * factor / 2, SrcFP{});
+  }
+
+  template <typename FP>
+  void upsample(buffers<FP>& b, int c, const FP* in, FP* out, int n) noexcept
+  {
+    const FP* src = in;
+    for (int s = 0; s < stages; s++)
+    {
+      FP* dst = (s == stages - 1) ? out : b.scratch[s % 2].data();
+      b.up[c][s].process(src, dst, n << s);
+      src = dst;
+    }
+  }
+
+  template <typename FP>
+  void downsample(buffers<FP>& b, int c, const FP* in, FP* out, int n) noexcept
+  {
+    const FP* src = in;
+    for (int s = stages - 1; s >= 0; s--)
+    {
+      FP* dst = (s == 0) ? out : b.scratch[s % 2].data();
+      b.down[c][s].process(src, dst, n << s);
+      src = dst;
+    }
+  }
+
+  template <std::floating_point FP>
+  void process(
+      avnd::effect_container<T>& implementation,
+      avnd::span<FP*> in,
+      avnd::span<FP*> out,
+      int32_t n)
+  {
+    auto& b = buffers_for(FP{});
+    const int input_channels = std::min(in.size(), b.in_ptrs.size());
+    const int output_channels = std::min(out.size(), b.out_ptrs.size());
+
+    // Hosts may send more frames than announced
+    for (int32_t done = 0; done < n; done += m_max_frames)
+    {
+      const int frames = std::min(n - done, m_max_frames);
+
+      // Read all the inputs before writing any output, as they may alias
+      for (int c = 0; c < input_channels; c++)
+      {
+        if (in[c])
+          upsample(b, c, in[c] + done, b.in_ptrs[c], frames);
+        else
+          std::fill_n(b.in_ptrs[c], frames * factor, FP{});
+      }
+
+      Base::process(
+          implementation,
+          avnd::span<FP*>(b.in_ptrs.data(), input_channels),
+          avnd::span<FP*>(b.out_ptrs.data(), output_channels),
+          frames * factor);
+
+      for (int c = 0; c < output_channels; c++)
+      {
+        FP* oversampled = b.out_ptrs[c];
+        if (out[c])
+          downsample(b, c, oversampled - padding, out[c] + done, frames);
+        if constexpr (padding > 0)
+          std::copy_n(oversampled + frames * factor - padding, padding, oversampled - padding);
+      }
+    }
+
+    // Outputs the host has and we do not know about
+    for (int c = output_channels; c < int(out.size()); c++)
+      if (out[c])
+        std::fill_n(out[c], n, FP{});
+  }
+};
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/thread_pool.hpp>
+#include <avnd/concepts/audio_processor.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace avnd
+{
+/**
+ * Worker threads which the shared pool must have to run the instances
+ * of a processor which satisfies parallel_channels_processor.
+ * As the pool is shared by all the processors, the default does not
+ * depend on the channels of a given instance.
+ */
+template <typename T>
+constexpr int parallel_workers(int channels) noexcept
+{
+  if constexpr (requires { int(T::parallel_workers); })
+    return std::max(0, int(T::parallel_workers));
+  else if (channels <= 1)
+    return 0;
+  else
+    return std::max(int(std::thread::hardware_concurrency()) - 1, 0);
+}
+
+/**
+ * Owned by the bindings: gives the process-wide thread pool (see shared_thread_pool)
+ * to the process adapter of processors which satisfy parallel_channels_processor,
+ * and does nothing otherwise.
+ *
+ * Call start() before processing starts and stop() after it ends,
+ * from a non-realtime thread.
+ */
+template <typename T>
+struct parallel_channels_pool
+{
+  std::shared_ptr<avnd::thread_pool> pool;
+
+  void start(auto& processor, int channels)
+  {
+    if constexpr (
+        avnd::parallel_channels_processor<T> && requires { processor.executor; })
+    {
+      processor.executor = nullptr;
+      const int workers = parallel_workers<T>(channels);
+      if (workers == 0)
+        pool.reset();
+      else
+        pool = avnd::shared_thread_pool::acquire(workers);
+      processor.executor = pool.get();
+    }
+  }
+
+  void stop(auto& processor)
+  {
+    if constexpr (requires { processor.executor; })
+      processor.executor = nullptr;
+    pool.reset();
+  }
+};
+}
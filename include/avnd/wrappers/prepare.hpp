@@ -3,8 +3,10 @@
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include <avnd/common/function_reflection.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/concepts/audio_processor.hpp>
 #include <avnd/wrappers/effect_container.hpp>
+#include <avnd/wrappers/metadatas.hpp>
 
 namespace avnd
 {
@@ -21,9 +23,14 @@ void prepare(avnd::effect_container<T>& implementation, process_setup setup)
 {
   if constexpr (avnd::can_prepare<T>)
   {
+    [[maybe_unused]] avnd::trace_span span{"prepare", avnd::get_name<T>()};
     using prepare_type = avnd::first_argument<&T::prepare>;
     prepare_type t;
 
+    // Oversampled processors run at a multiple of the host rate
+    setup.frames_per_buffer *= avnd::oversampling_factor<T>();
+    setup.rate *= avnd::oversampling_factor<T>();
+
     // C++20:
     // using "requires" to check easily which members are available
     // in a structure
@@ -33,7 +40,6 @@ void prepare(avnd::effect_container<T>& implementation, process_setup setup)
     if_possible(t.frames = setup.frames_per_buffer);
     if_possible(t.rate = setup.rate);
 
-    // Coroutines get used here.
     for (auto& eff : implementation.effects())
       eff.prepare(t);
   }
@@ -44,9 +50,14 @@ void prepare(T& implementation, process_setup setup)
 {
   if constexpr (avnd::can_prepare<T>)
   {
+    [[maybe_unused]] avnd::trace_span span{"prepare", avnd::get_name<T>()};
     using prepare_type = avnd::first_argument<&T::prepare>;
     prepare_type t;
 
+    // Oversampled processors run at a multiple of the host rate
+    setup.frames_per_buffer *= avnd::oversampling_factor<T>();
+    setup.rate *= avnd::oversampling_factor<T>();
+
     // C++20:
     // using "requires" to check easily which members are available
     // in a structure
@@ -5,14 +5,20 @@
 #include <avnd/common/for_nth.hpp>
 #include <avnd/common/function_reflection.hpp>
 #include <avnd/common/span_polyfill.hpp>
+#include <avnd/common/thread_pool.hpp>
 #include <avnd/introspection/channels.hpp>
 #include <avnd/wrappers/prepare.hpp>
 #include <avnd/wrappers/process_execution.hpp>
+#include <avnd/wrappers/zero_buffers.hpp>
 #include <avnd/common/aggregates.hpp>
+#include <avnd/common/convert_samples.hpp>
+#include <avnd/common/denormals.hpp>
 
+#include <cassert>
 #include <concepts>
 #include <cstdint>
 #include <cstdlib>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -21,11 +27,89 @@
 namespace avnd
 {
 
-template <typename Fp>
-struct zero_storage
+/**
+ * Checks whether the host buffers allow to run duplicated mono processors
+ * one channel after each other over the whole block.
+ *
+ * Some hosts like puredata use the same buffers for input and output:
+ * this is only a problem if an output channel overlaps with an input channel
+ * that has not been read yet, e.g. out[0] == in[1].
+ * Processing in-place on the same channel (out[c] == in[c]) is fine.
+ */
+template <typename FP>
+bool can_process_channel_major(avnd::span<FP*> in, avnd::span<FP*> out, int32_t n) noexcept
+{
+  const int input_channels = in.size();
+  const int output_channels = out.size();
+  for (int o = 0; o < output_channels; o++)
+  {
+    const auto out_begin = reinterpret_cast<uintptr_t>(out[o]);
+    const auto out_end = out_begin + n * sizeof(FP);
+    for (int i = o + 1; i < input_channels; i++)
+    {
+      const auto in_begin = reinterpret_cast<uintptr_t>(in[i]);
+      const auto in_end = in_begin + n * sizeof(FP);
+      if (out_begin < in_end && in_begin < out_end)
+        return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Checks whether the host buffers allow to run the per-channel instances
+ * of a mono processor in any order, e.g. in parallel:
+ * no output channel may overlap with another input channel.
+ */
+template <typename FP>
+bool can_process_channels_in_parallel(
+    avnd::span<FP*> in, avnd::span<FP*> out, int32_t n) noexcept
 {
-  std::vector<Fp> zeros_in, zeros_out;
-  std::vector<Fp*> zero_pointers_in, zero_pointers_out;
+  const int input_channels = in.size();
+  const int output_channels = out.size();
+  for (int o = 0; o < output_channels; o++)
+  {
+    const auto out_begin = reinterpret_cast<uintptr_t>(out[o]);
+    const auto out_end = out_begin + n * sizeof(FP);
+    for (int i = 0; i < input_channels; i++)
+    {
+      if (i == o)
+        continue;
+      const auto in_begin = reinterpret_cast<uintptr_t>(in[i]);
+      const auto in_end = in_begin + n * sizeof(FP);
+      if (out_begin < in_end && in_begin < out_end)
+        return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Mixed into the process adapters of mono processors duplicated per channel:
+ * when the bindings set an executor, the instances are run in parallel on it.
+ */
+template <typename T>
+struct per_channel_executor
+{
+  avnd::parallel_executor* executor{};
+
+  // Calls f(c) for each c in [0, channels) in parallel if possible;
+  // returns false if it did not, in which case nothing was called.
+  template <typename FP, typename F>
+  bool run_channels_in_parallel(
+      int channels, avnd::span<FP*> in, avnd::span<FP*> out, int32_t n, F&& f)
+  {
+    if (!executor || channels < 2 || !can_process_channels_in_parallel(in, out, n))
+      return false;
+
+    using func_type = std::remove_reference_t<F>;
+    executor->run(channels, &f, [](void* ctx, int c) noexcept {
+      // The worker threads do not go through the entry points of the bindings
+      [[maybe_unused]] avnd::denormal_guard<T> guard;
+      (*static_cast<func_type*>(ctx))(c);
+    });
+    return true;
+  }
 };
 
 /**
@@ -63,15 +147,57 @@ struct audio_buffer_storage
   [[no_unique_address]] buffer_type<double, T> m_dsp_buffer_output_f;
   [[no_unique_address]] buffer_type<float, T> m_dsp_buffer_input_d;
   [[no_unique_address]] buffer_type<float, T> m_dsp_buffer_output_d;
-  [[no_unique_address]] zero_storage<float> m_zero_storage_f;
-  [[no_unique_address]] zero_storage<double> m_zero_storage_d;
+  // only acquired by the adapters which use them, see allocate_zero_buffers.
+  // The read-only zeros are shared by all the instances, the sinks
+  // and the zeros of the writable inputs are not.
+  shared_zero_buffers<float>::buffers_ptr m_zero_storage_f;
+  shared_zero_buffers<double>::buffers_ptr m_zero_storage_d;
+  std::unique_ptr<sink_buffers<float>> m_sink_storage_f;
+  std::unique_ptr<sink_buffers<double>> m_sink_storage_d;
+  std::unique_ptr<sink_buffers<float>> m_writable_zero_storage_f;
+  std::unique_ptr<sink_buffers<double>> m_writable_zero_storage_d;
 
   auto& input_buffer_for(float) { return m_dsp_buffer_input_f; }
   auto& input_buffer_for(double) { return m_dsp_buffer_input_d; }
   auto& output_buffer_for(float) { return m_dsp_buffer_output_f; }
   auto& output_buffer_for(double) { return m_dsp_buffer_output_d; }
-  auto& zero_storage_for(float) { return m_zero_storage_f; }
-  auto& zero_storage_for(double) { return m_zero_storage_d; }
+  auto& zero_storage_for(float)
+  {
+    assert(m_zero_storage_f);
+    return *m_zero_storage_f;
+  }
+  auto& zero_storage_for(double)
+  {
+    assert(m_zero_storage_d);
+    return *m_zero_storage_d;
+  }
+  auto& sink_storage_for(float)
+  {
+    assert(m_sink_storage_f);
+    return *m_sink_storage_f;
+  }
+  auto& sink_storage_for(double)
+  {
+    assert(m_sink_storage_d);
+    return *m_sink_storage_d;
+  }
+  auto& writable_zero_storage_for(float)
+  {
+    assert(m_writable_zero_storage_f);
+    return *m_writable_zero_storage_f;
+  }
+  auto& writable_zero_storage_for(double)
+  {
+    assert(m_writable_zero_storage_d);
+    return *m_writable_zero_storage_d;
+  }
+
+  // Start of channel c for a block of n frames in a conversion buffer
+  template <typename FP, typename Alloc>
+  static FP* converted_channel(std::vector<FP, Alloc>& buffer, int c, int n) noexcept
+  {
+    return buffer.data() + c * aligned_channel_stride<FP>(n);
+  }
 
   template <std::floating_point SrcFP>
   void allocate_buffers(process_setup setup, SrcFP f)
@@ -81,37 +207,29 @@ struct audio_buffer_storage
     if constexpr (needs_storage<SrcFP, T>::value)
     {
       using needed_type = typename needs_storage<SrcFP, T>::needed_storage_t;
-      input_buffer_for(needed_type{})
-          .resize(setup.frames_per_buffer * setup.input_channels);
-      output_buffer_for(needed_type{})
-          .resize(setup.frames_per_buffer * setup.output_channels);
+      // Each channel starts on an aligned boundary, see converted_channel
+      const int stride = aligned_channel_stride<needed_type>(setup.frames_per_buffer);
+      input_buffer_for(needed_type{}).resize(stride * setup.input_channels);
+      output_buffer_for(needed_type{}).resize(stride * setup.output_channels);
     }
+  }
 
-    // Let's play it safe for the cases where the host does not supply
-    // enough buffers
-    auto& floats = zero_storage_for(float{});
-    auto& doubles = zero_storage_for(double{});
-    floats.zeros_in.resize(setup.frames_per_buffer);
-    floats.zeros_out.resize(setup.frames_per_buffer);
-    doubles.zeros_in.resize(setup.frames_per_buffer);
-    doubles.zeros_out.resize(setup.frames_per_buffer);
-
-    int max_channels_in = (16 + setup.input_channels) * 16;
-    int max_channels_out = (16 + setup.output_channels) * 16;
-    floats.zero_pointers_in.resize(max_channels_in);
-    floats.zero_pointers_out.resize(max_channels_out);
-    doubles.zero_pointers_in.resize(max_channels_in);
-    doubles.zero_pointers_out.resize(max_channels_out);
-    for (int i = 0; i < max_channels_in; i++)
-    {
-      floats.zero_pointers_in[i] = floats.zeros_in.data();
-      doubles.zero_pointers_in[i] = doubles.zeros_in.data();
-    }
-    for (int i = 0; i < max_channels_out; i++)
-    {
-      floats.zero_pointers_out[i] = floats.zeros_out.data();
-      doubles.zero_pointers_out[i] = doubles.zeros_out.data();
-    }
+  // Let's play it safe for the cases where the host does not supply
+  // enough buffers. The read-only zeros come from the process-wide pool;
+  // each adapter has its own sink, and its own zeros for the inputs
+  // which are not const, as they can be written to by the processor.
+  void allocate_zero_buffers(process_setup setup)
+  {
+    const int max_channels
+        = (16 + std::max(setup.input_channels, setup.output_channels)) * 16;
+    m_zero_storage_f
+        = shared_zero_buffers<float>::acquire(setup.frames_per_buffer, max_channels);
+    m_zero_storage_d
+        = shared_zero_buffers<double>::acquire(setup.frames_per_buffer, max_channels);
+    reserve_sink_buffers(m_sink_storage_f, setup.frames_per_buffer, max_channels);
+    reserve_sink_buffers(m_sink_storage_d, setup.frames_per_buffer, max_channels);
+    reserve_sink_buffers(m_writable_zero_storage_f, setup.frames_per_buffer, max_channels);
+    reserve_sink_buffers(m_writable_zero_storage_d, setup.frames_per_buffer, max_channels);
   }
 };
 }
@@ -15,6 +15,7 @@ requires(
     avnd::mono_per_channel_arg_processor<
         double,
         T> || avnd::mono_per_channel_arg_processor<float, T>) struct process_adapter<T>
+    : per_channel_executor<T>
 {
   void allocate_buffers(process_setup setup, auto&& f)
   {
@@ -44,12 +45,25 @@ requires(
     const int channels = input_channels;
 
     // Write the output channels
-    // C++20: we're using our coroutine here !
     auto effects_range = implementation.full_state();
+    if constexpr (requires { effects_range[0]; })
+    {
+      const int instances = std::min(channels, int(effects_range.size()));
+      auto run_channel = [&](int c) {
+        auto&& [impl, ins, outs] = effects_range[c];
+        if constexpr (requires { sizeof(current_tick(implementation)); })
+          process_channel(in[c], out[c], impl, ins, outs, current_tick(implementation));
+        else
+          process_channel(in[c], out[c], impl, ins, outs, n);
+      };
+      if (this->run_channels_in_parallel(instances, in, out, n, run_channel))
+        return;
+    }
+
     auto effects_it = effects_range.begin();
     for (int c = 0; c < channels && effects_it != effects_range.end(); ++c, ++effects_it)
     {
-      auto& [impl, ins, outs] = *effects_it;
+      auto&& [impl, ins, outs] = *effects_it;
 
       if constexpr (requires { sizeof(current_tick(implementation)); })
       {
@@ -20,6 +20,13 @@ requires(
   using i_info = avnd::audio_channel_input_introspection<T>;
   using o_info = avnd::audio_channel_output_introspection<T>;
 
+  template <std::floating_point SrcFP>
+  void allocate_buffers(process_setup setup, SrcFP f)
+  {
+    audio_buffer_storage<T>::allocate_buffers(setup, f);
+    this->allocate_zero_buffers(setup);
+  }
+
   template <typename Info, bool Input, typename Ports>
   void initialize_busses(Ports& ports, auto buffers)
   {
@@ -29,20 +36,27 @@ requires(
         [&](auto& bus)
         {
           using sample_type = std::decay_t<decltype(bus.channel[0])>;
+          constexpr bool read_only
+              = std::is_const_v<std::remove_reference_t<decltype(bus.channel[0])>>;
           if (k + 1 <= buffers.size())
           {
             bus.channel = const_cast<decltype(bus.channel)>(buffers[k]);
           }
           else
           {
-            auto& b = this->zero_storage_for(sample_type{});
-            if constexpr (Input)
+            if constexpr (Input && read_only)
+            {
+              bus.channel = this->zero_storage_for(sample_type{}).zeros.data();
+            }
+            else if constexpr (Input)
             {
-              bus.channel = b.zeros_in.data();
+              auto& zeros = this->writable_zero_storage_for(sample_type{});
+              zeros.clear();
+              bus.channel = zeros.sink.data();
             }
             else
             {
-              bus.channel = b.zeros_out.data();
+              bus.channel = this->sink_storage_for(sample_type{}).sink.data();
             }
           }
           k++;
@@ -60,7 +74,7 @@ requires(
         {
           if (k + 1 <= buffers.size())
           {
-            std::copy_n(bus.channel, n, buffers[k]);
+            avnd::convert_samples(bus.channel, buffers[k], n);
           }
           k++;
         });
@@ -94,8 +108,8 @@ requires(
         auto i_conv = (DstFP**)alloca(sizeof(DstFP*) * input_channels);
         for (int c = 0; c < input_channels; ++c)
         {
-          i_conv[c] = dsp_buffer_input.data() + c * n;
-          std::copy_n(in[c], n, i_conv[c]);
+          i_conv[c] = audio_buffer_storage<T>::converted_channel(dsp_buffer_input, c, n);
+          avnd::convert_samples(in[c], i_conv[c], n);
         }
 
         initialize_busses<i_info, true>(
@@ -111,7 +125,7 @@ requires(
         auto o_conv = (DstFP**)alloca(sizeof(DstFP*) * output_channels);
         for (int c = 0; c < output_channels; ++c)
         {
-          o_conv[c] = dsp_buffer_output.data() + c * n;
+          o_conv[c] = audio_buffer_storage<T>::converted_channel(dsp_buffer_output, c, n);
         }
 
         initialize_busses<o_info, false>(
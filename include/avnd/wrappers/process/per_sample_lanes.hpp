@@ -0,0 +1,153 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/wrappers/process/base.hpp>
+#include <avnd/wrappers/smoothing.hpp>
+
+namespace avnd
+{
+
+/**
+ * Mono processors with e.g. template<typename S> S operator()(S in, ...);
+ * which opted-in to be instantiated with SIMD lanes: see lane_packed_processor.
+ * Each packed instance processes "lanes" channels at once.
+ */
+template <typename T>
+requires(
+    (avnd::mono_per_sample_arg_processor<
+         double,
+         T> || avnd::mono_per_sample_arg_processor<float, T>)
+    && avnd::lane_packed_processor<T>) struct process_adapter<T>
+{
+  using packed_type = typename lane_packing<T>::packed_type;
+  using lane_type = typename lane_packing<T>::lane_type;
+  static constexpr int lanes = lane_packing<T>::lanes;
+
+  [[no_unique_address]] per_frame_smoothing<T> m_smoothing;
+
+  void allocate_buffers(process_setup setup, auto&& f)
+  {
+    // No buffer to allocates here
+  }
+
+  lane_type
+  process_sample(lane_type in, packed_type& fx, auto& ins, auto& outs, auto&& tick)
+  {
+    if constexpr (requires { fx(in, ins, outs, tick); })
+      return fx(in, ins, outs, tick);
+    else if constexpr (requires { fx(in, ins, tick); })
+      return fx(in, ins, tick);
+    else if constexpr (requires { fx(in, outs, tick); })
+      return fx(in, outs, tick);
+    else if constexpr (requires { fx(in, tick); })
+      return fx(in, tick);
+    else
+      static_assert(std::is_void_v<T>, "Canno call processor");
+  }
+
+  lane_type process_sample(lane_type in, packed_type& fx, auto& ins, auto& outs)
+  {
+    if constexpr (requires { fx(in, ins, outs); })
+      return fx(in, ins, outs);
+    else if constexpr (requires { fx(in, ins); })
+      return fx(in, ins);
+    else if constexpr (requires { fx(in, outs); })
+      return fx(in, outs);
+    else if constexpr (requires { fx(in); })
+      return fx(in);
+    else
+      static_assert(std::is_void_v<T>, "Canno call processor");
+  }
+
+  // Processes one frame of the channels [first, first + count)
+  template <std::floating_point FP>
+  void process_frame(
+      avnd::effect_container<T>& implementation,
+      auto&& state,
+      avnd::span<FP*> in,
+      int32_t in_frame,
+      avnd::span<FP*> out,
+      int32_t out_frame,
+      int first,
+      int count)
+  {
+    auto&& [fx, ins, outs] = state;
+    m_smoothing.step(ins, out_frame);
+
+    // Gather the input channels in the lanes
+    lane_type x{};
+    for (int l = 0; l < count; l++)
+      x[l] = in[first + l][in_frame];
+
+    lane_type y;
+    if constexpr (requires { sizeof(current_tick(implementation)); })
+      y = process_sample(x, fx, ins, outs, current_tick(implementation));
+    else
+      y = process_sample(x, fx, ins, outs);
+
+    // Scatter back to the output channels
+    for (int l = 0; l < count; l++)
+      out[first + l][out_frame] = y[l];
+  }
+
+  template <std::floating_point FP>
+  void process(
+      avnd::effect_container<T>& implementation,
+      avnd::span<FP*> in,
+      avnd::span<FP*> out,
+      int32_t n)
+  {
+    const int input_channels = in.size();
+    const int output_channels = out.size();
+    assert(input_channels == output_channels);
+    const int channels = input_channels;
+    m_smoothing.save(implementation);
+
+    if (avnd::can_process_channel_major(in, out, n))
+    {
+      // Each packed instance runs over the whole block
+      int first = 0;
+      for (auto&& state : implementation.full_state())
+      {
+        const int count = std::min(lanes, channels - first);
+        if (count <= 0)
+          break;
+
+        for (int32_t i = 0; i < n; i++)
+          process_frame(implementation, state, in, i, out, i, first, count);
+        first += lanes;
+      }
+    }
+    else
+    {
+      // Buffers alias (e.g. Pd): go frame by frame across all the instances,
+      // fetching all the inputs before writing any output.
+      auto input_buf = (FP*)alloca(channels * sizeof(FP));
+      auto input_ptrs = (FP**)alloca(channels * sizeof(FP*));
+      for (int c = 0; c < channels; c++)
+        input_ptrs[c] = input_buf + c;
+      const avnd::span<FP*> frame_in(input_ptrs, channels);
+
+      for (int32_t i = 0; i < n; i++)
+      {
+        for (int c = 0; c < channels; c++)
+          input_buf[c] = in[c][i];
+
+        int first = 0;
+        for (auto&& state : implementation.full_state())
+        {
+          const int count = std::min(lanes, channels - first);
+          if (count <= 0)
+            break;
+
+          process_frame(implementation, state, frame_in, 0, out, i, first, count);
+          first += lanes;
+        }
+      }
+    }
+
+    m_smoothing.restore(implementation);
+  }
+};
+}
@@ -3,6 +3,7 @@
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include <avnd/wrappers/process/base.hpp>
+#include <avnd/wrappers/smoothing.hpp>
 
 namespace avnd
 {
@@ -15,7 +16,10 @@ requires(
     avnd::mono_per_sample_port_processor<
         double,
         T> || avnd::mono_per_sample_port_processor<float, T>) struct process_adapter<T>
+    : per_channel_executor<T>
 {
+  [[no_unique_address]] per_frame_smoothing<T> m_smoothing;
+
   void allocate_buffers(process_setup setup, auto&& f)
   {
     // No buffer to allocates here
@@ -23,9 +27,12 @@ requires(
 
   // Here we know that we at least have one in and one out
   template <typename FP>
-  FP process_0(avnd::effect_container<T>& implementation, FP in, auto& ref, auto&& tick)
+  FP process_0(
+      avnd::effect_container<T>& implementation, FP in, int32_t frame, auto&& ref,
+      auto&& tick)
   {
     auto& [fx, ins, outs] = ref;
+    m_smoothing.step(ins, frame);
     // Copy the input
     pfr::for_each_field(
         ins,
@@ -46,9 +53,10 @@ requires(
   }
 
   template <typename FP>
-  FP process_0(avnd::effect_container<T>& implementation, FP in, auto& ref)
+  FP process_0(avnd::effect_container<T>& implementation, FP in, int32_t frame, auto&& ref)
   {
     auto& [fx, ins, outs] = ref;
+    m_smoothing.step(ins, frame);
     // Copy the input
     pfr::for_each_field(
         ins, [in]<typename Field>(Field& field) { if_possible(field.sample = in); });
@@ -63,17 +71,62 @@ requires(
     return out;
   }
 
+  // Runs each instance over the whole block, one channel after each other:
+  // the state of each instance stays hot and the inner loop can be optimized.
   template <std::floating_point FP>
-  void process(
+  void process_channel_major(
       avnd::effect_container<T>& implementation,
       avnd::span<FP*> in,
       avnd::span<FP*> out,
       int32_t n)
   {
-    const int input_channels = in.size();
-    const int output_channels = out.size();
-    assert(input_channels == output_channels);
-    const int channels = input_channels;
+    const int channels = in.size();
+    auto run_channel = [&](auto&& state, int c) {
+      const FP* in_c = in[c];
+      FP* out_c = out[c];
+      if constexpr (requires { sizeof(current_tick(implementation)); })
+      {
+        for (int32_t i = 0; i < n; i++)
+          out_c[i] = process_0(
+              implementation, in_c[i], i, state, current_tick(implementation));
+      }
+      else
+      {
+        for (int32_t i = 0; i < n; i++)
+          out_c[i] = process_0(implementation, in_c[i], i, state);
+      }
+    };
+
+    // The instances can also run in parallel, see per_channel_executor,
+    // unless they share their inputs: the input sample is written in them.
+    auto effects_range = implementation.full_state();
+    if constexpr (requires { effects_range[0]; } && !avnd::inputs_is_type<T>)
+    {
+      const int instances = std::min(channels, int(effects_range.size()));
+      if (this->run_channels_in_parallel(
+              instances, in, out, n, [&](int c) { run_channel(effects_range[c], c); }))
+        return;
+    }
+
+    int c = 0;
+    for (auto&& state : effects_range)
+    {
+      if (c >= channels)
+        break;
+      run_channel(state, c);
+      ++c;
+    }
+  }
+
+  // Processes all the channels for a given sample before going to the next sample
+  template <std::floating_point FP>
+  void process_sample_major(
+      avnd::effect_container<T>& implementation,
+      avnd::span<FP*> in,
+      avnd::span<FP*> out,
+      int32_t n)
+  {
+    const int channels = in.size();
 
     auto input_buf = (FP*)alloca(channels * sizeof(FP));
 
@@ -93,8 +146,8 @@ requires(
         input_buf[c] = in[c][i];
       }
 
-      // Write the output channels
-      // C++20: we're using our coroutine here !
+      // Write the output channels.
+      // full_state() is a non-allocating range over the instances (see member_range)
       auto effects_range = implementation.full_state();
       auto effects_it = effects_range.begin();
       for (int c = 0; c < channels && effects_it != effects_range.end();
@@ -103,15 +156,38 @@ requires(
         if constexpr (requires { sizeof(current_tick(implementation)); })
         {
           out[c][i] = process_0(
-              implementation, input_buf[c], *effects_it, current_tick(implementation));
+              implementation, input_buf[c], i, *effects_it, current_tick(implementation));
         }
         else
         {
-          out[c][i] = process_0(implementation, input_buf[c], *effects_it);
+          out[c][i] = process_0(implementation, input_buf[c], i, *effects_it);
         }
       }
     }
   }
+
+  template <std::floating_point FP>
+  void process(
+      avnd::effect_container<T>& implementation,
+      avnd::span<FP*> in,
+      avnd::span<FP*> out,
+      int32_t n)
+  {
+    const int input_channels = in.size();
+    const int output_channels = out.size();
+    assert(input_channels == output_channels);
+
+    m_smoothing.save(implementation);
+
+    // We can only go channel-by-channel if the outputs we write
+    // do not overwrite inputs which have not been processed yet.
+    if (avnd::can_process_channel_major(in, out, n))
+      process_channel_major(implementation, in, out, n);
+    else
+      process_sample_major(implementation, in, out, n);
+
+    m_smoothing.restore(implementation);
+  }
 };
 
 /**
@@ -123,6 +199,8 @@ requires(
         float,
         T> || poly_per_sample_port_processor<double, T>) struct process_adapter<T>
 {
+  [[no_unique_address]] per_frame_smoothing<T> m_smoothing;
+
   void process_sample(T& fx, auto& ins, auto& outs, auto&& tick)
   {
     if constexpr (requires { fx(ins, outs, tick); })
@@ -166,9 +244,12 @@ requires(
     auto& fx = implementation.effect;
     auto& ins = implementation.inputs();
     auto& outs = implementation.outputs();
+    m_smoothing.save(implementation);
 
     for (int32_t i = 0; i < n; i++)
     {
+      m_smoothing.step(ins, i);
+
       // Copy inputs in the effect
       {
         int k = 0;
@@ -217,6 +298,8 @@ requires(
             });
       }
     }
+
+    m_smoothing.restore(implementation);
   }
 };
 
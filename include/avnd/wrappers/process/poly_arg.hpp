@@ -41,13 +41,13 @@ requires polyphonic_audio_processor<T> &&(
       // Copy & convert input channels
       for (int c = 0; c < input_channels; ++c)
       {
-        in_samples[c] = dsp_buffer_input.data() + c * n;
-        std::copy_n(in[c], n, in_samples[c]);
+        in_samples[c] = audio_buffer_storage<T>::converted_channel(dsp_buffer_input, c, n);
+        avnd::convert_samples(in[c], in_samples[c], n);
       }
 
       for (int c = 0; c < output_channels; ++c)
       {
-        out_samples[c] = dsp_buffer_output.data() + c * n;
+        out_samples[c] = audio_buffer_storage<T>::converted_channel(dsp_buffer_output, c, n);
       }
 
       implementation.effect(in_samples, out_samples, n);
@@ -55,7 +55,7 @@ requires polyphonic_audio_processor<T> &&(
       // Copy & convert output channels
       for (int c = 0; c < output_channels; ++c)
       {
-        std::copy_n(out_samples[c], n, out[c]);
+        avnd::convert_samples(out_samples[c], out[c], n);
       }
     }
     else
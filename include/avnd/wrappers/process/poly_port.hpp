@@ -52,14 +52,14 @@ struct process_adapter<T> : audio_buffer_storage<T>
       // Copy & convert input channels
       for (int c = 0; c < input_channels; ++c)
       {
-        auto in_ptr = dsp_buffer_input.data() + c * n;
-        std::copy_n(in[c], n, in_ptr);
+        auto in_ptr = audio_buffer_storage<T>::converted_channel(dsp_buffer_input, c, n);
+        avnd::convert_samples(in[c], in_ptr, n);
         in_port.samples[c] = const_cast<input_fp_type*>(in_ptr);
       }
 
       for (int c = 0; c < output_channels; ++c)
       {
-        out_port.samples[c] = dsp_buffer_output.data() + c * n;
+        out_port.samples[c] = audio_buffer_storage<T>::converted_channel(dsp_buffer_output, c, n);
       }
 
       invoke_effect(implementation, n);
@@ -67,7 +67,7 @@ struct process_adapter<T> : audio_buffer_storage<T>
       // Copy & convert output channels
       for (int c = 0; c < output_channels; ++c)
       {
-        std::copy_n(out_port.samples[c], n, out[c]);
+        avnd::convert_samples(out_port.samples[c], out[c], n);
       }
     }
     else
@@ -118,6 +118,13 @@ requires polyphonic_audio_processor<T> &&(
   using i_info = avnd::audio_bus_input_introspection<T>;
   using o_info = avnd::audio_bus_output_introspection<T>;
 
+  template <std::floating_point SrcFP>
+  void allocate_buffers(process_setup setup, SrcFP f)
+  {
+    audio_buffer_storage<T>::allocate_buffers(setup, f);
+    this->allocate_zero_buffers(setup);
+  }
+
   template <typename Info, bool Input, typename Ports>
   void initialize_busses(Ports& ports, auto buffers)
   {
@@ -127,6 +134,8 @@ requires polyphonic_audio_processor<T> &&(
         [&](auto& bus)
         {
           using sample_type = std::decay_t<decltype(bus.samples[0][0])>;
+          constexpr bool read_only
+              = std::is_const_v<std::remove_reference_t<decltype(bus.samples[0][0])>>;
           const int channels = avnd::get_channels(bus);
 
           if (k + channels <= buffers.size())
@@ -136,15 +145,21 @@ requires polyphonic_audio_processor<T> &&(
           }
           else
           {
-            auto& b = this->zero_storage_for(sample_type{});
-            if constexpr (Input)
+            if constexpr (Input && read_only)
             {
-              auto buffer = b.zero_pointers_in.data();
+              // Only the pointer array is const-casted: the samples stay read-only
+              auto buffer = this->zero_storage_for(sample_type{}).zero_pointers.data();
               bus.samples = const_cast<decltype(bus.samples)>(buffer);
             }
+            else if constexpr (Input)
+            {
+              auto& zeros = this->writable_zero_storage_for(sample_type{});
+              zeros.clear();
+              bus.samples = zeros.sink_pointers.data();
+            }
             else
             {
-              auto buffer = b.zero_pointers_out.data();
+              auto buffer = this->sink_storage_for(sample_type{}).sink_pointers.data();
               bus.samples = const_cast<decltype(bus.samples)>(buffer);
             }
           }
@@ -166,7 +181,7 @@ requires polyphonic_audio_processor<T> &&(
           if (k + channels < buffers.size())
           {
             for (int c = 0; c < channels; c++)
-              std::copy_n(bus.samples[c], n, buffers[k + c]);
+              avnd::convert_samples(bus.samples[c], buffers[k + c], n);
           }
           k += channels;
         });
@@ -201,8 +216,8 @@ requires polyphonic_audio_processor<T> &&(
         auto i_conv = (DstFP**)alloca(sizeof(DstFP*) * input_channels);
         for (int c = 0; c < input_channels; ++c)
         {
-          i_conv[c] = dsp_buffer_input.data() + c * n;
-          std::copy_n(in[c], n, i_conv[c]);
+          i_conv[c] = audio_buffer_storage<T>::converted_channel(dsp_buffer_input, c, n);
+          avnd::convert_samples(in[c], i_conv[c], n);
         }
 
         initialize_busses<i_info, true>(
@@ -218,7 +233,7 @@ requires polyphonic_audio_processor<T> &&(
         auto o_conv = (DstFP**)alloca(sizeof(DstFP*) * output_channels);
         for (int c = 0; c < output_channels; ++c)
         {
-          o_conv[c] = dsp_buffer_output.data() + c * n;
+          o_conv[c] = audio_buffer_storage<T>::converted_channel(dsp_buffer_output, c, n);
         }
 
         initialize_busses<o_info, false>(
@@ -2,9 +2,54 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
+#include <avnd/wrappers/fixed_block_process_adapter.hpp>
+#include <avnd/wrappers/oversampling_process_adapter.hpp>
 #include <avnd/wrappers/process/per_channel_arg.hpp>
 #include <avnd/wrappers/process/per_channel_port.hpp>
 #include <avnd/wrappers/process/per_sample_arg.hpp>
+#include <avnd/wrappers/process/per_sample_lanes.hpp>
 #include <avnd/wrappers/process/per_sample_port.hpp>
 #include <avnd/wrappers/process/poly_arg.hpp>
 #include <avnd/wrappers/process/poly_port.hpp>
+#include <avnd/wrappers/silence_process_adapter.hpp>
+#include <avnd/wrappers/sub_block_process_adapter.hpp>
+
+namespace avnd
+{
+/**
+ * How the blocks from the host are given to the processor:
+ * re-buffered to a fixed size, split at control changes, or as they are.
+ */
+template <typename T>
+using block_process_adapter_for = std::conditional_t<
+    avnd::fixed_block_processor<T>,
+    fixed_block_process_adapter<T>,
+    std::conditional_t<
+        avnd::splits_at_control_changes<T>,
+        sub_block_process_adapter<T>,
+        process_adapter<T>>>;
+
+/**
+ * Oversampled processors get their blocks after the upsampling.
+ * The timestamps of the controls are not scaled, thus they are not split.
+ */
+template <typename T>
+using rate_process_adapter_for = std::conditional_t<
+    avnd::oversampled_processor<T>,
+    oversampling_process_adapter<
+        T,
+        std::conditional_t<
+            avnd::fixed_block_processor<T>,
+            fixed_block_process_adapter<T>,
+            process_adapter<T>>>,
+    block_process_adapter_for<T>>;
+
+/**
+ * The process adapter the bindings should use for a given processor.
+ */
+template <typename T>
+using process_adapter_for = std::conditional_t<
+    avnd::skips_silence<T>,
+    silence_process_adapter<T, rate_process_adapter_for<T>>,
+    rate_process_adapter_for<T>>;
+}
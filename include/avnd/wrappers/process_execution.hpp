@@ -2,11 +2,14 @@
 
 /* SPDX-License-Identifier: GPL-3.0-or-later */
 
+#include <avnd/common/aligned_allocator.hpp>
+#include <avnd/common/trace.hpp>
 #include <avnd/concepts/audio_port.hpp>
 #include <avnd/concepts/audio_processor.hpp>
 #include <avnd/introspection/channels.hpp>
 #include <avnd/introspection/input.hpp>
 #include <avnd/introspection/output.hpp>
+#include <avnd/wrappers/metadatas.hpp>
 
 #include <concepts>
 #include <cstdint>
@@ -55,8 +58,9 @@ requires(
 template <typename FP, typename T>
 using buffer_type = std::conditional_t<
     needs_storage<FP, T>::value,
-    std::vector<typename needs_storage<FP, T>::needed_storage_t> // TODO aligned alloc
-    ,
+    std::vector<
+        typename needs_storage<FP, T>::needed_storage_t,
+        avnd::aligned_allocator<typename needs_storage<FP, T>::needed_storage_t>>,
     dummy>;
 
 // Original idea was to pass everything by arguments here.
@@ -80,6 +84,8 @@ auto current_tick(avnd::effect_container<T>& implementation)
 template <typename T>
 void invoke_effect(avnd::effect_container<T>& implementation, int frames)
 {
+  [[maybe_unused]] avnd::trace_span span{"invoke", avnd::get_name<T>()};
+
   // clang-format off
   if constexpr (has_tick<T>)
   {
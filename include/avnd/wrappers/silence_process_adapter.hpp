@@ -0,0 +1,115 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/silence.hpp>
+#include <avnd/concepts/audio_processor.hpp>
+#include <avnd/introspection/input.hpp>
+#include <avnd/wrappers/latency.hpp>
+#include <avnd/wrappers/process/base.hpp>
+
+#include <algorithm>
+
+namespace avnd
+{
+/**
+ * Processors for which we know when the output becomes silent once the input is:
+ * either they declare silence_in_silence_out, or they declare a finite tail.
+ *
+ * Processors with MIDI inputs never qualify, as they may produce sound
+ * out of silence, e.g. synthesizers.
+ */
+template <typename T>
+concept skips_silence
+    = (avnd::silence_in_silence_out<T> || avnd::has_tail<T>)
+      && (avnd::midi_input_introspection<T>::size == 0)
+      && (avnd::raw_container_midi_input_introspection<T>::size == 0)
+      && (avnd::dynamic_container_midi_input_introspection<T>::size == 0);
+
+/**
+ * Skips the processing of blocks whose input is silent,
+ * once the tail and the latency of the processor have been played:
+ * the outputs are then zeroed instead of calling the processor.
+ *
+ * Note that when the processing is skipped, the other outputs
+ * of the processor (e.g. value outputs) are not updated.
+ *
+ * Bindings can check output_silent() after each call to tell the host
+ * that the output is silent, e.g. with VST3 silence flags.
+ */
+template <typename T, typename Base>
+struct silence_process_adapter : Base
+{
+  // Frames of silent input processed since the last non-silent input
+  int64_t m_silent_frames{};
+  bool m_output_silent{};
+
+  bool output_silent() const noexcept { return m_output_silent; }
+
+  template <std::floating_point SrcFP>
+  void allocate_buffers(process_setup setup, SrcFP f)
+  {
+    Base::allocate_buffers(setup, f);
+    m_silent_frames = 0;
+    m_output_silent = false;
+  }
+
+  template <std::floating_point FP>
+  static bool input_silent(avnd::span<FP*> in, int32_t n) noexcept
+  {
+    // Nothing to decide on for generators
+    if (in.size() == 0)
+      return false;
+
+    for (FP* channel : in)
+      if (channel && !avnd::is_silent(channel, n))
+        return false;
+    return true;
+  }
+
+  template <std::floating_point FP>
+  void process(
+      avnd::effect_container<T>& implementation,
+      avnd::span<FP*> in,
+      avnd::span<FP*> out,
+      int32_t n)
+  {
+    m_output_silent = false;
+    if (!input_silent(in, n))
+    {
+      m_silent_frames = 0;
+      Base::process(implementation, in, out, n);
+      return;
+    }
+
+    if (const uint32_t tail = avnd::get_tail(implementation); tail != infinite_tail)
+    {
+      const int64_t remaining
+          = int64_t(tail) + avnd::get_latency(implementation, *this) - m_silent_frames;
+      if (remaining <= 0)
+      {
+        for (FP* channel : out)
+          if (channel)
+            std::fill_n(channel, n, FP{});
+        m_output_silent = true;
+        return;
+      }
+    }
+
+    Base::process(implementation, in, out, n);
+    m_silent_frames += n;
+  }
+};
+
+/**
+ * For the bindings: whether the last processed block is known to be silent.
+ */
+template <typename Adapter>
+bool output_silent(const Adapter& processor) noexcept
+{
+  if constexpr (requires { processor.output_silent(); })
+    return processor.output_silent();
+  else
+    return false;
+}
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/smoother.hpp>
+#include <avnd/introspection/input.hpp>
+#include <avnd/wrappers/effect_container.hpp>
+#include <avnd/wrappers/timed_values.hpp>
+#include <boost/mp11.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace avnd
+{
+template <typename Field>
+using smooth_param_value_type = std::decay_t<decltype(Field::value)>;
+template <typename Field>
+using smoother_type = avnd::smoother<smooth_param_value_type<Field>>;
+template <typename Field>
+using smooth_ramp_type = std::decay_t<decltype(Field::ramp)>;
+
+/**
+ * Ramps the smooth inputs (see avnd::smooth_parameter) of a processor.
+ *
+ * Member of the bindings, next to the processor:
+ *
+ *   [[no_unique_address]] avnd::control_smoothing<T> smoothing;
+ *
+ *   // when starting
+ *   smoothing.reserve_space(effect, buffer_size, sample_rate);
+ *
+ *   // in the process entry point, once the controls are applied
+ *   smoothing.process(effect, frames);
+ *
+ * For each input, the ramp of the block is computed in one go in a buffer
+ * allocated when starting, which the "ramp" member of the port then points to.
+ * The ramp goes towards the "value" of the port, or for sample-accurate ports,
+ * towards each timestamped value from its frame on.
+ *
+ * Mono processors duplicated per channel get the same control values
+ * in each instance: the ramps are computed from the first instance,
+ * and the ports of all the instances point to them.
+ *
+ * The ramps cover the block given to the binding by the host: adapters which
+ * split it use smooth_ramp_offsets, and the per-sample adapters step the
+ * value of the ports along the ramps with per_frame_smoothing.
+ * Fixed-size blocks and oversampling do not see the frames of the host,
+ * and are rejected at compile time.
+ */
+template <typename T>
+struct control_smoothing
+{
+  void reserve_space(avnd::effect_container<T>&, int, double) { }
+  void process(avnd::effect_container<T>&, int) { }
+};
+
+template <typename T>
+requires(smooth_parameter_input_introspection<T>::size > 0)
+struct control_smoothing<T>
+{
+  using smooth_in = smooth_parameter_input_introspection<T>;
+
+  // std::tuple< avnd::smoother<float>, avnd::smoother<double> >
+  using smoothers = filter_and_apply<smoother_type, smooth_parameter_input_introspection, T>;
+
+  // std::tuple< std::vector<float>, std::vector<double> >
+  using buffers = boost::mp11::mp_transform<
+      std::vector,
+      filter_and_apply<smooth_param_value_type, smooth_parameter_input_introspection, T>>;
+
+  smoothers m_smoothers;
+  buffers m_ramps;
+
+  void reserve_space(avnd::effect_container<T>& t, int buffer_size, double rate)
+  {
+    auto&& inputs = avnd::get_inputs(t);
+    if constexpr (multi_instance_range<decltype(inputs)>)
+    {
+      if (inputs.begin() == inputs.end())
+        return;
+      setup_ramps(*inputs.begin(), buffer_size, rate);
+      for (auto& instance : inputs)
+        share_ramps(instance, buffer_size);
+    }
+    else
+    {
+      setup_ramps(inputs, buffer_size, rate);
+    }
+  }
+
+  void process(avnd::effect_container<T>& t, int frames) noexcept
+  {
+    auto&& inputs = avnd::get_inputs(t);
+    if constexpr (multi_instance_range<decltype(inputs)>)
+    {
+      if (inputs.begin() == inputs.end())
+        return;
+      fill_ramps(*inputs.begin(), frames);
+      for (auto& instance : inputs)
+        share_ramps(instance, frames);
+    }
+    else
+    {
+      fill_ramps(inputs, frames);
+    }
+  }
+
+private:
+  void setup_ramps(auto& inputs, int buffer_size, double rate)
+  {
+    smooth_in::for_all_n(
+        inputs, [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          auto& smoother = tpl::get<Idx>(m_smoothers);
+          auto& ramp = tpl::get<Idx>(m_ramps);
+
+          smoother.setup(M::smoothing, rate);
+          smoother.reset(port.value);
+
+          ramp.assign(std::max(buffer_size, 1), port.value);
+          port.ramp = {ramp.data(), ramp.size()};
+        });
+  }
+
+  // Points the ports of an instance to the ramps of the block
+  void share_ramps(auto& inputs, int frames) noexcept
+  {
+    smooth_in::for_all_n(
+        inputs, [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          auto& ramp = tpl::get<Idx>(m_ramps);
+          port.ramp = {ramp.data(), std::size_t(std::min(frames, int(ramp.size())))};
+        });
+  }
+
+  void fill_ramps(auto& inputs, int frames) noexcept
+  {
+    smooth_in::for_all_n(
+        inputs, [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          auto& smoother = tpl::get<Idx>(m_smoothers);
+          auto& ramp = tpl::get<Idx>(m_ramps);
+          const int n = std::min(frames, int(ramp.size()));
+
+          if constexpr (sample_accurate_parameter<M>)
+          {
+            if (next_timed_change(port, 0, n) < n)
+            {
+              // Retarget at each change
+              int from = 0;
+              while (from < n)
+              {
+                last_timed_value(port, from, from + 1, [&](const auto& v) {
+                  smoother.set_target(v);
+                });
+                const int next = next_timed_change(port, from + 1, n);
+                smoother.fill(ramp.data() + from, next - from);
+                from = next;
+              }
+              port.ramp = {ramp.data(), std::size_t(n)};
+              return;
+            }
+          }
+
+          smoother.set_target(port.value);
+          smoother.fill(ramp.data(), n);
+          port.ramp = {ramp.data(), std::size_t(n)};
+        });
+  }
+};
+
+/**
+ * For the adapters which process the block of the host in sub-blocks,
+ * e.g. sub_block_process_adapter: select() points the ramps of the ports
+ * to the frames of a sub-block, and restore() to the whole block again.
+ */
+template <typename T>
+struct smooth_ramp_offsets
+{
+  void save(avnd::effect_container<T>&) noexcept { }
+  void select(avnd::effect_container<T>&, int, int) noexcept { }
+  void restore(avnd::effect_container<T>&) noexcept { }
+};
+
+template <typename T>
+requires(smooth_parameter_input_introspection<T>::size > 0)
+struct smooth_ramp_offsets<T>
+{
+  using smooth_in = smooth_parameter_input_introspection<T>;
+
+  // The ramps over the whole block, shared by all the instances
+  filter_and_apply<smooth_ramp_type, smooth_parameter_input_introspection, T> m_ramps;
+
+  void save(avnd::effect_container<T>& t) noexcept
+  {
+    auto&& inputs = avnd::get_inputs(t);
+    if constexpr (multi_instance_range<decltype(inputs)>)
+    {
+      if (inputs.begin() != inputs.end())
+        save_ramps(*inputs.begin());
+    }
+    else
+    {
+      save_ramps(inputs);
+    }
+  }
+
+  void select(avnd::effect_container<T>& t, int start, int frames) noexcept
+  {
+    smooth_in::for_all_n(
+        avnd::get_inputs(t),
+        [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          auto& ramp = tpl::get<Idx>(m_ramps);
+          const auto first = std::min(std::size_t(start), ramp.size());
+          port.ramp = ramp.subspan(first, std::min(std::size_t(frames), ramp.size() - first));
+        });
+  }
+
+  void restore(avnd::effect_container<T>& t) noexcept
+  {
+    smooth_in::for_all_n(
+        avnd::get_inputs(t),
+        [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          port.ramp = tpl::get<Idx>(m_ramps);
+        });
+  }
+
+private:
+  void save_ramps(auto& inputs) noexcept
+  {
+    smooth_in::for_all_n(
+        inputs, [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          tpl::get<Idx>(m_ramps) = port.ramp;
+        });
+  }
+};
+
+/**
+ * Processors which work one frame at a time, e.g. float operator()(float in),
+ * cannot index the ramps: the per-sample adapters set the "value" of the ports
+ * to the ramp before each frame with step(), and put back the target of the
+ * ramps, i.e. the value set by the bindings, once the block is processed.
+ */
+template <typename T>
+struct per_frame_smoothing
+{
+  void save(avnd::effect_container<T>&) noexcept { }
+  void step(auto&, int) noexcept { }
+  void restore(avnd::effect_container<T>&) noexcept { }
+};
+
+template <typename T>
+requires(smooth_parameter_input_introspection<T>::size > 0)
+struct per_frame_smoothing<T>
+{
+  using smooth_in = smooth_parameter_input_introspection<T>;
+
+  // The values set by the bindings, the same in all the instances
+  filter_and_apply<smooth_param_value_type, smooth_parameter_input_introspection, T>
+      m_targets;
+
+  void save(avnd::effect_container<T>& t) noexcept
+  {
+    auto&& inputs = avnd::get_inputs(t);
+    if constexpr (multi_instance_range<decltype(inputs)>)
+    {
+      if (inputs.begin() != inputs.end())
+        save_targets(*inputs.begin());
+    }
+    else
+    {
+      save_targets(inputs);
+    }
+  }
+
+  // Called on the inputs of each instance
+  void step(auto& inputs, int frame) noexcept
+  {
+    smooth_in::for_all(inputs, [frame](auto& port) {
+      if (frame < int(port.ramp.size()))
+        port.value = port.ramp[frame];
+    });
+  }
+
+  void restore(avnd::effect_container<T>& t) noexcept
+  {
+    smooth_in::for_all_n(
+        avnd::get_inputs(t),
+        [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          port.value = tpl::get<Idx>(m_targets);
+        });
+  }
+
+private:
+  void save_targets(auto& inputs) noexcept
+  {
+    smooth_in::for_all_n(
+        inputs, [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          tpl::get<Idx>(m_targets) = port.value;
+        });
+  }
+};
+}
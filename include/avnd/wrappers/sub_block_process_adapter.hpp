@@ -0,0 +1,282 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/concepts/audio_processor.hpp>
+#include <avnd/concepts/parameter.hpp>
+#include <avnd/introspection/input.hpp>
+#include <avnd/wrappers/process/base.hpp>
+#include <avnd/wrappers/smoothing.hpp>
+#include <avnd/wrappers/timed_values.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace avnd
+{
+template <typename Field>
+using timed_param_value_type = std::decay_t<decltype(Field::value)>;
+
+/**
+ * Processors can set a lower bound on the size of the sub-blocks
+ * in order to bound the overhead of splitting:
+ *
+ *   static constexpr int minimum_sub_block_frames = 64;
+ *
+ * Changes which happen closer than that to the start of a sub-block
+ * are applied at the start of the sub-block.
+ */
+template <typename T>
+static constexpr int minimum_sub_block_frames() noexcept
+{
+  if constexpr (requires { T::minimum_sub_block_frames; })
+    return std::max(1, int(T::minimum_sub_block_frames));
+  else
+    return 16;
+}
+
+/**
+ * Processors which split_at_control_changes but have no sample-accurate input:
+ * the bindings can still split their blocks at the timestamped parameter
+ * changes sent by the host, see parameter_change_queue.
+ */
+template <typename T>
+concept splits_at_parameter_changes
+    = splits_at_control_changes<T>
+      && (linear_timed_parameter_input_introspection<T>::size
+              + span_timed_parameter_input_introspection<T>::size
+              + dynamic_timed_parameter_input_introspection<T>::size
+          == 0);
+
+/**
+ * The parameter changes received by a binding for a block, with their frame,
+ * for the processors which satisfy splits_at_parameter_changes.
+ * Empty for the others: the bindings apply the last value of each parameter.
+ *
+ * The block is processed in sub-blocks which start at each change.
+ * Changes closer than minimum_sub_block_frames to the start of a sub-block
+ * are applied at the start of the sub-block, as in sub_block_process_adapter.
+ */
+template <typename T>
+struct parameter_change_queue
+{
+  static constexpr bool enabled = false;
+};
+
+template <splits_at_parameter_changes T>
+struct parameter_change_queue<T>
+{
+  static constexpr bool enabled = true;
+
+  struct change
+  {
+    int frame{};
+    int index{};
+    double value{};
+  };
+
+  // Sorted by frame, in the order of arrival for a given frame
+  std::vector<change> changes;
+
+  void reserve_space(int capacity) { changes.reserve(std::max(capacity, 1)); }
+
+  // Does not allocate: when the queue is full, the change replaces the
+  // latest queued change of the same parameter, if any, and returns false
+  // otherwise: it should then be applied right away.
+  bool push(int frame, int index, double value) noexcept
+  {
+    if (changes.size() < changes.capacity())
+    {
+      auto it = std::upper_bound(
+          changes.begin(), changes.end(), frame,
+          [](int f, const change& c) { return f < c.frame; });
+      changes.insert(it, change{frame, index, value});
+      return true;
+    }
+
+    for (auto it = changes.rbegin(); it != changes.rend(); ++it)
+    {
+      if (it->index == index)
+      {
+        it->value = value;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // apply(const change&) sets a parameter,
+  // process(int start, int frames) processes a sub-block.
+  void process(int frames, int minimum_frames, auto&& apply, auto&& process)
+  {
+    const int min_frames = std::max(1, minimum_frames);
+    std::size_t next = 0;
+    int start = 0;
+    while (start < frames)
+    {
+      const int apply_end = std::min(frames, start + min_frames);
+      while (next < changes.size() && changes[next].frame < apply_end)
+        apply(changes[next++]);
+
+      const int end = next < changes.size() ? std::min(frames, changes[next].frame) : frames;
+      process(start, end - start);
+      start = end;
+    }
+
+    // Changes past the end of the block
+    while (next < changes.size())
+      apply(changes[next++]);
+    changes.clear();
+  }
+
+  // Applies all the queued changes, in order, when there is no audio to process,
+  // e.g. when a VST3 host flushes the parameters with an empty process call.
+  void flush(auto&& apply)
+  {
+    process(0, 1, apply, [](int, int) {});
+  }
+};
+
+/**
+ * Wraps the process_adapter of processors which satisfy splits_at_control_changes:
+ * the block is split at each timestamped change of a sample-accurate input,
+ * and the "value" of the controls is updated before each sub-block.
+ *
+ * At the start of a block, the controls which have changes get back the value
+ * they had at the end of the previous block, as the bindings may
+ * have set them to the latest value received.
+ *
+ * This does not allocate: the offset channel pointers live on the stack.
+ */
+template <typename T>
+struct sub_block_process_adapter : process_adapter<T>
+{
+  using lin_in = linear_timed_parameter_input_introspection<T>;
+  using span_in = span_timed_parameter_input_introspection<T>;
+  using dyn_in = dynamic_timed_parameter_input_introspection<T>;
+
+  // Can be changed by the host
+  int minimum_frames = minimum_sub_block_frames<T>();
+
+  // Value of the sample-accurate inputs at the end of the previous block
+  [[no_unique_address]] avnd::filter_and_apply<
+      timed_param_value_type,
+      linear_timed_parameter_input_introspection,
+      T> m_lin_values;
+  [[no_unique_address]] avnd::filter_and_apply<
+      timed_param_value_type,
+      span_timed_parameter_input_introspection,
+      T> m_span_values;
+  [[no_unique_address]] avnd::filter_and_apply<
+      timed_param_value_type,
+      dynamic_timed_parameter_input_introspection,
+      T> m_dyn_values;
+  bool m_has_values{};
+
+  // The smooth inputs see the frames of each sub-block of their ramps
+  [[no_unique_address]] smooth_ramp_offsets<T> m_ramps;
+
+  // Applies the last value timestamped in [from, to), if any.
+  template <typename Field>
+  static void apply_changes(Field& port, int from, int to) noexcept
+  {
+    last_timed_value(port, from, to, [&port](const auto& v) { port.value = v; });
+  }
+
+  void for_each_timed_input(avnd::effect_container<T>& implementation, auto&& f)
+  {
+    lin_in::for_all_n(
+        avnd::get_inputs(implementation),
+        [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          f(port, tpl::get<Idx>(m_lin_values));
+        });
+    span_in::for_all_n(
+        avnd::get_inputs(implementation),
+        [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          f(port, tpl::get<Idx>(m_span_values));
+        });
+    dyn_in::for_all_n(
+        avnd::get_inputs(implementation),
+        [&]<auto Idx, typename M>(M& port, avnd::predicate_index<Idx>) {
+          f(port, tpl::get<Idx>(m_dyn_values));
+        });
+  }
+
+  int next_change_all(avnd::effect_container<T>& implementation, int from, int to) noexcept
+  {
+    int next = to;
+    for_each_timed_input(implementation, [&](auto& port, auto&) {
+      next = std::min(next, next_timed_change(port, from, next));
+    });
+    return next;
+  }
+
+  template <std::floating_point FP>
+  void process(
+      avnd::effect_container<T>& implementation,
+      avnd::span<FP*> in,
+      avnd::span<FP*> out,
+      int32_t n)
+  {
+    if constexpr (lin_in::size + span_in::size + dyn_in::size == 0)
+    {
+      process_adapter<T>::process(implementation, in, out, n);
+    }
+    else
+    {
+      if (next_change_all(implementation, 0, n) == n)
+      {
+        // Nothing to split
+        process_adapter<T>::process(implementation, in, out, n);
+      }
+      else
+      {
+        // Start from the values at the end of the previous block
+        if (m_has_values)
+        {
+          for_each_timed_input(implementation, [&](auto& port, auto& previous) {
+            if (next_timed_change(port, 0, n) < n)
+              port.value = previous;
+          });
+        }
+
+        const int input_channels = in.size();
+        const int output_channels = out.size();
+        auto in_ptrs = (FP**)alloca(sizeof(FP*) * (1 + input_channels));
+        auto out_ptrs = (FP**)alloca(sizeof(FP*) * (1 + output_channels));
+        const int min_frames = std::max(1, minimum_frames);
+        m_ramps.save(implementation);
+
+        int start = 0;
+        while (start < n)
+        {
+          // Changes too close to the start of the sub-block are applied right away
+          const int apply_end = std::min(n, start + min_frames);
+          for_each_timed_input(implementation, [&](auto& port, auto&) {
+            apply_changes(port, start, apply_end);
+          });
+          const int end = next_change_all(implementation, apply_end, n);
+
+          for (int c = 0; c < input_channels; c++)
+            in_ptrs[c] = in[c] ? in[c] + start : nullptr;
+          for (int c = 0; c < output_channels; c++)
+            out_ptrs[c] = out[c] ? out[c] + start : nullptr;
+          m_ramps.select(implementation, start, end - start);
+
+          process_adapter<T>::process(
+              implementation,
+              avnd::span<FP*>(in_ptrs, input_channels),
+              avnd::span<FP*>(out_ptrs, output_channels),
+              end - start);
+          start = end;
+        }
+        m_ramps.restore(implementation);
+      }
+
+      for_each_timed_input(
+          implementation, [&](auto& port, auto& previous) { previous = port.value; });
+      m_has_values = true;
+    }
+  }
+};
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/perfect_hash.hpp>
+#include <avnd/common/struct_reflection.hpp>
+#include <avnd/wrappers/metadatas.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace avnd
+{
+// The names of the fields seen by an introspection type, e.g. avnd::input_introspection<T>;
+// empty for the fields without a name
+template <typename Introspection>
+constexpr auto field_names() noexcept
+{
+  std::array<std::string_view, Introspection::size> names{};
+  int k = 0;
+  Introspection::for_all(
+      [&]<std::size_t Idx, typename F>(avnd::field_reflection<Idx, F>)
+      {
+        if constexpr (avnd::has_name<F>)
+          names[k] = avnd::get_name<F>();
+        k++;
+      });
+  return names;
+}
+
+/**
+ * Finds a field from its name in hosts which intern their symbols, e.g.
+ * the t_symbol* of Pd and Max: the symbols of the names are looked up
+ * once, when the class is set up, and go in a perfect hash of their address.
+ * Finding a field is then a hash of the address of the incoming symbol
+ * and a comparison, instead of comparing its name with each field in turn.
+ * In the unlikely case where no perfect hash is found for the addresses,
+ * the symbols are compared in turn.
+ */
+template <typename Introspection>
+struct symbol_table
+{
+  static constexpr auto names = field_names<Introspection>();
+
+  // intern: const char* -> symbol pointer.
+  // The names are string_views which may not be null-terminated:
+  // each is copied in a string before being interned.
+  static void init(auto intern)
+  {
+    std::string name;
+    for (std::size_t i = 0; i < names.size(); i++)
+    {
+      if (!names[i].empty())
+      {
+        name.assign(names[i]);
+        keys[i] = reinterpret_cast<std::uintptr_t>(intern(name.c_str()));
+      }
+    }
+    hashed = table.build(keys);
+  }
+
+  // Index of the field for the symbol (in the order of Introspection::for_all), or -1
+  static int find(const void* symbol) noexcept
+  {
+    if (!symbol)
+      return -1;
+
+    const auto key = reinterpret_cast<std::uintptr_t>(symbol);
+    if (hashed)
+      return table.find(key);
+
+    for (std::size_t i = 0; i < keys.size(); i++)
+      if (keys[i] == key)
+        return int(i);
+    return -1;
+  }
+
+private:
+  static inline std::array<std::uint64_t, names.size()> keys{};
+  static inline perfect_hash<names.size()> table;
+  static inline bool hashed{};
+};
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/concepts/parameter.hpp>
+
+namespace avnd
+{
+/**
+ * First frame in [from, to) at which a sample-accurate port has
+ * a timestamped value, or to.
+ */
+template <typename Field>
+static int next_timed_change(Field& port, int from, int to) noexcept
+{
+  if constexpr (linear_sample_accurate_parameter<Field>)
+  {
+    for (int i = from; i < to; i++)
+      if (port.values[i])
+        return i;
+    return to;
+  }
+  else if constexpr (span_sample_accurate_parameter<Field>)
+  {
+    // Do not assume that the values are sorted
+    int next = to;
+    for (const auto& v : port.values)
+      if (v.frame >= from && v.frame < next)
+        next = v.frame;
+    return next;
+  }
+  else if constexpr (requires { port.values.lower_bound(from); })
+  {
+    auto it = port.values.lower_bound(from);
+    if (it != port.values.end() && it->first < to)
+      return it->first;
+    return to;
+  }
+  else
+  {
+    int next = to;
+    for (const auto& [frame, v] : port.values)
+      if (frame >= from && frame < next)
+        next = frame;
+    return next;
+  }
+}
+
+/**
+ * Calls f with the last value timestamped in [from, to), if any.
+ */
+template <typename Field>
+static void last_timed_value(Field& port, int from, int to, auto&& f) noexcept
+{
+  if constexpr (linear_sample_accurate_parameter<Field>)
+  {
+    for (int i = to - 1; i >= from; i--)
+    {
+      if (port.values[i])
+      {
+        f(*port.values[i]);
+        return;
+      }
+    }
+  }
+  else if constexpr (span_sample_accurate_parameter<Field>)
+  {
+    int last = from;
+    const decltype(port.values.begin()->value)* value{};
+    for (const auto& v : port.values)
+    {
+      if (v.frame >= last && v.frame < to)
+      {
+        last = v.frame;
+        value = &v.value;
+      }
+    }
+    if (value)
+      f(*value);
+  }
+  else
+  {
+    int last = from;
+    const std::decay_t<decltype(port.values.begin()->second)>* value{};
+    for (const auto& [frame, v] : port.values)
+    {
+      if (frame >= last && frame < to)
+      {
+        last = frame;
+        value = &v;
+      }
+    }
+    if (value)
+      f(*value);
+  }
+}
+}
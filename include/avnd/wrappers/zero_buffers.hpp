@@ -0,0 +1,129 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/aligned_allocator.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace avnd
+{
+/**
+ * Read-only silence, given to the inputs for which the host
+ * did not supply any channel, when their samples are const:
+ * the inputs which the processor can write to get a writable_zeros buffer instead.
+ *
+ * The pointer array has an entry per possible channel, all pointing
+ * to the same buffer.
+ */
+template <typename FP>
+struct zero_buffers
+{
+  int frames{};
+  int channels{};
+
+  std::vector<FP, avnd::aligned_allocator<FP>> zeros;
+  std::vector<const FP*> zero_pointers;
+
+  zero_buffers(int frames, int channels)
+      : frames{frames}
+      , channels{channels}
+      , zeros(frames)
+      , zero_pointers(channels, zeros.data())
+  {
+  }
+};
+
+/**
+ * Process-wide pool of zero_buffers, shared by all the process adapters.
+ *
+ * acquire() returns the current buffers if they are large enough, otherwise
+ * allocates larger ones, sized to the largest block and channel count seen,
+ * which become the current buffers.
+ * Buffers are never resized in place: instances still holding an older,
+ * smaller generation keep using it safely until their next acquire(),
+ * and memory is released once the last instance lets go of it.
+ *
+ * acquire() locks and allocates: it must only be called from
+ * the non-realtime preparation functions.
+ */
+template <typename FP>
+struct shared_zero_buffers
+{
+  using buffers_ptr = std::shared_ptr<const zero_buffers<FP>>;
+
+  static buffers_ptr acquire(int frames, int channels)
+  {
+    static std::mutex mutex;
+    static std::weak_ptr<const zero_buffers<FP>> current;
+
+    std::lock_guard lock{mutex};
+    auto buffers = current.lock();
+    if (buffers && buffers->frames >= frames && buffers->channels >= channels)
+      return buffers;
+
+    if (buffers)
+    {
+      frames = std::max(frames, buffers->frames);
+      channels = std::max(channels, buffers->channels);
+    }
+    buffers = std::make_shared<const zero_buffers<FP>>(frames, channels);
+    current = buffers;
+    return buffers;
+  }
+};
+
+/**
+ * Scratch space given to the outputs for which the host
+ * did not supply any channel: it is written to and never read.
+ * It also backs the missing inputs whose samples are not const,
+ * cleared before each process call.
+ *
+ * Unlike the zeros, each adapter has its own, as instances
+ * running on different threads would write to it concurrently.
+ */
+template <typename FP>
+struct sink_buffers
+{
+  int frames{};
+  int channels{};
+
+  std::vector<FP, avnd::aligned_allocator<FP>> sink;
+  std::vector<FP*> sink_pointers;
+
+  sink_buffers(int frames, int channels)
+      : frames{frames}
+      , channels{channels}
+      , sink(frames)
+      , sink_pointers(channels, sink.data())
+  {
+  }
+
+  void clear() noexcept { std::fill(sink.begin(), sink.end(), FP{}); }
+};
+
+/**
+ * Makes sure that the sink can hold at least the given frames and channels.
+ *
+ * Hosts often prepare the processors again with the same settings:
+ * the sink is only allocated again when it has to grow.
+ * Allocates: must only be called from the non-realtime preparation functions.
+ */
+template <typename FP>
+void reserve_sink_buffers(
+    std::unique_ptr<sink_buffers<FP>>& buffers, int frames, int channels)
+{
+  if (buffers && buffers->frames >= frames && buffers->channels >= channels)
+    return;
+
+  if (buffers)
+  {
+    frames = std::max(frames, buffers->frames);
+    channels = std::max(channels, buffers->channels);
+  }
+  buffers = std::make_unique<sink_buffers<FP>>(frames, channels);
+}
+}
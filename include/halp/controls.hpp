@@ -525,6 +525,21 @@ using vbargraph_f32 = halp::vbargraph_t<float, lit, setup>;
 template <static_string lit, range setup = default_range<int>>
 using vbargraph_i32 = halp::vbargraph_t<int, lit, setup>;
 
+/// DSP load ///
+
+/**
+ * Output set by the bindings to the time spent processing the previous block,
+ * in percent of its duration
+ */
+template <static_string lit>
+struct dsp_load_bar : hbargraph_t<float, lit, range{.min = 0., .max = 100., .init = 0.}>
+{
+  enum
+  {
+    dsp_load
+  };
+};
+
 struct soundfile_view {
   const float** data{};
   int64_t frames{};
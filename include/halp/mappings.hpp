@@ -0,0 +1,98 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/constexpr_math.hpp>
+#include <halp/controls.hpp>
+
+namespace halp
+{
+/**
+ * Mappings from the [0; 1] range in which hosts automate the parameters
+ * to the range of a control, for controls where a linear mapping would give
+ * too little resolution to a part of the range, e.g. the low frequencies:
+ *
+ *   halp::log_hslider_f32<"Cutoff", halp::range{20., 20000., 1000.}> cutoff;
+ *   halp::mapped<halp::knob_f32<"Drive", halp::range{0., 10., 1.}>, halp::skew_mapping<2.>> drive;
+ *
+ * map must be increasing, with map(min, max, 0) == min and map(min, max, 1) == max.
+ * The bindings sample it in a table, which is also used for the inverse conversion:
+ * when map is constexpr, the table of a control is computed at compile time
+ * (see avnd::mapping_table).
+ */
+
+// Same ratio for the same distance, e.g. for frequencies. min must be > 0.
+struct log_mapping
+{
+  static constexpr bool valid_range(double min, double max) noexcept
+  {
+    return min > 0.;
+  }
+
+  static constexpr double map(double min, double max, double v) noexcept
+  {
+    return min * avnd::constexpr_math::pow(max / min, v);
+  }
+};
+
+// Exponential curve: the higher Curve, the more resolution at the start of the range
+template <double Curve = 4.>
+struct exp_mapping
+{
+  static_assert(Curve > 0.);
+  static constexpr double map(double min, double max, double v) noexcept
+  {
+    namespace math = avnd::constexpr_math;
+    return min + (max - min) * (math::exp(Curve * v) - 1.) / (math::exp(Curve) - 1.);
+  }
+};
+
+// Power curve: Power > 1 gives more resolution at the start of the range,
+// Power < 1 at the end.
+template <double Power>
+struct skew_mapping
+{
+  static_assert(Power > 0.);
+  static constexpr double map(double min, double max, double v) noexcept
+  {
+    return min + (max - min) * avnd::constexpr_math::pow(v, Power);
+  }
+};
+
+// Gains in linear amplitude, mapped linearly in decibels, e.g. for a fader.
+// When min is 0, the range goes down to FloorDb, then to silence at 0.
+template <double FloorDb = -60.>
+struct db_mapping
+{
+  static constexpr bool valid_range(double min, double max) noexcept
+  {
+    return min >= 0. && max > 0.;
+  }
+
+  static constexpr double map(double min, double max, double v) noexcept
+  {
+    namespace math = avnd::constexpr_math;
+    if (v <= 0.)
+      return min;
+    const double lo = min > 0. ? 20. * math::log10(min) : FloorDb;
+    const double hi = 20. * math::log10(max);
+    return math::pow10((lo + v * (hi - lo)) / 20.);
+  }
+};
+
+/**
+ * Adds a mapping to a control
+ */
+template <typename T, typename Mapping>
+struct mapped : T
+{
+  using normalize = Mapping;
+};
+
+template <static_string lit, range setup>
+using log_hslider_f32 = mapped<hslider_f32<lit, setup>, log_mapping>;
+template <static_string lit, range setup>
+using log_vslider_f32 = mapped<vslider_f32<lit, setup>, log_mapping>;
+template <static_string lit, range setup>
+using log_knob_f32 = mapped<knob_f32<lit, setup>, log_mapping>;
+}
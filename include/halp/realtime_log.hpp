@@ -0,0 +1,158 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/log_queue.hpp>
+#include <halp/log.hpp>
+
+#include <memory>
+
+namespace halp
+{
+#if defined(FMT_PRINTF_H_)
+/**
+ * A logger which can be used from the audio thread: the messages are formatted
+ * into a queue of the instance, without locks nor allocations, and written
+ * to Sink by a background thread (see avnd::log_queue and avnd::log_consumer).
+ *
+ * Sink is a logger with static functions, e.g. halp::basic_logger:
+ * it must be usable from another thread than the one which created the instance.
+ *
+ *   struct config {
+ *     using logger_type = halp::realtime_logger<halp::basic_logger>;
+ *   };
+ *
+ * Each copy of a logger has its own queue.
+ */
+template <typename Sink>
+struct realtime_logger
+{
+  using logger_type = realtime_logger;
+
+  realtime_logger() : m_queue{std::make_shared<avnd::log_queue>(&write)}
+  {
+    avnd::log_consumer::instance().add(m_queue);
+  }
+  realtime_logger(const realtime_logger&) : realtime_logger{} { }
+  realtime_logger(realtime_logger&&) noexcept = default;
+  realtime_logger& operator=(const realtime_logger&) noexcept { return *this; }
+  realtime_logger& operator=(realtime_logger&& other) noexcept
+  {
+    if (this != &other)
+    {
+      release();
+      m_queue = std::move(other.m_queue);
+    }
+    return *this;
+  }
+  ~realtime_logger() { release(); }
+
+  template <typename... T>
+  void log(fmt::format_string<T...> fmt, T&&... args) noexcept
+  {
+    push(avnd::log_level::info, fmt, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  void trace(fmt::format_string<T...> fmt, T&&... args) noexcept
+  {
+    push(avnd::log_level::trace, fmt, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  void debug(fmt::format_string<T...> fmt, T&&... args) noexcept
+  {
+    push(avnd::log_level::debug, fmt, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  void info(fmt::format_string<T...> fmt, T&&... args) noexcept
+  {
+    push(avnd::log_level::info, fmt, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  void warn(fmt::format_string<T...> fmt, T&&... args) noexcept
+  {
+    push(avnd::log_level::warn, fmt, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  void error(fmt::format_string<T...> fmt, T&&... args) noexcept
+  {
+    push(avnd::log_level::error, fmt, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  void critical(fmt::format_string<T...> fmt, T&&... args) noexcept
+  {
+    push(avnd::log_level::critical, fmt, std::forward<T>(args)...);
+  }
+
+  // Messages dropped so far, because the queue was full or because of the rate limit
+  avnd::log_queue::dropped_count dropped() const noexcept
+  {
+    return m_queue ? m_queue->dropped() : avnd::log_queue::dropped_count{};
+  }
+
+private:
+  // The pending messages are still written
+  void release() noexcept
+  {
+    if (m_queue)
+      avnd::log_consumer::instance().remove(*m_queue);
+    m_queue.reset();
+  }
+
+  template <typename... T>
+  void push(avnd::log_level level, fmt::format_string<T...> fmt, T&&... args) noexcept
+  {
+    if (!m_queue)
+      return;
+    if (auto* m = m_queue->claim(level))
+    {
+      const auto res = fmt::format_to_n(
+          m->text, sizeof(m->text), fmt, std::forward<T>(args)...);
+      m->size = std::min(res.size, sizeof(m->text));
+      m_queue->commit();
+    }
+  }
+
+  static void write(avnd::log_level level, std::string_view msg)
+  {
+    switch (level)
+    {
+      case avnd::log_level::trace:
+        Sink::trace("{}", msg);
+        break;
+      case avnd::log_level::debug:
+        Sink::debug("{}", msg);
+        break;
+      case avnd::log_level::info:
+        Sink::info("{}", msg);
+        break;
+      case avnd::log_level::warn:
+        Sink::warn("{}", msg);
+        break;
+      case avnd::log_level::error:
+        Sink::error("{}", msg);
+        break;
+      case avnd::log_level::critical:
+        Sink::critical("{}", msg);
+        break;
+    }
+  }
+
+  std::shared_ptr<avnd::log_queue> m_queue;
+};
+
+static_assert(avnd::logger<halp::realtime_logger<halp::basic_logger>>);
+#endif
+
+/**
+ * The logger of the configurations of the bindings: Sink, or a realtime_logger
+ * writing to it when building with AVND_REALTIME_LOGGER defined
+ * (see the AVENDISH_REALTIME_LOGGER CMake option).
+ */
+#if defined(FMT_PRINTF_H_) && defined(AVND_REALTIME_LOGGER)
+template <typename Sink>
+using realtime_logger_for = realtime_logger<Sink>;
+#else
+template <typename Sink>
+using realtime_logger_for = Sink;
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/smoother.hpp>
+#include <halp/controls.hpp>
+
+#include <span>
+#include <type_traits>
+
+namespace halp
+{
+using smoothing_mode = avnd::smoothing_mode;
+
+/**
+ * A control which does not jump when it changes:
+ *
+ *   halp::smooth<halp::hslider_f32<"Gain">, 20.> gain;
+ *
+ * Before each process call, the bindings fill "ramp" with the values of each
+ * frame of the block, going towards "value" in the given time.
+ * For sample-accurate controls, e.g. halp::smooth<halp::accurate<...>>,
+ * the ramp is retargeted at the frame of each change.
+ */
+template <typename T, double Milliseconds, smoothing_mode Mode = smoothing_mode::linear>
+struct smooth : T
+{
+  static constexpr avnd::smoothing smoothing{.milliseconds = Milliseconds, .mode = Mode};
+
+  std::span<const std::decay_t<decltype(T::value)>> ramp;
+};
+}
@@ -0,0 +1,299 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+// Interceptors of the realtime-safety checks, see avnd/common/realtime_check.hpp.
+// This file must be linked only once per binary, which the AVENDISH_RT_CHECK
+// CMake option does for the targets it applies to.
+#if defined(AVND_RT_CHECK)
+#include <avnd/common/realtime_check.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define AVND_RT_CHECK_BACKTRACE 1
+#endif
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+// With glibc the C allocator can be replaced, and the actual one is still reachable
+#if defined(__GLIBC__)
+#define AVND_RT_CHECK_MALLOC 1
+extern "C" {
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void* __libc_memalign(std::size_t, std::size_t);
+void __libc_free(void*);
+}
+#endif
+
+#if __has_include(<dlfcn.h>) && __has_include(<pthread.h>)
+#include <dlfcn.h>
+#include <pthread.h>
+#define AVND_RT_CHECK_MUTEX 1
+#endif
+
+namespace avnd::rt_check
+{
+namespace
+{
+void print(const char* str) noexcept
+{
+#if __has_include(<unistd.h>)
+  [[maybe_unused]] auto res = ::write(2, str, std::strlen(str));
+#else
+  std::fputs(str, stderr);
+#endif
+}
+
+void* allocate(std::size_t size) noexcept
+{
+#if defined(AVND_RT_CHECK_MALLOC)
+  return __libc_malloc(size);
+#else
+  return std::malloc(size);
+#endif
+}
+
+void* allocate_aligned(std::size_t size, std::size_t alignment) noexcept
+{
+#if defined(AVND_RT_CHECK_MALLOC)
+  return __libc_memalign(alignment, size);
+#elif defined(_MSC_VER)
+  return _aligned_malloc(size, alignment);
+#else
+  return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+void deallocate(void* ptr) noexcept
+{
+#if defined(AVND_RT_CHECK_MALLOC)
+  __libc_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void deallocate_aligned(void* ptr) noexcept
+{
+#if defined(_MSC_VER) && !defined(AVND_RT_CHECK_MALLOC)
+  _aligned_free(ptr);
+#else
+  deallocate(ptr);
+#endif
+}
+
+void check(const char* what) noexcept
+{
+  if (checking())
+    violation(what);
+}
+
+[[noreturn]] void out_of_memory()
+{
+#if defined(__cpp_exceptions)
+  throw std::bad_alloc{};
+#else
+  std::abort();
+#endif
+}
+}
+
+void violation(const char* what) noexcept
+{
+  violations++;
+  const action act = on_violation.load();
+  if (act == action::count)
+    return;
+
+  // Printing can allocate, e.g. the first call to backtrace()
+  unchecked_scope _;
+  print("avnd: realtime violation: ");
+  print(what);
+  print(" in ");
+  print(current_scope);
+  print("\n");
+#if defined(AVND_RT_CHECK_BACKTRACE)
+  void* frames[64];
+  const int n = ::backtrace(frames, 64);
+  ::backtrace_symbols_fd(frames, n, 2);
+#endif
+
+  if (act == action::abort)
+    std::abort();
+}
+}
+
+namespace rt = avnd::rt_check;
+
+// The interceptors must replace the functions for the shared libraries too,
+// even with hidden visibility by default
+#if defined(__GNUC__)
+#pragma GCC visibility push(default)
+#endif
+
+#if defined(AVND_RT_CHECK_MALLOC)
+extern "C" {
+void* malloc(std::size_t size)
+{
+  rt::check("malloc");
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t n, std::size_t size)
+{
+  rt::check("calloc");
+  return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, std::size_t size)
+{
+  rt::check("realloc");
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size)
+{
+  rt::check("memalign");
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+  rt::check("aligned_alloc");
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size)
+{
+  rt::check("posix_memalign");
+  *ptr = __libc_memalign(alignment, size);
+  return *ptr ? 0 : ENOMEM;
+}
+
+void free(void* ptr)
+{
+  if (ptr)
+    rt::check("free");
+  __libc_free(ptr);
+}
+}
+#endif
+
+#if defined(AVND_RT_CHECK_MUTEX)
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+  using lock_fun = int (*)(pthread_mutex_t*);
+  static const lock_fun next_lock = [] {
+    rt::unchecked_scope _;
+    return reinterpret_cast<lock_fun>(::dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+  }();
+
+  rt::check("pthread_mutex_lock");
+  return next_lock(mutex);
+}
+#endif
+
+// operator new / delete are replaceable everywhere
+void* operator new(std::size_t size)
+{
+  rt::check("operator new");
+  if (void* ptr = rt::allocate(size ? size : 1))
+    return ptr;
+  rt::out_of_memory();
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  rt::check("operator new");
+  return rt::allocate(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+  return ::operator new(size, tag);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  rt::check("operator new");
+  if (void* ptr = rt::allocate_aligned(size ? size : 1, std::size_t(alignment)))
+    return ptr;
+  rt::out_of_memory();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return ::operator new(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  if (ptr)
+    rt::check("operator delete");
+  rt::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  if (ptr)
+    rt::check("operator delete");
+  rt::deallocate_aligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+  ::operator delete(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+  ::operator delete(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+  ::operator delete(ptr, alignment);
+}
+
+#if defined(__GNUC__)
+#pragma GCC visibility pop
+#endif
+#endif
@@ -0,0 +1,145 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "processor_benchmark.hpp"
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+
+#include <vector>
+
+/**
+ * Compares the calling conventions a processor can use: the same one-pole
+ * lowpass is written per-sample with arguments, per-sample with ports,
+ * per-channel and per-bus, and each is run through the example host.
+ * The relative costs are those of the adapters around the DSP.
+ */
+namespace
+{
+using weight_control
+    = halp::hslider_f32<"Weight", halp::range{.min = 0., .max = 1., .init = 0.5}>;
+
+struct PerSampleArgs
+{
+  halp_meta(name, "Per-sample, args")
+  halp_meta(c_name, "bench_per_sample_args")
+  halp_meta(uuid, "1f6e0c8a-3b52-4d7e-9a41-6c2d8e5b7f10")
+
+  struct inputs
+  {
+    weight_control weight;
+  };
+  struct outputs
+  {
+  };
+
+  float operator()(float in, const inputs& ins)
+  {
+    return previous = ins.weight * in + (1.f - ins.weight) * previous;
+  }
+
+  float previous{};
+};
+
+struct PerSamplePorts
+{
+  halp_meta(name, "Per-sample, ports")
+  halp_meta(c_name, "bench_per_sample_ports")
+  halp_meta(uuid, "6b0e2f4c-8d17-4a39-b5e2-0f9c3a7d1e54")
+
+  struct inputs
+  {
+    halp::audio_sample<"In", float> audio;
+    weight_control weight;
+  };
+  struct outputs
+  {
+    halp::audio_sample<"Out", float> audio;
+  };
+
+  void operator()(const inputs& ins, outputs& outs)
+  {
+    outs.audio = previous = ins.weight * ins.audio + (1.f - ins.weight) * previous;
+  }
+
+  float previous{};
+};
+
+struct PerChannel
+{
+  halp_meta(name, "Per-channel")
+  halp_meta(c_name, "bench_per_channel")
+  halp_meta(uuid, "c3a85e1d-27f4-4b60-8e9c-5d1f0b6a2e87")
+
+  struct inputs
+  {
+    weight_control weight;
+  };
+  struct outputs
+  {
+  };
+
+  // The per-channel adapter does not convert between float and double
+  template <typename FP>
+  void operator()(FP* in, FP* out, const inputs& ins, int frames)
+  {
+    const float w = ins.weight;
+    for (int i = 0; i < frames; i++)
+      out[i] = previous = w * float(in[i]) + (1.f - w) * previous;
+  }
+
+  float previous{};
+};
+
+struct PerBus
+{
+  halp_meta(name, "Per-bus")
+  halp_meta(c_name, "bench_per_bus")
+  halp_meta(uuid, "8e47b2d0-91c6-4f35-a0d8-3b6e5c9f1a24")
+
+  struct
+  {
+    halp::dynamic_audio_bus<"In", float> audio;
+    weight_control weight;
+  } inputs;
+
+  struct
+  {
+    halp::dynamic_audio_bus<"Out", float> audio;
+  } outputs;
+
+  void prepare(halp::setup info) { previous.assign(info.input_channels, 0.f); }
+
+  void operator()(int frames)
+  {
+    const float w = inputs.weight;
+    const int channels = std::min(inputs.audio.channels, outputs.audio.channels);
+    for (int c = 0; c < channels; c++)
+    {
+      const float* in = inputs.audio[c];
+      float* out = outputs.audio[c];
+      float& prev = previous[c];
+      for (int i = 0; i < frames; i++)
+        out[i] = prev = w * in[i] + (1.f - w) * prev;
+    }
+  }
+
+  std::vector<float> previous;
+};
+
+template <typename T>
+using configured = typename decltype(avnd::configure<exhs::config, T>())::type;
+}
+
+int main(int argc, char** argv)
+{
+  avnd_bench::context ctx;
+  if (!avnd_bench::parse_arguments(argc, argv, ctx))
+    return 1;
+
+  avnd_bench::print_header(ctx);
+  avnd_bench::run<configured<PerSampleArgs>>(ctx, "one_pole", "per_sample_args");
+  avnd_bench::run<configured<PerSamplePorts>>(ctx, "one_pole", "per_sample_ports");
+  avnd_bench::run<configured<PerChannel>>(ctx, "one_pole", "per_channel");
+  avnd_bench::run<configured<PerBus>>(ctx, "one_pole", "per_bus");
+}
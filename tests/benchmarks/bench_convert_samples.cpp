@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/aligned_allocator.hpp>
+#include <avnd/common/convert_samples.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Measures the cost of the float <-> double conversions done by the
+ * process adapters, per channel and per block, for each available kernel.
+ */
+namespace
+{
+template <typename T>
+using aligned_vector = std::vector<T, avnd::aligned_allocator<T>>;
+
+template <typename In, typename Out, typename F>
+double bench(F&& kernel, int block_size)
+{
+  aligned_vector<In> in(block_size);
+  aligned_vector<Out> out(block_size);
+  for (int i = 0; i < block_size; i++)
+    in[i] = In(i % 128) / In(128.);
+
+  // Aim for roughly the same amount of samples whatever the block size
+  const int iterations = 1 + (1 << 24) / block_size;
+  volatile Out sink{};
+  auto t0 = std::chrono::steady_clock::now();
+  for (int k = 0; k < iterations; k++)
+  {
+    kernel(in.data(), out.data(), block_size);
+    // Keep the optimizer from removing the loop
+    sink = out[k % block_size];
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+template <typename In, typename Out>
+void bench_direction(const char* direction)
+{
+  namespace k = avnd::convert_kernels;
+  std::printf("\n%s (ns / channel / block)\n", direction);
+  std::printf("%8s %10s", "frames", "scalar");
+#if AVND_CONVERT_SAMPLES_SSE2
+  std::printf(" %10s", "sse2");
+#endif
+#if AVND_CONVERT_SAMPLES_AVX
+  std::printf(" %10s", "avx");
+#endif
+#if AVND_CONVERT_SAMPLES_NEON
+  std::printf(" %10s", "neon");
+#endif
+  std::printf(" %10s\n", "dispatch");
+
+  for (int frames : {16, 32, 64, 128, 256, 512, 1024, 2048, 4096})
+  {
+    std::printf("%8d", frames);
+    std::printf(" %10.1f", bench<In, Out>(
+        [](const In* i, Out* o, int n) { k::scalar(i, o, n); }, frames));
+#if AVND_CONVERT_SAMPLES_SSE2
+    std::printf(" %10.1f", bench<In, Out>(
+        [](const In* i, Out* o, int n) { k::sse2(i, o, n); }, frames));
+#endif
+#if AVND_CONVERT_SAMPLES_AVX
+#if AVND_CONVERT_SAMPLES_AVX_DISPATCH
+    if (k::cpu_has_avx())
+#endif
+      std::printf(" %10.1f", bench<In, Out>(
+          [](const In* i, Out* o, int n) { k::avx(i, o, n); }, frames));
+#if AVND_CONVERT_SAMPLES_AVX_DISPATCH
+    else
+      std::printf(" %10s", "n/a");
+#endif
+#endif
+#if AVND_CONVERT_SAMPLES_NEON
+    std::printf(" %10.1f", bench<In, Out>(
+        [](const In* i, Out* o, int n) { k::neon(i, o, n); }, frames));
+#endif
+    std::printf(" %10.1f\n", bench<In, Out>(
+        [](const In* i, Out* o, int n) { avnd::convert_samples(i, o, n); }, frames));
+  }
+}
+}
+
+int main()
+{
+  bench_direction<float, double>("float -> double");
+  bench_direction<double, float>("double -> float");
+}
@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/denormals.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Measures the slowdown of a bank of one-pole IIR filters while their tail
+ * decays through the denormal range, with and without the FTZ / DAZ guard
+ * the bindings put around the processing.
+ */
+namespace
+{
+struct one_pole_bank
+{
+  static constexpr int filters = 16;
+  float state[filters];
+
+  void reset(float value)
+  {
+    for (float& s : state)
+      s = value;
+  }
+
+  void process(const float* in, float* out, int n)
+  {
+    for (int i = 0; i < n; i++)
+    {
+      float sum = 0.f;
+      for (int f = 0; f < filters; f++)
+      {
+        state[f] = in[i] + 0.9999f * state[f];
+        sum += state[f];
+      }
+      out[i] = sum;
+    }
+  }
+};
+
+// Silent input, with the filter state set to the given value at each block
+template <typename Guard>
+double bench(float initial_state, int block_size)
+{
+  std::vector<float> in(block_size), out(block_size);
+  one_pole_bank bank;
+
+  const int iterations = 1 + (1 << 20) / block_size;
+  volatile float sink{};
+  auto t0 = std::chrono::steady_clock::now();
+  for (int k = 0; k < iterations; k++)
+  {
+    [[maybe_unused]] Guard guard;
+    bank.reset(initial_state);
+    bank.process(in.data(), out.data(), block_size);
+    sink = out[k % block_size];
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(t1 - t0).count()
+         / (double(iterations) * block_size);
+}
+}
+
+int main()
+{
+  using keep = avnd::scoped_keep_denormals;
+  using flush = avnd::scoped_flush_denormals;
+
+  std::printf("ns / frame (%d one-pole filters)\n", one_pole_bank::filters);
+  std::printf("%8s %14s %14s %14s\n", "frames", "normal tail", "denormal tail", "denormal+ftz");
+  for (int frames : {64, 256, 1024})
+  {
+    std::printf(
+        "%8d %14.2f %14.2f %14.2f\n", frames, bench<keep>(1.f, frames),
+        bench<keep>(1e-39f, frames), bench<flush>(1e-39f, frames));
+  }
+}
@@ -0,0 +1,117 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/common/for_nth.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/**
+ * Measures the cost of routing a host parameter change, given by its runtime
+ * index, to the compile-time index of the control, as the bindings do for each
+ * parameter event: a fold comparing the index to each control in turn, as
+ * before, against avnd::for_nth and its table of functions.
+ *
+ * The controls are an array with a different range for each index instead of
+ * the members of a processor: pfr does not go up to 1000 fields.
+ */
+namespace
+{
+template <std::size_t N>
+struct parameters
+{
+  std::array<float, N> values{};
+
+  // What the bindings do once they have the control
+  template <std::size_t I>
+  void set(float v) noexcept
+  {
+    constexpr float max = 1.f + I % 17;
+    values[I] = v < 0.f ? 0.f : v > max ? max : v;
+  }
+};
+
+template <std::size_t N>
+void fold_for_nth(int k, auto&& f)
+{
+  [k]<std::size_t... Index>(std::index_sequence<Index...>, auto&& f)
+  {
+    ((void)(Index == k && (f.template operator()<Index>(), true)), ...);
+  }
+  (std::make_index_sequence<N>(), f);
+}
+
+struct event
+{
+  int index;
+  float value;
+};
+
+struct use_fold
+{
+  template <std::size_t N>
+  static void dispatch(int k, auto&& f)
+  {
+    fold_for_nth<N>(k, f);
+  }
+};
+
+struct use_table
+{
+  template <std::size_t N>
+  static void dispatch(int k, auto&& f)
+  {
+    avnd::for_nth<N>(k, f);
+  }
+};
+
+template <std::size_t N, typename Dispatch>
+double bench(const std::vector<event>& events)
+{
+  static parameters<N> params;
+
+  const int iterations = 16;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int k = 0; k < iterations; k++)
+  {
+    for (const event& e : events)
+    {
+      Dispatch::template dispatch<N>(
+          e.index, [&]<std::size_t I>() { params.template set<I>(e.value); });
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  volatile float sink = params.values[events.front().index];
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(t1 - t0).count()
+         / (double(iterations) * events.size());
+}
+
+template <std::size_t N>
+void run()
+{
+  // Automation on random parameters
+  std::mt19937 rng{1234};
+  std::uniform_int_distribution<int> index(0, N - 1);
+  std::uniform_real_distribution<float> value(-1.f, 20.f);
+  std::vector<event> events(1 << 16);
+  for (event& e : events)
+    e = {index(rng), value(rng)};
+
+  std::printf(
+      "%10zu %14.2f %14.2f\n", N, bench<N, use_fold>(events), bench<N, use_table>(events));
+}
+}
+
+int main()
+{
+  std::printf("ns / parameter change\n");
+  std::printf("%10s %14s %14s\n", "parameters", "fold", "table");
+  run<4>();
+  run<10>();
+  run<100>();
+  run<1000>();
+}
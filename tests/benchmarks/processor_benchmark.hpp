@@ -0,0 +1,218 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/binding/example/example_processor.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AVND_BENCH_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define AVND_BENCH_HAS_TSC 1
+#endif
+
+/**
+ * Runs processors through the example host, that is through the actual
+ * process_adapter and effect_container code the bindings use, for a range
+ * of block sizes, channel counts and sample precisions.
+ *
+ * Results are printed as CSV, one line per configuration, on stdout or in the
+ * file given with --output (some processors print on stdout themselves):
+ *
+ *   processor,variant,precision,inputs,outputs,frames,ns_per_sample,cycles_per_sample
+ *
+ * where a sample is one frame of one channel. Cycles are read from the
+ * time-stamp counter, and are "nan" on platforms without one.
+ */
+namespace avnd_bench
+{
+struct context
+{
+  std::vector<int> block_sizes{32, 64, 128, 256, 512, 1024};
+  std::vector<int> channel_counts{1, 2, 8};
+
+  // Minimum measurement time for each configuration
+  double seconds{0.02};
+
+  // Only the processors whose name contain this are run
+  std::string_view filter;
+
+  std::FILE* output{stdout};
+};
+
+inline void print_header(const context& ctx)
+{
+  std::fprintf(
+      ctx.output,
+      "processor,variant,precision,inputs,outputs,frames,ns_per_sample,cycles_per_sample\n");
+}
+
+inline uint64_t timestamp_counter() noexcept
+{
+#if defined(AVND_BENCH_HAS_TSC)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// Common command-line options of the benchmark executables
+inline bool parse_arguments(int argc, char** argv, context& ctx)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string_view arg = argv[i];
+    if (arg == "--quick")
+    {
+      ctx.block_sizes = {64, 512};
+      ctx.channel_counts = {2};
+      ctx.seconds = 0.005;
+    }
+    else if (arg == "--time" && i + 1 < argc)
+    {
+      ctx.seconds = std::atof(argv[++i]) / 1000.;
+    }
+    else if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+    {
+      ctx.output = std::fopen(argv[++i], "w");
+      if (!ctx.output)
+      {
+        std::fprintf(stderr, "cannot create %s\n", argv[i]);
+        return false;
+      }
+    }
+    else if (arg.starts_with("-"))
+    {
+      std::fprintf(
+          stderr,
+          "usage: %s [--quick] [--time <ms per configuration>] [--output <csv file>]\n"
+          "          [processor name filter]\n",
+          argv[0]);
+      return false;
+    }
+    else
+    {
+      ctx.filter = arg;
+    }
+  }
+  return true;
+}
+
+template <typename T, std::floating_point FP>
+class processor_run
+{
+public:
+  processor_run(int channels, int frames)
+      : m_frames{frames}
+  {
+    m_processor->set_channels(channels, channels);
+    m_processor->start(frames, 48000.);
+
+    const int inputs = m_processor->input_channels();
+    const int outputs = m_processor->output_channels();
+    m_in.resize(std::max(inputs, 1) * frames);
+    m_out.resize(std::max(outputs, 1) * frames);
+    for (int c = 0; c < inputs; c++)
+      m_in_ptrs.push_back(m_in.data() + c * frames);
+    for (int c = 0; c < outputs; c++)
+      m_out_ptrs.push_back(m_out.data() + c * frames);
+
+    // Some noise: silence could take shortcuts
+    uint32_t seed = 1;
+    for (auto& s : m_in)
+    {
+      seed = seed * 1664525u + 1013904223u;
+      s = FP(int32_t(seed) / 4294967296.);
+    }
+  }
+
+  int inputs() const noexcept { return m_in_ptrs.size(); }
+  int outputs() const noexcept { return m_out_ptrs.size(); }
+
+  void operator()()
+  {
+    m_processor->process(
+        m_in_ptrs.data(), inputs(), m_out_ptrs.data(), outputs(), m_frames);
+  }
+
+private:
+  // The processors can be large
+  std::unique_ptr<exhs::example_processor<T>> m_processor
+      = std::make_unique<exhs::example_processor<T>>(false);
+  int m_frames{};
+  std::vector<FP> m_in, m_out;
+  std::vector<FP*> m_in_ptrs, m_out_ptrs;
+};
+
+template <typename T, std::floating_point FP>
+void run_precision(
+    const context& ctx, std::string_view name, std::string_view variant,
+    const char* precision)
+{
+  // Processors with fixed channels give the same configuration for all the counts
+  std::vector<std::tuple<int, int, int>> done;
+
+  for (int channels : ctx.channel_counts)
+  {
+    for (int frames : ctx.block_sizes)
+    {
+      processor_run<T, FP> run{channels, frames};
+      const std::tuple config{run.inputs(), run.outputs(), frames};
+      if (std::find(done.begin(), done.end(), config) != done.end())
+        continue;
+      done.push_back(config);
+
+      // Warm-up
+      for (int k = 0; k < 4; k++)
+        run();
+
+      using clock = std::chrono::steady_clock;
+      int64_t iterations = 0;
+      const auto t0 = clock::now();
+      const uint64_t c0 = timestamp_counter();
+      auto t1 = t0;
+      do
+      {
+        for (int k = 0; k < 8; k++)
+          run();
+        iterations += 8;
+        t1 = clock::now();
+      } while (std::chrono::duration<double>(t1 - t0).count() < ctx.seconds);
+      const uint64_t c1 = timestamp_counter();
+
+      const double samples
+          = double(iterations) * frames * std::max({run.inputs(), run.outputs(), 1});
+      const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+      const double cycles = c1 > c0 ? double(c1 - c0) : std::nan("");
+
+      std::fprintf(
+          ctx.output, "%.*s,%.*s,%s,%d,%d,%d,%.4f,%.4f\n", int(name.size()), name.data(),
+          int(variant.size()), variant.data(), precision, run.inputs(), run.outputs(),
+          frames, ns / samples, cycles / samples);
+      std::fflush(ctx.output);
+    }
+  }
+}
+
+template <typename T>
+void run(const context& ctx, std::string_view name, std::string_view variant = "")
+{
+  if (!ctx.filter.empty() && name.find(ctx.filter) == std::string_view::npos)
+    return;
+
+  run_precision<T, float>(ctx, name, variant, "float");
+  run_precision<T, double>(ctx, name, variant, "double");
+}
+}
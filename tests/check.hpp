@@ -0,0 +1,29 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <cstdio>
+
+/**
+ * Minimal checks for the runtime tests: a failed check is reported
+ * and counted, and the test goes on. main() returns avnd_test::result().
+ */
+namespace avnd_test
+{
+inline int failures = 0;
+
+inline int result() noexcept
+{
+  return failures == 0 ? 0 : 1;
+}
+}
+
+#define CHECK(cond)                                                           \
+  do                                                                          \
+  {                                                                           \
+    if (!(cond))                                                              \
+    {                                                                         \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      avnd_test::failures++;                                                \
+    }                                                                         \
+  } while (0)
@@ -0,0 +1,244 @@
+#pragma once
+
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include <avnd/binding/example/example_processor.hpp>
+#include <avnd/binding/vintage/audio_effect.hpp>
+#include <avnd/binding/vintage/configure.hpp>
+#include <avnd/common/realtime_check.hpp>
+
+#if __has_include(<clap/all.h>)
+#include <avnd/binding/clap/audio_effect.hpp>
+#include <avnd/binding/clap/configure.hpp>
+#define AVND_RT_CHECK_CLAP 1
+#endif
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+/**
+ * Drives a processor through the process entry points of the bindings like
+ * a host would: everything which is not realtime (creation, setup...) happens
+ * outside of the realtime scopes, then a few blocks are processed, with MIDI
+ * events for the bindings which take them.
+ *
+ * Each function returns the number of realtime violations.
+ */
+namespace avnd_rt_test
+{
+static constexpr int block_size = 256;
+static constexpr int blocks = 8;
+
+template <typename FP>
+struct buffers
+{
+  buffers(int inputs, int outputs)
+      : in(std::max(inputs, 1) * block_size)
+      , out(std::max(outputs, 1) * block_size)
+  {
+    for (int c = 0; c < inputs; c++)
+      in_ptrs.push_back(in.data() + c * block_size);
+    for (int c = 0; c < outputs; c++)
+      out_ptrs.push_back(out.data() + c * block_size);
+    for (int i = 0; i < int(in.size()); i++)
+      in[i] = FP(i % 100) / FP(100.);
+  }
+
+  std::vector<FP> in, out;
+  std::vector<FP*> in_ptrs, out_ptrs;
+};
+
+inline int report(const char* processor, const char* binding, int before)
+{
+  const int count = avnd::rt_check::violations - before;
+  if (count > 0)
+    std::fprintf(stderr, "%s: %d realtime violations with %s\n", processor, count, binding);
+  return count;
+}
+
+template <typename T>
+int drive_example(const char* name)
+{
+  using type = typename decltype(avnd::configure<exhs::config, T>())::type;
+  const int before = avnd::rt_check::violations;
+
+  auto processor = std::make_unique<exhs::example_processor<type>>(false);
+  processor->start(block_size, 48000.);
+  const int inputs = processor->input_channels();
+  const int outputs = processor->output_channels();
+
+  auto run = [&]<typename FP>(buffers<FP>& b) {
+    for (int k = 0; k < blocks; k++)
+      processor->process(
+          b.in_ptrs.data(), inputs, b.out_ptrs.data(), outputs, block_size);
+  };
+  buffers<float> f{inputs, outputs};
+  buffers<double> d{inputs, outputs};
+  run(f);
+  run(d);
+  processor->stop();
+
+  return report(name, "the example host", before);
+}
+
+// Processors templated on their configuration, e.g. for the logger
+template <template <typename...> class T>
+int drive_example(const char* name)
+{
+  return drive_example<typename decltype(avnd::configure<exhs::config, T>())::type>(name);
+}
+
+template <typename T>
+int drive_vintage(const char* name)
+{
+  using type = typename decltype(avnd::configure<vintage::config, T>())::type;
+  using namespace vintage;
+  const int before = avnd::rt_check::violations;
+
+  static constexpr HostCallback host
+      = [](Effect*, int32_t opcode, int32_t, intptr_t, void*, float) -> intptr_t {
+    switch (HostOpcodes(opcode))
+    {
+      case HostOpcodes::GetSampleRate:
+        return 48000;
+      case HostOpcodes::GetBlockSize:
+        return block_size;
+      default:
+        return 0;
+    }
+  };
+
+  Effect* effect = new SimpleAudioEffect<type>{host};
+  auto dispatch = [effect](EffectOpcodes op, intptr_t value = 0, void* ptr = nullptr) {
+    return effect->dispatcher(effect, int32_t(op), 0, value, ptr, 0.f);
+  };
+  dispatch(EffectOpcodes::Open);
+  dispatch(EffectOpcodes::MainsChanged, 1);
+
+  MidiEvent note_on, note_off;
+  note_on.midiData[0] = char(0x90);
+  note_on.midiData[1] = 60;
+  note_on.midiData[2] = 100;
+  note_off.deltaFrames = block_size / 2;
+  note_off.midiData[0] = char(0x80);
+  note_off.midiData[1] = 60;
+  Events events;
+  events.numEvents = 2;
+  events.events[0] = reinterpret_cast<Event*>(&note_on);
+  events.events[1] = reinterpret_cast<Event*>(&note_off);
+
+  buffers<float> f{effect->numInputs, effect->numOutputs};
+  buffers<double> d{effect->numInputs, effect->numOutputs};
+  for (int k = 0; k < blocks; k++)
+  {
+    dispatch(EffectOpcodes::ProcessEvents, 0, &events);
+    effect->processReplacing(effect, f.in_ptrs.data(), f.out_ptrs.data(), block_size);
+    if (effect->processDoubleReplacing)
+    {
+      dispatch(EffectOpcodes::ProcessEvents, 0, &events);
+      effect->processDoubleReplacing(
+          effect, d.in_ptrs.data(), d.out_ptrs.data(), block_size);
+    }
+  }
+
+  dispatch(EffectOpcodes::MainsChanged, 0);
+  dispatch(EffectOpcodes::Close);
+
+  return report(name, "vintage", before);
+}
+
+template <template <typename...> class T>
+int drive_vintage(const char* name)
+{
+  return drive_vintage<typename decltype(avnd::configure<vintage::config, T>())::type>(
+      name);
+}
+
+#if defined(AVND_RT_CHECK_CLAP)
+template <typename T>
+int drive_clap(const char* name)
+{
+  using type = typename decltype(avnd::configure<avnd_clap::config, T>())::type;
+  const int before = avnd::rt_check::violations;
+
+  clap_host host{};
+  host.clap_version = CLAP_VERSION;
+  host.get_extension = [](const clap_host*, const char*) -> const void* { return nullptr; };
+  host.request_restart = [](const clap_host*) {};
+  host.request_process = [](const clap_host*) {};
+  host.request_callback = [](const clap_host*) {};
+
+  const clap_plugin* plugin = new avnd_clap::SimpleAudioEffect<type>{&host};
+  plugin->init(plugin);
+  plugin->activate(plugin, 48000., 1, block_size);
+  plugin->start_processing(plugin);
+
+  struct midi_events
+  {
+    clap_input_events list;
+    clap_event_midi events[2];
+  } in_events{};
+  for (int i = 0; i < 2; i++)
+  {
+    auto& ev = in_events.events[i];
+    ev.header.size = sizeof(clap_event_midi);
+    ev.header.time = i * block_size / 2;
+    ev.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+    ev.header.type = CLAP_EVENT_MIDI;
+    ev.data[0] = i == 0 ? 0x90 : 0x80;
+    ev.data[1] = 60;
+    ev.data[2] = i == 0 ? 100 : 0;
+  }
+  in_events.list.ctx = &in_events;
+  in_events.list.size = [](const clap_input_events*) -> uint32_t { return 2; };
+  in_events.list.get
+      = [](const clap_input_events* list, uint32_t i) -> const clap_event_header_t* {
+    return &static_cast<midi_events*>(list->ctx)->events[i].header;
+  };
+
+  clap_output_events out_events{};
+  out_events.try_push
+      = [](const clap_output_events*, const clap_event_header_t*) { return true; };
+
+  const int inputs = avnd::input_channels<type>(2);
+  const int outputs = avnd::output_channels<type>(2);
+  buffers<float> f{inputs, outputs};
+  buffers<double> d{inputs, outputs};
+  clap_audio_buffer in_bus{};
+  in_bus.data32 = f.in_ptrs.data();
+  in_bus.data64 = d.in_ptrs.data();
+  in_bus.channel_count = inputs;
+  clap_audio_buffer out_bus{};
+  out_bus.data32 = f.out_ptrs.data();
+  out_bus.data64 = d.out_ptrs.data();
+  out_bus.channel_count = outputs;
+
+  clap_process process{};
+  process.steady_time = -1;
+  process.frames_count = block_size;
+  process.audio_inputs = &in_bus;
+  process.audio_outputs = &out_bus;
+  process.audio_inputs_count = inputs > 0;
+  process.audio_outputs_count = outputs > 0;
+  process.in_events = &in_events.list;
+  process.out_events = &out_events;
+
+  for (int k = 0; k < blocks; k++)
+    plugin->process(plugin, &process);
+
+  plugin->stop_processing(plugin);
+  plugin->deactivate(plugin);
+  plugin->destroy(plugin);
+
+  return report(name, "clap", before);
+}
+
+template <template <typename...> class T>
+int drive_clap(const char* name)
+{
+  return drive_clap<typename decltype(avnd::configure<avnd_clap::config, T>())::type>(
+      name);
+}
+#endif
+}
@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "../check.hpp"
+#include "realtime_drivers.hpp"
+
+#include <examples/Helpers/Chain.hpp>
+#include <examples/Helpers/Lowpass.hpp>
+#include <examples/Helpers/Midi.hpp>
+#include <examples/Helpers/PerSample.hpp>
+#include <halp/realtime_log.hpp>
+
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Checks that the allocations and locks done in a realtime scope are caught,
+ * and that a few examples are realtime-safe with the example host and vintage.
+ */
+namespace rt = avnd::rt_check;
+
+// Collects what the realtime logger writes
+static std::vector<std::string> logged;
+struct test_sink
+{
+  template <typename... T>
+  static void log(fmt::format_string<T...> fmt, T&&... args)
+  {
+    logged.push_back(fmt::format(fmt, std::forward<T>(args)...));
+  }
+  template <typename... T>
+  static void trace(fmt::format_string<T...> fmt, T&&... args) { log(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void debug(fmt::format_string<T...> fmt, T&&... args) { log(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void info(fmt::format_string<T...> fmt, T&&... args) { log(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void warn(fmt::format_string<T...> fmt, T&&... args) { log(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void error(fmt::format_string<T...> fmt, T&&... args) { log(fmt, std::forward<T>(args)...); }
+  template <typename... T>
+  static void critical(fmt::format_string<T...> fmt, T&&... args) { log(fmt, std::forward<T>(args)...); }
+};
+
+static void allocate_and_lock()
+{
+  // volatile: allocations can be elided by the compiler otherwise
+  int* volatile p = new int{};
+  delete p;
+  void* volatile q = std::malloc(16);
+  std::free(q);
+  std::mutex m;
+  m.lock();
+  m.unlock();
+}
+
+int main()
+{
+  rt::on_violation = rt::action::count;
+
+  // Outside of a realtime scope
+  allocate_and_lock();
+  CHECK(rt::violations == 0);
+
+  // Inside one
+  {
+    avnd::realtime_scope realtime{"test"};
+    allocate_and_lock();
+  }
+#if defined(__GLIBC__)
+  // new, delete, malloc, free, pthread_mutex_lock
+  CHECK(rt::violations == 5);
+#else
+  CHECK(rt::violations >= 2);
+#endif
+
+  // Nested and unchecked scopes
+  {
+    avnd::realtime_scope outer{"outer"};
+    {
+      avnd::realtime_scope inner{"inner"};
+      CHECK(std::string_view{rt::current_scope} == "outer");
+    }
+    CHECK(rt::checking());
+    {
+      rt::unchecked_scope unchecked;
+      CHECK(!rt::checking());
+    }
+    CHECK(rt::checking());
+  }
+  CHECK(!rt::checking());
+
+  // The realtime logger, past the capacity of its queue and its rate limit
+  {
+    rt::violations = 0;
+    halp::realtime_logger<test_sink> logger;
+    {
+      avnd::realtime_scope realtime{"logger"};
+      logger.info("block {}: {}", 1, 0.5f);
+      for (int i = 0; i < 300; i++)
+        logger.error("{}", std::string_view{"message"});
+    }
+    CHECK(rt::violations == 0);
+
+    avnd::log_consumer::instance().flush();
+    const auto dropped = logger.dropped();
+    CHECK(dropped.rate_limited > 0);
+    CHECK(!logged.empty() && logged.front() == "block 1: 0.5");
+    CHECK(!logged.empty() && logged.back().starts_with("log messages dropped"));
+  }
+
+  // The bindings
+  rt::violations = 0;
+  rt::on_violation = rt::action::report;
+  using namespace avnd_rt_test;
+  CHECK(drive_example<examples::helpers::Lowpass>("Lowpass") == 0);
+  CHECK(drive_vintage<examples::helpers::Lowpass>("Lowpass") == 0);
+  CHECK(drive_example<examples::helpers::Midi>("Midi") == 0);
+  CHECK(drive_vintage<examples::helpers::Midi>("Midi") == 0);
+  CHECK(drive_example<examples::helpers::PerSampleAsArgs>("PerSampleAsArgs") == 0);
+  CHECK(drive_vintage<examples::helpers::PerSampleAsArgs>("PerSampleAsArgs") == 0);
+  CHECK(drive_example<examples::helpers::Chain>("Chain") == 0);
+  CHECK(drive_vintage<examples::helpers::Chain>("Chain") == 0);
+
+  return avnd_test::result();
+}
@@ -1,5 +1,18 @@
+#include <avnd/common/atomic_bitset.hpp>
+#include <avnd/common/constexpr_math.hpp>
+#include <avnd/common/denormals.hpp>
+#include <avnd/common/perfect_hash.hpp>
 #include <avnd/concepts/all.hpp>
+#include <avnd/wrappers/chain.hpp>
+#include <avnd/wrappers/controls.hpp>
+#include <avnd/wrappers/dsp_load.hpp>
 #include <avnd/wrappers/prepare.hpp>
+#include <avnd/wrappers/latency.hpp>
+#include <avnd/wrappers/parallel_channels.hpp>
+#include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
+#include <avnd/wrappers/symbol_table.hpp>
+#include <halp/mappings.hpp>
 
 
 template<typename T>
@@ -244,3 +257,414 @@ void prepare(setup info)
 };
 
 static_assert(avnd::can_prepare<has_prepare>);
+
+/// Effect container ///
+// Iterating over the instances must not go through a coroutine
+static_assert(avnd::multi_instance_range<decltype(std::declval<avnd::effect_container<test_per_sample_processor<float>>&>().effects())>);
+static_assert(avnd::multi_instance_range<decltype(std::declval<avnd::effect_container<test_per_sample_processor<float>>&>().full_state())>);
+static_assert(avnd::multi_instance_range<decltype(std::declval<avnd::effect_container<test_port_mono_audio_effect<float>>&>().outputs())>);
+static_assert(avnd::multi_instance_range<decltype(std::declval<avnd::effect_container<test_port_mono_audio_effect_value<float>>&>().inputs())>);
+#if !AVND_USE_COROUTINE_MEMBER_RANGE
+static_assert(std::is_trivially_copyable_v<decltype(std::declval<avnd::effect_container<test_port_mono_audio_effect<float>>&>().full_state())>);
+#endif
+
+/// Lane packing ///
+template<typename Sample>
+struct test_lane_generic_processor
+{
+  template<typename S>
+  using rebind_sample = test_lane_generic_processor<S>;
+
+  using inputs = test_per_sample_processor<float>::inputs;
+  struct outputs { };
+
+  Sample operator()(Sample in, const inputs&) { return in; }
+};
+
+static_assert(avnd::lane_packed_processor<test_lane_generic_processor<float>>);
+static_assert(!avnd::lane_packed_processor<test_per_sample_processor<float>>);
+static_assert(std::is_same_v<
+    avnd::effect_container<test_lane_generic_processor<float>>::packed_type,
+    test_lane_generic_processor<avnd::simd_lanes<float, avnd::simd_native_lanes<float>>>>);
+
+/// Sub-block splitting ///
+template<typename T>
+struct test_split_audio_effect
+{
+  enum { split_at_control_changes };
+  static constexpr int minimum_sub_block_frames = 64;
+  void operator()(T* in, T* out, int n);
+};
+
+static_assert(avnd::splits_at_control_changes<test_split_audio_effect<float>>);
+static_assert(!avnd::splits_at_control_changes<test_mono_audio_effect<float>>);
+static_assert(avnd::minimum_sub_block_frames<test_split_audio_effect<float>>() == 64);
+static_assert(avnd::minimum_sub_block_frames<test_mono_audio_effect<float>>() == 16);
+static_assert(std::is_same_v<
+    avnd::process_adapter_for<test_split_audio_effect<float>>,
+    avnd::sub_block_process_adapter<test_split_audio_effect<float>>>);
+static_assert(std::is_same_v<
+    avnd::process_adapter_for<test_mono_audio_effect<float>>,
+    avnd::process_adapter<test_mono_audio_effect<float>>>);
+static_assert(avnd::splits_at_parameter_changes<test_split_audio_effect<float>>);
+static_assert(!avnd::splits_at_parameter_changes<test_mono_audio_effect<float>>);
+static_assert(avnd::parameter_change_queue<test_split_audio_effect<float>>::enabled);
+static_assert(!avnd::parameter_change_queue<test_mono_audio_effect<float>>::enabled);
+static_assert(std::is_empty_v<avnd::parameter_change_queue<test_mono_audio_effect<float>>>);
+
+/// Fixed-size blocks ///
+template<typename T>
+struct test_fixed_block_audio_effect
+{
+  static constexpr int fixed_block_size = 256;
+  void operator()(T* in, T* out, int n);
+};
+
+static_assert(avnd::fixed_block_processor<test_fixed_block_audio_effect<float>>);
+static_assert(!avnd::fixed_block_processor<test_mono_audio_effect<float>>);
+static_assert(std::is_same_v<
+    avnd::process_adapter_for<test_fixed_block_audio_effect<float>>,
+    avnd::fixed_block_process_adapter<test_fixed_block_audio_effect<float>>>);
+
+/// Latency & tail ///
+struct test_static_latency { static constexpr int latency = 32; static constexpr int tail = -1; };
+struct test_runtime_latency { int latency = 16; };
+struct test_function_latency { int latency() const noexcept; int64_t tail() const noexcept; };
+
+static_assert(avnd::has_latency<test_static_latency>);
+static_assert(avnd::has_latency<test_runtime_latency>);
+static_assert(avnd::has_latency<test_function_latency>);
+static_assert(!avnd::has_latency<test_mono_audio_effect<float>>);
+static_assert(avnd::has_tail<test_static_latency>);
+static_assert(avnd::has_tail<test_function_latency>);
+static_assert(!avnd::has_tail<test_runtime_latency>);
+
+/// Silence ///
+template<typename T>
+struct test_silent_audio_effect
+{
+  enum { silence_in_silence_out };
+  void operator()(T* in, T* out, int n);
+};
+struct test_tail_audio_effect
+{
+  static constexpr int tail = 4800;
+  void operator()(float* in, float* out, int n);
+};
+
+static_assert(avnd::silence_in_silence_out<test_silent_audio_effect<float>>);
+static_assert(!avnd::silence_in_silence_out<test_mono_audio_effect<float>>);
+static_assert(avnd::skips_silence<test_silent_audio_effect<float>>);
+static_assert(avnd::skips_silence<test_tail_audio_effect>);
+static_assert(!avnd::skips_silence<test_mono_audio_effect<float>>);
+static_assert(std::is_same_v<
+    avnd::process_adapter_for<test_silent_audio_effect<float>>,
+    avnd::silence_process_adapter<
+        test_silent_audio_effect<float>,
+        avnd::process_adapter<test_silent_audio_effect<float>>>>);
+
+/// Denormals ///
+struct test_keeps_denormals { static constexpr bool flush_denormals = false; };
+
+static_assert(avnd::flushes_denormals<test_mono_audio_effect<float>>());
+static_assert(!avnd::flushes_denormals<test_keeps_denormals>());
+static_assert(std::is_same_v<
+    avnd::denormal_guard<test_mono_audio_effect<float>>, avnd::scoped_flush_denormals>);
+static_assert(std::is_same_v<
+    avnd::denormal_guard<test_keeps_denormals>, avnd::scoped_keep_denormals>);
+
+/// Oversampling ///
+template<int N>
+struct test_oversampled_audio_effect
+{
+  static constexpr int oversampling = N;
+  void operator()(float* in, float* out, int n);
+};
+
+static_assert(avnd::oversampled_processor<test_oversampled_audio_effect<2>>);
+static_assert(avnd::oversampled_processor<test_oversampled_audio_effect<8>>);
+// Declares a factor, which is not supported: oversampling_factor() does not compile
+static_assert(avnd::oversampled_processor<test_oversampled_audio_effect<3>>);
+static_assert(!avnd::supported_oversampling_factor(3));
+static_assert(!avnd::supported_oversampling_factor(16));
+static_assert(!avnd::oversampled_processor<test_mono_audio_effect<float>>);
+static_assert(avnd::oversampling_factor<test_oversampled_audio_effect<4>>() == 4);
+static_assert(avnd::oversampling_factor<test_mono_audio_effect<float>>() == 1);
+using test_oversampling_adapter = avnd::oversampling_process_adapter<
+    test_oversampled_audio_effect<4>,
+    avnd::process_adapter<test_oversampled_audio_effect<4>>>;
+static_assert(std::is_same_v<
+    avnd::process_adapter_for<test_oversampled_audio_effect<4>>,
+    test_oversampling_adapter>);
+static_assert(
+    (test_oversampling_adapter::filters_delay + test_oversampling_adapter::padding) % 4 == 0);
+
+/// Parallel channels ///
+struct test_parallel_audio_effect
+{
+  enum { parallel_channels };
+  static constexpr int parallel_workers = 3;
+  float operator()(float in);
+};
+
+static_assert(avnd::parallel_channels_processor<test_parallel_audio_effect>);
+static_assert(!avnd::parallel_channels_processor<test_mono_audio_effect<float>>);
+static_assert(avnd::parallel_workers<test_parallel_audio_effect>(64) == 3);
+static_assert(avnd::parallel_workers<test_parallel_audio_effect>(0) == 3);
+static_assert(avnd::parallel_workers<test_mono_audio_effect<float>>(0) == 0);
+static_assert(avnd::parallel_workers<test_mono_audio_effect<float>>(1) == 0);
+static_assert(std::is_base_of_v<
+    avnd::per_channel_executor<test_parallel_audio_effect>,
+    avnd::process_adapter_for<test_parallel_audio_effect>>);
+static_assert(std::is_base_of_v<
+    avnd::per_channel_executor<test_mono_audio_effect<float>>,
+    avnd::process_adapter_for<test_mono_audio_effect<float>>>);
+
+/// Chains ///
+struct test_chain_gain
+{
+  struct inputs { struct { float value; } gain; };
+  struct outputs { };
+  float operator()(float in, const inputs& ins);
+};
+struct test_chain_block
+{
+  struct inputs { struct { float value; } a; struct { int value; } b; };
+  static constexpr int latency = 8;
+  void operator()(float* in, float* out, const inputs& ins, int n);
+};
+
+using test_chain = avnd::chain<test_chain_gain, test_silent_audio_effect<float>, test_chain_block>;
+static_assert(avnd::monophonic_audio_processor<test_chain>);
+static_assert(avnd::mono_per_channel_arg_processor<float, test_chain>);
+static_assert(!avnd::mono_per_channel_arg_processor<double, test_chain>);
+static_assert(avnd::mono_per_channel_arg_processor<double, avnd::chain<test_chain_gain>>);
+static_assert(avnd::inputs_type<test_chain>::size == 3);
+static_assert(test_chain::input_offsets[2] == 1);
+static_assert(avnd::has_latency<test_chain>);
+static_assert(!avnd::has_tail<test_chain>);
+static_assert(!avnd::silence_in_silence_out<test_chain>);
+static_assert(avnd::silence_in_silence_out<avnd::chain<test_silent_audio_effect<double>>>);
+static_assert(avnd::mono_per_channel_arg_processor<double, avnd::chain<test_silent_audio_effect<double>>>);
+
+/// DSP load ///
+struct test_dsp_load_output
+{
+  enum { dsp_load };
+  float value;
+};
+struct test_dsp_load_audio_effect
+{
+  struct { } inputs;
+  struct
+  {
+    test_dsp_load_output load;
+  } outputs;
+  void operator()(float* in, float* out, int n);
+};
+struct test_dsp_load_binding
+{
+  avnd::dsp_load_tracker<test_dsp_load_audio_effect> dsp_load;
+};
+
+static_assert(avnd::dsp_load_parameter<test_dsp_load_output>);
+static_assert(avnd::dsp_load_output_introspection<test_dsp_load_audio_effect>::size == 1);
+static_assert(avnd::measures_dsp_load<test_dsp_load_audio_effect>());
+static_assert(avnd::has_dsp_load<test_dsp_load_binding>);
+#if !defined(AVND_DSP_LOAD)
+static_assert(!avnd::measures_dsp_load<test_mono_audio_effect<float>>());
+static_assert(std::is_empty_v<avnd::dsp_load_tracker<test_mono_audio_effect<float>>>);
+#endif
+static_assert(avnd::dsp_load_meter::bucket(7) == 7);
+static_assert(avnd::dsp_load_meter::bucket(8) == 8);
+static_assert(avnd::dsp_load_meter::bucket(16) == 16);
+static_assert(avnd::dsp_load_meter::bucket(1000) < avnd::dsp_load_meter::bucket(1200));
+static_assert(avnd::dsp_load_meter::bucket_end(avnd::dsp_load_meter::bucket(1000)) > 1000);
+static_assert(avnd::dsp_load_meter::bucket_end(avnd::dsp_load_meter::bucket(1000)) <= 1000 * 9 / 8 + 1);
+static_assert(
+    avnd::dsp_load_meter::bucket(uint64_t(1) << 50) == avnd::dsp_load_meter::bucket_count - 1);
+
+/// Smoothing ///
+struct test_smooth_input
+{
+  static constexpr avnd::smoothing smoothing{.milliseconds = 10.};
+  float value;
+  std::span<const float> ramp;
+};
+struct test_smooth_audio_effect
+{
+  struct
+  {
+    test_smooth_input gain;
+  } inputs;
+  struct { } outputs;
+  void operator()(float* in, float* out, int n);
+};
+
+static_assert(avnd::smooth_parameter<test_smooth_input>);
+static_assert(!avnd::smooth_parameter<test_dsp_load_output>);
+static_assert(avnd::smooth_parameter_input_introspection<test_smooth_audio_effect>::size == 1);
+static_assert(avnd::smooth_parameter_input_introspection<test_dsp_load_audio_effect>::size == 0);
+static_assert(std::is_same_v<
+              decltype(avnd::control_smoothing<test_smooth_audio_effect>::m_smoothers),
+              std::tuple<avnd::smoother<float>>>);
+static_assert(std::is_empty_v<avnd::control_smoothing<test_mono_audio_effect<float>>>);
+
+/// Mappings ///
+struct test_log_mapping
+{
+  static constexpr double map(double min, double max, double v)
+  {
+    return min * avnd::constexpr_math::pow(max / min, v);
+  }
+  static constexpr bool valid_range(double min, double max) { return min > 0.; }
+};
+struct test_mapped_input
+{
+  struct range
+  {
+    float min = 10.;
+    float max = 1000.;
+    float init = 100.;
+  };
+  using normalize = test_log_mapping;
+  float value;
+};
+struct test_linear_input
+{
+  struct range
+  {
+    float min = 10.;
+    float max = 1000.;
+    float init = 100.;
+  };
+  float value;
+};
+
+static_assert(avnd::mapped_parameter<test_mapped_input>);
+static_assert(!avnd::mapped_parameter<test_linear_input>);
+static_assert(avnd::constexpr_mapping<test_mapped_input>);
+static_assert(avnd::mapping_accepts_range<test_mapped_input>(10., 1000.));
+static_assert(!avnd::mapping_accepts_range<test_mapped_input>(0., 1000.));
+struct test_db_input
+{
+  struct range
+  {
+    float min = 0.;
+    float max = 2.;
+    float init = 1.;
+  };
+  using normalize = halp::db_mapping<>;
+  float value;
+};
+static_assert(avnd::mapping_accepts_range<test_db_input>(0., 2.));
+static_assert(!avnd::mapping_accepts_range<test_db_input>(-1., 1.));
+static_assert(!avnd::mapping_accepts_range<test_db_input>(-2., 0.));
+static_assert(avnd::map_control_from_01<test_mapped_input>(0.) == 10.f);
+static_assert(avnd::map_control_from_01<test_mapped_input>(1.) == 1000.f);
+static_assert(avnd::map_control_to_01<test_mapped_input>(1000.f) == 1.);
+// 100 is half-way between 10 and 1000 on a log scale
+static_assert(avnd::map_control_from_01<test_mapped_input>(0.5) > 99.99f);
+static_assert(avnd::map_control_from_01<test_mapped_input>(0.5) < 100.01f);
+static_assert(avnd::map_control_to_01<test_mapped_input>(100.f) > 0.4999);
+static_assert(avnd::map_control_to_01<test_mapped_input>(100.f) < 0.5001);
+static_assert(avnd::constexpr_math::log(avnd::constexpr_math::exp(2.5)) > 2.5 - 1e-12);
+static_assert(avnd::constexpr_math::log(avnd::constexpr_math::exp(2.5)) < 2.5 + 1e-12);
+
+/// Update hooks ///
+struct test_update_audio_effect;
+struct test_update_input
+{
+  float value;
+  void update(test_update_audio_effect& self);
+};
+struct test_update_audio_effect
+{
+  struct
+  {
+    test_update_input gain;
+  } inputs;
+  struct { } outputs;
+  void operator()(float* in, float* out, int n);
+};
+
+static_assert(avnd::parameter_with_update<test_update_input, test_update_audio_effect>);
+static_assert(!avnd::parameter_with_update<test_update_input, test_mono_audio_effect<float>>);
+static_assert(!avnd::parameter_with_update<test_smooth_input, test_update_audio_effect>);
+static_assert(avnd::atomic_bitset<64>::word_count == 1);
+static_assert(avnd::atomic_bitset<65>::word_count == 2);
+
+/// Index dispatch ///
+struct test_dispatch_float
+{
+  float value;
+};
+struct test_dispatch_int
+{
+  int value;
+};
+template <typename T>
+using test_is_dispatch_float = std::is_same<T, test_dispatch_float>;
+struct test_dispatch_inputs
+{
+  test_dispatch_float a;
+  test_dispatch_int b;
+  test_dispatch_float c;
+};
+using test_dispatch_floats
+    = avnd::predicate_introspection<test_dispatch_inputs, test_is_dispatch_float>;
+
+template <std::size_t N>
+constexpr int test_for_nth(int k)
+{
+  int res = -1;
+  avnd::for_nth<N>(k, [&]<std::size_t I>() { res = I; });
+  return res;
+}
+// Through the fold and through the table
+static_assert(test_for_nth<4>(3) == 3);
+static_assert(test_for_nth<4>(4) == -1);
+static_assert(test_for_nth<1000>(0) == 0);
+static_assert(test_for_nth<1000>(999) == 999);
+static_assert(test_for_nth<1000>(1000) == -1);
+static_assert(test_for_nth<1000>(-1) == -1);
+
+static_assert(test_dispatch_floats::field_index_map[0] == 0);
+static_assert(test_dispatch_floats::field_index_map[1] == -1);
+static_assert(test_dispatch_floats::field_index_map[2] == 1);
+static_assert(test_dispatch_floats::field_index_to_index(2) == 1);
+static_assert(test_dispatch_floats::field_index_to_index(3) == -1);
+
+/// Name lookup ///
+struct test_named_inputs
+{
+  struct
+  {
+    static consteval auto name() { return "gain"; }
+    float value;
+  } gain;
+  struct
+  {
+    static consteval auto name() { return "freq"; }
+    float value;
+  } freq;
+  struct
+  {
+    float value;
+  } unnamed;
+};
+constexpr auto test_named_index
+    = avnd::make_name_index(avnd::field_names<avnd::fields_introspection<test_named_inputs>>());
+static_assert(test_named_index.valid);
+static_assert(test_named_index.find("gain") == 0);
+static_assert(test_named_index.find("freq") == 1);
+static_assert(test_named_index.find("q") == -1);
+
+constexpr auto test_duplicate_index
+    = avnd::make_name_index(std::array<std::string_view, 3>{"a", "b", "a"});
+static_assert(test_duplicate_index.valid);
+static_assert(test_duplicate_index.find("a") == 0);
+static_assert(test_duplicate_index.find("b") == 1);
+
+static_assert(avnd::perfect_hash<0>{}.find(0) == -1);
+static_assert(avnd::perfect_hash<100>::table_size == 256);
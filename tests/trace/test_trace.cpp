@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "../check.hpp"
+
+#include <avnd/binding/example/example_processor.hpp>
+#include <avnd/common/trace.hpp>
+
+#include <examples/Helpers/Lowpass.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Runs a processor in the example host, from two threads, while tracing,
+ * and checks that the trace file has the expected spans.
+ */
+static int count(const std::string& str, const std::string& pattern)
+{
+  int n = 0;
+  for (auto pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1))
+    n++;
+  return n;
+}
+
+int main()
+{
+  using type = decltype(avnd::configure<exhs::config, examples::helpers::Lowpass>())::type;
+  static constexpr int block_size = 64;
+  static constexpr int blocks = 16;
+
+  const auto path = std::filesystem::temp_directory_path() / "avnd_test_trace.json";
+
+  {
+    avnd::trace::session session{path.string()};
+
+    auto run = [] {
+      auto processor = std::make_unique<exhs::example_processor<type>>(false);
+      processor->set_channels(1, 1);
+      processor->start(block_size, 48000.);
+
+      std::vector<float> in(block_size), out(block_size);
+      float* ins[1]{in.data()};
+      float* outs[1]{out.data()};
+      for (int i = 0; i < blocks; i++)
+      {
+        processor->apply_control(0, 0.1f * (i % 10));
+        processor->process(ins, 1, outs, 1, block_size);
+      }
+      processor->stop();
+    };
+
+    std::thread other{run};
+    run();
+    other.join();
+  }
+
+  std::ifstream file{path};
+  std::stringstream ss;
+  ss << file.rdbuf();
+  const std::string json = ss.str();
+
+  CHECK(json.starts_with("{\"traceEvents\":["));
+  CHECK(json.ends_with("],\"displayTimeUnit\":\"ns\"}\n"));
+  CHECK(count(json, "\"name\":\"prepare\"") == 2);
+  CHECK(count(json, "\"name\":\"process\"") == 2 * blocks);
+  CHECK(count(json, "\"name\":\"invoke\"") == 2 * blocks);
+  CHECK(count(json, "\"name\":\"control\"") == 2 * blocks);
+  CHECK(count(json, "\"processor\":\"Lowpass (helpers)\"") == 2 * (1 + 3 * blocks));
+
+  // One ring per thread
+  CHECK(count(json, "\"tid\":1,") == 1 + 3 * blocks);
+  CHECK(count(json, "\"tid\":2,") == 1 + 3 * blocks);
+
+  std::filesystem::remove(path);
+  if (avnd_test::failures > 0)
+    std::fprintf(stderr, "%s\n", json.c_str());
+  return avnd_test::result();
+}
@@ -0,0 +1,223 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "../check.hpp"
+
+#include <avnd/wrappers/controls_storage.hpp>
+#include <avnd/wrappers/effect_container.hpp>
+#include <avnd/wrappers/sub_block_process_adapter.hpp>
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/sample_accurate_controls.hpp>
+
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
+
+/**
+ * Timestamped parameter changes, as sent by the hosts with sample-accurate
+ * automation: stored in the sample-accurate inputs by control_storage::push_input,
+ * or used to split the blocks by parameter_change_queue.
+ */
+namespace
+{
+struct timed_value
+{
+  int frame;
+  float value;
+};
+
+struct timed_inputs
+{
+  struct
+  {
+    halp::dynamic_audio_bus<"In", float> audio;
+    struct : halp::hslider_f32<"Linear">
+    {
+      std::optional<float>* values{};
+    } linear;
+    struct : halp::hslider_f32<"Span">
+    {
+      std::span<timed_value> values;
+    } span;
+    halp::accurate<halp::hslider_f32<"Dynamic">> dynamic;
+    struct : halp::hslider_f32<"Map">
+    {
+      std::map<int, float> values;
+    } map;
+  } inputs;
+  struct
+  {
+    halp::dynamic_audio_bus<"Out", float> audio;
+  } outputs;
+
+  void operator()(int frames) { }
+};
+
+struct per_channel
+{
+  struct
+  {
+    struct : halp::hslider_f32<"Span">
+    {
+      std::span<timed_value> values;
+    } span;
+    halp::accurate<halp::hslider_f32<"Dynamic">> dynamic;
+  } inputs;
+  struct
+  {
+  } outputs;
+
+  float operator()(float in) { return in; }
+};
+
+struct splitting
+{
+  enum
+  {
+    split_at_control_changes
+  };
+  static constexpr int minimum_sub_block_frames = 4;
+  void operator()(float* in, float* out, int n) { }
+};
+
+constexpr int frames = 8;
+
+void test_single_instance()
+{
+  avnd::effect_container<timed_inputs> fx;
+  avnd::control_storage<timed_inputs> storage;
+  storage.reserve_space(fx, frames);
+
+  auto& in = fx.inputs();
+  storage.push_input(fx, avnd::field_index<1>{}, 2, 0.5f);
+  for (int i = 0; i < frames + 2; i++)
+    storage.push_input(fx, avnd::field_index<2>{}, i % frames, 0.1f * i);
+  storage.push_input(fx, avnd::field_index<3>{}, 3, 0.25f);
+  storage.push_input(fx, avnd::field_index<3>{}, 3, 0.75f);
+  storage.push_input(fx, avnd::field_index<4>{}, 1, 1.f);
+
+  for (int i = 0; i < frames; i++)
+    CHECK(bool(in.linear.values[i]) == (i == 2));
+  CHECK(in.linear.values[2] && *in.linear.values[2] == 0.5f);
+
+  // At most one value per frame of the block
+  CHECK(in.span.values.size() == frames);
+  for (int i = 0; i < int(in.span.values.size()); i++)
+    CHECK(in.span.values[i].frame == i);
+
+  // The latest value of a frame replaces the previous one
+  CHECK(in.dynamic.values.size() == 1);
+  CHECK(in.dynamic.values.begin()->second == 0.75f);
+
+  // A std::map cannot store without allocating
+  CHECK(in.map.values.empty());
+
+  storage.clear_inputs(fx);
+  for (int i = 0; i < frames; i++)
+    CHECK(!in.linear.values[i]);
+  CHECK(in.span.values.empty());
+  CHECK(in.dynamic.values.empty());
+}
+
+void test_per_channel()
+{
+  avnd::effect_container<per_channel> fx;
+  fx.init_channels(3, 3);
+  avnd::control_storage<per_channel> storage;
+  storage.reserve_space(fx, frames);
+
+  storage.push_input(fx, avnd::field_index<0>{}, 1, 0.5f);
+  storage.push_input(fx, avnd::field_index<0>{}, 5, 1.f);
+  storage.push_input(fx, avnd::field_index<1>{}, 4, 0.25f);
+
+  int instances = 0;
+  for (auto& in : avnd::get_inputs(fx))
+  {
+    CHECK(in.span.values.size() == 2);
+    if (in.span.values.size() == 2)
+    {
+      CHECK(in.span.values[0].frame == 1 && in.span.values[0].value == 0.5f);
+      CHECK(in.span.values[1].frame == 5 && in.span.values[1].value == 1.f);
+    }
+    CHECK(in.dynamic.values.size() == 1);
+    CHECK(in.dynamic.values.begin()->first == 4);
+    instances++;
+  }
+  CHECK(instances == 3);
+
+  storage.clear_inputs(fx);
+  for (auto& in : avnd::get_inputs(fx))
+  {
+    CHECK(in.span.values.empty());
+    CHECK(in.dynamic.values.empty());
+  }
+}
+
+void test_parameter_change_queue()
+{
+  static_assert(avnd::parameter_change_queue<splitting>::enabled);
+  avnd::parameter_change_queue<splitting> queue;
+  queue.reserve_space(4);
+
+  struct sub_block
+  {
+    int start, frames;
+  };
+  std::vector<sub_block> blocks;
+  std::vector<int> applied;
+  auto apply = [&](const auto& change) { applied.push_back(change.index); };
+  auto process = [&](int start, int n) { blocks.push_back({start, n}); };
+
+  // Too close to the start of the block: applied before the first sub-block
+  CHECK(queue.push(2, 0, 0.1));
+  CHECK(queue.push(10, 1, 0.5));
+  CHECK(queue.push(10, 2, 0.7));
+  CHECK(queue.push(30, 0, 0.9));
+  // Full: replaces the latest change of the same parameter
+  CHECK(queue.push(5, 0, 0.3));
+  CHECK(!queue.push(5, 7, 0.3));
+
+  queue.process(32, splitting::minimum_sub_block_frames, apply, process);
+  CHECK(blocks.size() == 3);
+  if (blocks.size() == 3)
+  {
+    CHECK(blocks[0].start == 0 && blocks[0].frames == 10);
+    CHECK(blocks[1].start == 10 && blocks[1].frames == 20);
+    CHECK(blocks[2].start == 30 && blocks[2].frames == 2);
+  }
+  CHECK((applied == std::vector<int>{0, 1, 2, 0}));
+  CHECK(queue.changes.empty());
+
+  // Without changes, a single block
+  blocks.clear();
+  applied.clear();
+  queue.process(8, splitting::minimum_sub_block_frames, apply, process);
+  CHECK(blocks.size() == 1 && blocks[0].start == 0 && blocks[0].frames == 8);
+  CHECK(applied.empty());
+
+  // Zero-frame process call without buses, as in a VST3 parameter flush:
+  // everything is applied in order, nothing is processed
+  blocks.clear();
+  std::vector<double> values;
+  CHECK(queue.push(0, 1, 0.2));
+  CHECK(queue.push(16, 2, 0.4));
+  CHECK(queue.push(8, 1, 0.6));
+  queue.flush([&](const auto& change) {
+    applied.push_back(change.index);
+    values.push_back(change.value);
+  });
+  CHECK(blocks.empty());
+  CHECK((applied == std::vector<int>{1, 1, 2}));
+  CHECK((values == std::vector<double>{0.2, 0.6, 0.4}));
+  CHECK(queue.changes.empty());
+}
+}
+
+int main()
+{
+  test_single_instance();
+  test_per_channel();
+  test_parameter_change_queue();
+  return avnd_test::result();
+}
@@ -0,0 +1,146 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "../check.hpp"
+
+#include <avnd/wrappers/effect_container.hpp>
+#include <avnd/wrappers/process_adapter.hpp>
+#include <avnd/wrappers/smoothing.hpp>
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/smooth.hpp>
+
+#include <algorithm>
+
+/**
+ * Ramps the smooth controls of a processor with a single instance,
+ * and of a mono processor duplicated per channel, whose instances
+ * must all see the same ramp, and whose value is stepped along the ramp
+ * at each frame as it works one frame at a time.
+ */
+namespace
+{
+using gain_control = halp::smooth<
+    halp::hslider_f32<"Gain", halp::range{.min = 0., .max = 1., .init = 0.}>, 8.>;
+
+struct single_instance
+{
+  struct
+  {
+    halp::dynamic_audio_bus<"In", float> audio;
+    gain_control gain;
+  } inputs;
+  struct
+  {
+    halp::dynamic_audio_bus<"Out", float> audio;
+  } outputs;
+
+  void operator()(int frames) { }
+};
+
+struct per_channel
+{
+  struct
+  {
+    gain_control gain;
+  } inputs;
+  struct
+  {
+  } outputs;
+
+  float operator()(float in) { return in * inputs.gain.value; }
+};
+
+// 8 milliseconds at 1kHz: the ramp goes from 0 to 1 over 8 frames
+constexpr double rate = 1000.;
+constexpr int frames = 8;
+
+void check_ramp(std::span<const float> ramp)
+{
+  CHECK(ramp.size() == frames);
+  if (ramp.size() != frames)
+    return;
+  CHECK(ramp.front() > 0.f && ramp.front() < 0.5f);
+  for (int i = 1; i < frames; i++)
+    CHECK(ramp[i] > ramp[i - 1]);
+  CHECK(ramp.back() > 0.99f);
+}
+}
+
+int main()
+{
+  {
+    avnd::effect_container<single_instance> fx;
+    avnd::control_smoothing<single_instance> smoothing;
+    smoothing.reserve_space(fx, frames, rate);
+
+    fx.inputs().gain.value = 1.f;
+    smoothing.process(fx, frames);
+    check_ramp(fx.inputs().gain.ramp);
+
+    // Sub-blocks see their own frames of the ramp
+    const auto full = fx.inputs().gain.ramp;
+    avnd::smooth_ramp_offsets<single_instance> offsets;
+    offsets.save(fx);
+    offsets.select(fx, 3, 4);
+    CHECK(fx.inputs().gain.ramp.data() == full.data() + 3);
+    CHECK(fx.inputs().gain.ramp.size() == 4);
+    offsets.select(fx, 6, 4);
+    CHECK(fx.inputs().gain.ramp.size() == 2);
+    offsets.restore(fx);
+    CHECK(fx.inputs().gain.ramp.data() == full.data());
+    CHECK(fx.inputs().gain.ramp.size() == frames);
+  }
+
+  {
+    avnd::effect_container<per_channel> fx;
+    fx.init_channels(4, 4);
+    avnd::control_smoothing<per_channel> smoothing;
+    smoothing.reserve_space(fx, frames, rate);
+
+    for (auto& inputs : avnd::get_inputs(fx))
+      inputs.gain.value = 1.f;
+    smoothing.process(fx, frames);
+
+    const float* first = nullptr;
+    int instances = 0;
+    for (auto& inputs : avnd::get_inputs(fx))
+    {
+      check_ramp(inputs.gain.ramp);
+      if (!first)
+        first = inputs.gain.ramp.data();
+      CHECK(inputs.gain.ramp.data() == first);
+      instances++;
+    }
+    CHECK(instances == 4);
+
+    // The per-sample adapter steps the value along the ramp at each frame,
+    // and gives back the target of the ramp afterwards
+    float ins[4][frames], outs[4][frames];
+    float* in_ptrs[4];
+    float* out_ptrs[4];
+    for (int c = 0; c < 4; c++)
+    {
+      std::fill_n(ins[c], frames, 1.f);
+      in_ptrs[c] = ins[c];
+      out_ptrs[c] = outs[c];
+    }
+    avnd::process_adapter<per_channel> adapter;
+    adapter.process(fx, avnd::span<float*>(in_ptrs, 4), avnd::span<float*>(out_ptrs, 4), frames);
+    for (int c = 0; c < 4; c++)
+      for (int i = 0; i < frames; i++)
+        CHECK(outs[c][i] == first[i]);
+    for (auto& inputs : avnd::get_inputs(fx))
+      CHECK(inputs.gain.value == 1.f);
+
+    // The ramp goes on from where it stopped
+    smoothing.process(fx, frames);
+    for (auto& inputs : avnd::get_inputs(fx))
+    {
+      CHECK(inputs.gain.ramp.size() == frames);
+      for (float v : inputs.gain.ramp)
+        CHECK(v == 1.f);
+    }
+  }
+
+  return avnd_test::result();
+}
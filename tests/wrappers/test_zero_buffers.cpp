@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "../check.hpp"
+
+#include <avnd/wrappers/process_adapter.hpp>
+#include <halp/audio.hpp>
+
+#include <vector>
+
+/**
+ * The read-only zeros given to the missing inputs are shared by all
+ * the process adapters, and grow to the largest setup seen,
+ * while each adapter has its own sink for the missing outputs,
+ * and its own zeros for the missing inputs which are not const.
+ */
+namespace
+{
+struct sidechain
+{
+  struct
+  {
+    halp::fixed_audio_bus<"In", float, 2> audio;
+    halp::fixed_audio_bus<"Sidechain", float, 2> side;
+  } inputs;
+  struct
+  {
+    halp::fixed_audio_bus<"Out", float, 2> audio;
+    halp::fixed_audio_bus<"Side out", float, 2> side;
+  } outputs;
+
+  // Writes to its inputs, which it is allowed to
+  float seen{-1.f};
+  void operator()(int frames)
+  {
+    seen = inputs.side[1][0];
+    for (int c = 0; c < 2; c++)
+      inputs.side[c][0] = 1.f;
+  }
+};
+
+struct read_only_sidechain
+{
+  struct
+  {
+    halp::fixed_audio_bus<"In", const float, 2> audio;
+    halp::fixed_audio_bus<"Sidechain", const float, 2> side;
+  } inputs;
+  struct
+  {
+    halp::fixed_audio_bus<"Out", float, 2> audio;
+  } outputs;
+
+  const float* side{};
+  void operator()(int frames) { side = inputs.side[0]; }
+};
+
+// The host only gives the main bus
+template <typename T>
+void process(avnd::process_adapter<T>& adapter, avnd::effect_container<T>& fx, int frames)
+{
+  std::vector<float> buffers(4 * frames);
+  float* in[2]{buffers.data(), buffers.data() + frames};
+  float* out[2]{buffers.data() + 2 * frames, buffers.data() + 3 * frames};
+  adapter.process(fx, avnd::span<float*>(in, 2), avnd::span<float*>(out, 2), frames);
+}
+}
+
+int main()
+{
+  const avnd::process_setup small{
+      .input_channels = 2, .output_channels = 2, .frames_per_buffer = 64, .rate = 48000.};
+  const avnd::process_setup large{
+      .input_channels = 4, .output_channels = 4, .frames_per_buffer = 512, .rate = 48000.};
+
+  avnd::process_adapter<sidechain> a, b;
+  a.allocate_buffers(small, float{});
+  b.allocate_buffers(small, float{});
+
+  CHECK(&a.zero_storage_for(float{}) == &b.zero_storage_for(float{}));
+  CHECK(a.zero_storage_for(float{}).zeros.data() == b.zero_storage_for(float{}).zeros.data());
+  CHECK(a.zero_storage_for(double{}).zeros.data() == b.zero_storage_for(double{}).zeros.data());
+  CHECK(a.sink_storage_for(float{}).sink.data() != b.sink_storage_for(float{}).sink.data());
+
+  // A larger setup gets larger zeros, which the next preparations share
+  avnd::process_adapter<sidechain> c;
+  c.allocate_buffers(large, float{});
+  CHECK(c.zero_storage_for(float{}).frames >= large.frames_per_buffer);
+  CHECK(c.zero_storage_for(float{}).zeros.data() != a.zero_storage_for(float{}).zeros.data());
+
+  a.allocate_buffers(small, float{});
+  CHECK(a.zero_storage_for(float{}).zeros.data() == c.zero_storage_for(float{}).zeros.data());
+
+  for (float v : a.zero_storage_for(float{}).zeros)
+    CHECK(v == 0.f);
+
+  // Inputs which can be written to get zeros of their own, cleared at each block
+  {
+    avnd::effect_container<sidechain> fx;
+    a.allocate_buffers(small, float{});
+    for (int i = 0; i < 2; i++)
+    {
+      process(a, fx, small.frames_per_buffer);
+      CHECK(fx.effect.seen == 0.f);
+      CHECK(a.writable_zero_storage_for(float{}).sink[0] == 1.f);
+    }
+    for (float v : a.zero_storage_for(float{}).zeros)
+      CHECK(v == 0.f);
+  }
+
+  // Read-only inputs get the shared zeros
+  {
+    avnd::effect_container<read_only_sidechain> fx;
+    avnd::process_adapter<read_only_sidechain> adapter;
+    adapter.allocate_buffers(small, float{});
+    process(adapter, fx, small.frames_per_buffer);
+    CHECK(fx.effect.side == adapter.zero_storage_for(float{}).zeros.data());
+  }
+
+  return avnd_test::result();
+}